@@ -42,6 +42,7 @@ rst_prolog = r"""
 .. |spectrum| replace:: :paramtype:`spectrum`
 .. |texture| replace:: :paramtype:`texture`
 .. |float| replace:: :paramtype:`float`
+.. |floats| replace:: :paramtype:`floats`
 .. |bool| replace:: :paramtype:`boolean`
 .. |int| replace:: :paramtype:`integer`
 .. |false| replace:: :monosp:`false`
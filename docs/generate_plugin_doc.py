@@ -16,6 +16,9 @@ SHAPE_ORDERING = ['obj',
                   'disk',
                   'rectangle',
                   'cube',
+                  'spherecloud',
+                  'cylindercloud',
+                  'leafcloud',
                   'shapegroup',
                   'instance']
 
@@ -64,7 +67,9 @@ SAMPLER_ORDERING = ['independent',
                     'stratified',
                     'multijitter',
                     'orthogonal',
-                    'ldsampler']
+                    'ldsampler',
+                    'halton',
+                    'hammersley']
 
 INTEGRATOR_ORDERING = ['direct',
                        'path',
@@ -3,6 +3,7 @@
 #include <mitsuba/mitsuba.h>
 #include <mitsuba/core/plugin.h>
 #include <mitsuba/core/spectrum.h>
+#include <algorithm>
 #include <memory>
 #include <string>
 #include <vector>
@@ -21,6 +22,64 @@ private:
     std::string m_value;
 };
 
+/**
+ * \brief Immutable array of double precision floating point values that can
+ * be stored in a \ref Properties instance
+ *
+ * The storage is reference counted and shared between copies, which makes it
+ * cheap to pass large arrays (e.g. tabulated spectra) through the plugin
+ * system. The values are either owned by the array or borrowed from an
+ * external buffer (e.g. a NumPy array or a memory-mapped file) that is kept
+ * alive by the \c owner handle.
+ *
+ * Values are kept in double precision so that the \c *_double variants see
+ * the full precision of the input; plugins convert them to \c ScalarFloat.
+ */
+class FloatArray {
+public:
+    using Float = double;
+
+    /// Create an empty array
+    FloatArray() = default;
+
+    /// Create an array that takes ownership of the given values
+    FloatArray(std::vector<Float> &&values) {
+        auto storage = std::make_shared<std::vector<Float>>(std::move(values));
+        m_data = storage->data();
+        m_size = storage->size();
+        m_owner = std::move(storage);
+    }
+
+    /// Create an array that references external memory kept alive by \c owner
+    FloatArray(const Float *data, size_t size, std::shared_ptr<const void> owner)
+        : m_data(data), m_size(size), m_owner(std::move(owner)) { }
+
+    /// Return a pointer to the first value
+    const Float *data() const { return m_data; }
+
+    /// Return the number of values
+    size_t size() const { return m_size; }
+
+    /// Is the array empty?
+    bool empty() const { return m_size == 0; }
+
+    const Float &operator[](size_t i) const { return m_data[i]; }
+    const Float *begin() const { return m_data; }
+    const Float *end() const { return m_data + m_size; }
+
+    bool operator==(const FloatArray &a) const {
+        return m_size == a.m_size &&
+               (m_data == a.m_data || std::equal(begin(), end(), a.begin()));
+    }
+
+    bool operator!=(const FloatArray &a) const { return !operator==(a); }
+
+private:
+    const Float *m_data = nullptr;
+    size_t m_size = 0;
+    std::shared_ptr<const void> m_owner;
+};
+
 /** \brief Associative parameter map for constructing
  * subclasses of \ref Object.
  *
@@ -48,6 +107,7 @@ public:
         Color,             ///< Tristimulus color value
         String,            ///< String
         NamedReference,    ///< Named reference to another named object
+        FloatArray,        ///< Array of floating point values
         Object,            ///< Arbitrary object
         Pointer            ///< const void* pointer (for internal communication between plugins)
     };
@@ -228,6 +288,20 @@ public:  // Type-specific getters and setters ----------------------------------
     /// Retrieve a 3D vector (use default value if no entry exists)
     Vector3f vector3f(const std::string &name, const Vector3f &def_val) const { return array3f(name, def_val); }
 
+    /// Store an array of floating point values in the Properties instance
+    void set_float_array(const std::string &name, const FloatArray &value, bool warn_duplicates = true);
+    /**
+     * \brief Retrieve an array of floating point values
+     *
+     * For convenience, this getter also accepts a comma or space-separated
+     * list of values stored as a string, a single floating point or integer
+     * value and a 3D array, which are converted to an array of the
+     * appropriate size.
+     */
+    FloatArray float_array(const std::string &name) const;
+    /// Retrieve an array of floating point values (use default value if no entry exists)
+    FloatArray float_array(const std::string &name, const FloatArray &def_val) const;
+
     /// Store a 4x4 homogeneous coordinate transformation in the Properties instance
     void set_transform(const std::string &name, const Transform4f &value, bool warn_duplicates = true);
     /// Retrieve a 4x4 homogeneous coordinate transformation
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <mitsuba/mitsuba.h>
+#include <mitsuba/core/properties.h>
 #include <string>
 #include <vector>
 
@@ -60,6 +61,43 @@ extern MTS_EXPORT_CORE ref<Object> create_texture_from_spectrum(
                                         bool within_emitter,
                                         bool is_spectral_mode,
                                         bool is_monochromatic_mode);
+
+/// Description of an object that still needs to be instantiated, see \ref instantiate_graph()
+struct PropertiesNode {
+    /// Unique identifier of the node
+    std::string id;
+    /// Base class of the object (e.g. \c BSDF, or \c Scene)
+    const Class *class_ = nullptr;
+    /// Parameters of the object. Nested objects are named references to other nodes
+    Properties props;
+    /// Human-readable location of the node used in error messages
+    std::string location;
+};
+
+/**
+ * \brief Instantiate a graph of objects described by \ref Properties records
+ *
+ * Nested objects are specified using named references (see \ref
+ * Properties::set_named_reference()) to the identifiers of other nodes. Nodes
+ * that are referenced multiple times are only instantiated once. Independent
+ * subtrees are instantiated in parallel, as done when loading XML scenes.
+ *
+ * \param nodes
+ *     List of nodes of the graph (consumed by this function)
+ *
+ * \param root
+ *     Identifier of the node to return
+ *
+ * \param source
+ *     Description of where the nodes come from (used in error messages)
+ *
+ * \param variant
+ *     Specifies the variant of plugins to instantiate (e.g. "scalar_rgb")
+ */
+extern MTS_EXPORT_CORE ref<Object> instantiate_graph(std::vector<PropertiesNode> &nodes,
+                                                     const std::string &root,
+                                                     const std::string &source,
+                                                     const std::string &variant);
 NAMESPACE_END(detail)
 
 NAMESPACE_END(xml)
@@ -81,6 +81,22 @@ static const char *__doc_get_shape_descr_idx =
 R"doc(Retrieve index of custom shape descriptor in the list above for a
 given shape)doc";
 
+static const char *__doc_mitsuba_AccumulatorIntegrator =
+R"doc(Base class of integrators that post-process the samples of a single
+nested integrator (e.g. bins, nbins or stokes)
+
+The nested integrator is invoked exactly once per sample, after which
+accumulate() turns its result into the AOVs of this stage. Stages can be
+nested into each other to form a pipeline that feeds a single radiance
+sample to several estimators, e.g. spectral binning followed by moment
+accumulation, without tracing additional paths.
+
+The AOV channels of a stage are stored contiguously: the channels
+written by accumulate() come first and are followed by those of the
+nested integrator.)doc";
+
+static const char *__doc_mitsuba_AccumulatorIntegrator_integrator = R"doc(Return the nested integrator)doc";
+
 static const char *__doc_mitsuba_AnimatedTransform =
 R"doc(Encapsulates an animated 4x4 homogeneous coordinate transformation
 
@@ -512,6 +528,18 @@ static const char *__doc_mitsuba_BSDF_m_flags = R"doc(Combined flags for all com
 
 static const char *__doc_mitsuba_BSDF_m_id = R"doc(Identifier (if available))doc";
 
+static const char *__doc_mitsuba_BSDF_mark_spatially_varying =
+R"doc(Add BSDFFlags::SpatiallyVarying to the flags of all components
+
+Implementations must call this function when they depend on the UV
+parameterization of the surface. The scene uses this flag to determine
+which fields of SurfaceInteraction must be computed at ray
+intersections.)doc";
+
+static const char *__doc_mitsuba_BSDF_mark_spatially_varying_2 =
+R"doc(Call mark_spatially_varying() if one of the given textures (which may
+be nullptr) is spatially varying)doc";
+
 static const char *__doc_mitsuba_BSDF_needs_differentials = R"doc(Does the implementation require access to texture-space differentials?)doc";
 
 static const char *__doc_mitsuba_BSDF_operator_delete = R"doc()doc";
@@ -3183,6 +3211,14 @@ static const char *__doc_mitsuba_Marginal2D_to_string = R"doc()doc";
 
 static const char *__doc_mitsuba_Medium = R"doc()doc";
 
+static const char *__doc_mitsuba_MediumInteraction_active_distance =
+R"doc(Distance travelled through the medium's active region between mint
+and ``t_end``, i.e. excluding the skipped empty interval.)doc";
+
+static const char *__doc_mitsuba_MediumInteraction_hole_maxt = R"doc()doc";
+
+static const char *__doc_mitsuba_MediumInteraction_hole_mint = R"doc(Empty interval of the medium skipped when sampling "t" (infinite if none))doc";
+
 static const char *__doc_mitsuba_Medium_2 = R"doc()doc";
 
 static const char *__doc_mitsuba_Medium_3 = R"doc()doc";
@@ -3252,14 +3288,36 @@ static const char *__doc_mitsuba_Medium_get_scattering_coefficients =
 R"doc(Returns the medium coefficients Sigma_s, Sigma_n and Sigma_t evaluated
 at a given MediumInteraction mi)doc";
 
+static const char *__doc_mitsuba_Medium_has_bounding_shell = R"doc(Returns whether this medium is bounded by a spherical shell)doc";
+
 static const char *__doc_mitsuba_Medium_has_spectral_extinction = R"doc(Returns whether this medium has a spectrally varying extinction)doc";
 
 static const char *__doc_mitsuba_Medium_id = R"doc(Return a string identifier)doc";
 
 static const char *__doc_mitsuba_Medium_intersect_aabb = R"doc(Intersets a ray with the medium's bounding box)doc";
 
+static const char *__doc_mitsuba_Medium_intersect_bounds =
+R"doc(Intersect a ray with the medium's active region
+
+The active region is the part of the medium's bounding box in which
+the extinction coefficient may be nonzero. Along a ray, it is
+described by a segment ``[mint, maxt]`` which may contain an empty
+interval ``[hole_mint, hole_maxt]`` that free-flight sampling skips
+over. An infinite ``hole_mint`` indicates that there is no such
+interval.
+
+The default implementation clips intersect_aabb() against the optional
+bounding spherical shell specified with the ``bounding_shell_center``,
+``bounding_shell_inner_radius`` and ``bounding_shell_outer_radius``
+parameters.
+
+Returns:
+    A tuple ``(valid, mint, maxt, hole_mint, hole_maxt)``.)doc";
+
 static const char *__doc_mitsuba_Medium_is_homogeneous = R"doc(Returns whether this medium is homogeneous)doc";
 
+static const char *__doc_mitsuba_Medium_m_has_bounding_shell = R"doc()doc";
+
 static const char *__doc_mitsuba_Medium_m_has_spectral_extinction = R"doc()doc";
 
 static const char *__doc_mitsuba_Medium_m_id = R"doc(Identifier (if available))doc";
@@ -3270,6 +3328,12 @@ static const char *__doc_mitsuba_Medium_m_phase_function = R"doc()doc";
 
 static const char *__doc_mitsuba_Medium_m_sample_emitters = R"doc()doc";
 
+static const char *__doc_mitsuba_Medium_m_shell_center = R"doc(Optional bounding spherical shell (center and inner/outer radii))doc";
+
+static const char *__doc_mitsuba_Medium_m_shell_inner_radius = R"doc()doc";
+
+static const char *__doc_mitsuba_Medium_m_shell_outer_radius = R"doc()doc";
+
 static const char *__doc_mitsuba_Medium_operator_delete = R"doc()doc";
 
 static const char *__doc_mitsuba_Medium_operator_delete_2 = R"doc()doc";
@@ -3799,12 +3863,30 @@ static const char *__doc_mitsuba_MonteCarloIntegrator_4 = R"doc()doc";
 
 static const char *__doc_mitsuba_MonteCarloIntegrator_MonteCarloIntegrator = R"doc(Create an integrator)doc";
 
+static const char *__doc_mitsuba_MonteCarloIntegrator_accumulate_aov =
+R"doc(Add value to entry index of a histogram that occupies size
+consecutive AOV channels starting at aovs
+
+Lanes with an out-of-range index are ignored. On the CPU, packet
+variants perform a single scatter-add into the AOV storage.)doc";
+
+static const char *__doc_mitsuba_MonteCarloIntegrator_accumulate_order =
+R"doc(Add a contribution to AOVs that decompose the radiance estimate by
+scattering order
+
+The AOVs consist of order_count groups of XYZ channels (see
+order_aov_names()), where group i holds light that scattered
+exactly i + 1 times. Contributions of order zero (directly visible
+emitters) or greater than order_count are ignored.)doc";
+
 static const char *__doc_mitsuba_MonteCarloIntegrator_class = R"doc()doc";
 
 static const char *__doc_mitsuba_MonteCarloIntegrator_m_max_depth = R"doc()doc";
 
 static const char *__doc_mitsuba_MonteCarloIntegrator_m_rr_depth = R"doc()doc";
 
+static const char *__doc_mitsuba_MonteCarloIntegrator_order_aov_names = R"doc(Return the channel names of the AOVs written by accumulate_order())doc";
+
 static const char *__doc_mitsuba_NamedReference = R"doc(Wrapper object used to represent named references to Object instances)doc";
 
 static const char *__doc_mitsuba_NamedReference_NamedReference = R"doc()doc";
@@ -4223,6 +4305,10 @@ static const char *__doc_mitsuba_PreliminaryIntersection_instance = R"doc(Stores
 
 static const char *__doc_mitsuba_PreliminaryIntersection_is_valid = R"doc(Is the current interaction valid?)doc";
 
+static const char *__doc_mitsuba_PreliminaryIntersection_offset =
+R"doc(Translation from the periodic cell to the copy of the scene that was
+hit (see Scene::is_periodic()), zero otherwise)doc";
+
 static const char *__doc_mitsuba_PreliminaryIntersection_operator_assign = R"doc()doc";
 
 static const char *__doc_mitsuba_PreliminaryIntersection_operator_assign_2 = R"doc()doc";
@@ -4468,6 +4554,16 @@ static const char *__doc_mitsuba_Properties_float = R"doc(Retrieve a floating po
 
 static const char *__doc_mitsuba_Properties_float_2 = R"doc(Retrieve a floating point value (use default value if no entry exists))doc";
 
+static const char *__doc_mitsuba_Properties_float_array =
+R"doc(Retrieve an array of floating point values
+
+For convenience, this getter also accepts a comma or space-separated
+list of values stored as a string, a single floating point or integer
+value and a 3D array, which are converted to an array of the
+appropriate size.)doc";
+
+static const char *__doc_mitsuba_Properties_float_array_2 = R"doc(Retrieve an array of floating point values (use default value if no entry exists))doc";
+
 static const char *__doc_mitsuba_Properties_has_property = R"doc(Verify if a value with the specified name exists)doc";
 
 static const char *__doc_mitsuba_Properties_id =
@@ -4548,6 +4644,8 @@ static const char *__doc_mitsuba_Properties_set_color = R"doc(Store a color in t
 
 static const char *__doc_mitsuba_Properties_set_float = R"doc(Store a floating point value in the Properties instance)doc";
 
+static const char *__doc_mitsuba_Properties_set_float_array = R"doc(Store an array of floating point values in the Properties instance)doc";
+
 static const char *__doc_mitsuba_Properties_set_id = R"doc(Set the unique identifier associated with this instance)doc";
 
 static const char *__doc_mitsuba_Properties_set_int = R"doc(Set an integer value in the Properties instance)doc";
@@ -4620,6 +4718,41 @@ bases including scrambled versions.
 This class is used to implement Halton and Hammersley sequences for
 QMC integration in Mitsuba.)doc";
 
+static const char *__doc_mitsuba_RadicalInverseSampler =
+R"doc(Interface for sampler plugins based on the scrambled radical inverse
+
+Subclasses map the index of a sample and a dimension to a point of a
+low-discrepancy sequence using radical_inverse(). Every sequence
+(i.e. pixel) then applies its own Cranley-Patterson rotation to each
+dimension.)doc";
+
+static const char *__doc_mitsuba_RadicalInverseSampler_RadicalInverseSampler = R"doc()doc";
+
+static const char *__doc_mitsuba_RadicalInverseSampler_RadicalInverseSampler_2 = R"doc(Copy the parameters of ``sampler``, sharing its permutation tables)doc";
+
+static const char *__doc_mitsuba_RadicalInverseSampler_class = R"doc()doc";
+
+static const char *__doc_mitsuba_RadicalInverseSampler_m_inverse = R"doc(Prime bases and digit permutation tables (shared between clones))doc";
+
+static const char *__doc_mitsuba_RadicalInverseSampler_m_scramble_seed = R"doc(Per-sequence scramble seed)doc";
+
+static const char *__doc_mitsuba_RadicalInverseSampler_next_1d = R"doc()doc";
+
+static const char *__doc_mitsuba_RadicalInverseSampler_next_2d = R"doc()doc";
+
+static const char *__doc_mitsuba_RadicalInverseSampler_radical_inverse =
+R"doc(Evaluate the scrambled radical inverse of ``index`` in the prime
+base with index ``base_index`` (modulo the number of bases)
+
+GPU variants do not support the digit permutations, which are stored
+in host memory, and fall back to the plain radical inverse.)doc";
+
+static const char *__doc_mitsuba_RadicalInverseSampler_sample =
+R"doc(Evaluate dimension ``dim`` of the samples ``index``, before the
+rotation)doc";
+
+static const char *__doc_mitsuba_RadicalInverseSampler_seed = R"doc()doc";
+
 static const char *__doc_mitsuba_RadicalInverse_PrimeBase = R"doc()doc";
 
 static const char *__doc_mitsuba_RadicalInverse_PrimeBase_divisor = R"doc()doc";
@@ -5056,6 +5189,15 @@ R"doc(For integrators that return one or more arbitrary output variables
 (AOVs), this function specifies a list of associated channel names.
 The default implementation simply returns an empty vector.)doc";
 
+static const char *__doc_mitsuba_SamplingIntegrator_aov_xyz =
+R"doc(Convert a partial radiance estimate into XYZ tristimulus values that can
+be written to the AOV channels of the film
+
+Unlike the main image, AOVs are not multiplied by the importance
+weight of the sensor. In spectral variants, this function therefore
+assumes that the sensor sampled wavelengths using
+sample_rgb_spectrum() and divides by the associated density.)doc";
+
 static const char *__doc_mitsuba_SamplingIntegrator_cancel = R"doc()doc";
 
 static const char *__doc_mitsuba_SamplingIntegrator_class = R"doc()doc";
@@ -5079,6 +5221,13 @@ R"doc(Maximum amount of time to spend rendering (excluding scene parsing).
 
 Specified in seconds. A negative values indicates no timeout.)doc";
 
+static const char *__doc_mitsuba_SamplingIntegrator_pass_completed =
+R"doc(Invoked after each of the first synchronized_passes() passes, while no
+render thread is running
+
+Parameter ``pass``:
+    Index of the completed pass)doc";
+
 static const char *__doc_mitsuba_SamplingIntegrator_render = R"doc(//! @{ \name Integrator interface implementation)doc";
 
 static const char *__doc_mitsuba_SamplingIntegrator_render_block = R"doc()doc";
@@ -5134,6 +5283,16 @@ enforced accurately.
 Note that accurate timeouts rely on m_render_timer, which needs to be
 reset at the beginning of the rendering phase.)doc";
 
+static const char *__doc_mitsuba_SamplingIntegrator_synchronized_passes =
+R"doc(Number of leading passes that are followed by a call to
+pass_completed()
+
+Integrators that learn from their own samples (e.g. for path guiding)
+return a positive value to render these passes one at a time: all
+render threads finish a pass and pass_completed() is invoked before
+the next pass starts. The remaining passes are rendered without
+interruption. The default implementation returns zero.)doc";
+
 static const char *__doc_mitsuba_Scene = R"doc()doc";
 
 static const char *__doc_mitsuba_Scene_2 = R"doc()doc";
@@ -5164,10 +5323,40 @@ static const char *__doc_mitsuba_Scene_emitters_2 = R"doc(Return the list of emi
 
 static const char *__doc_mitsuba_Scene_environment = R"doc(Return the environment emitter (if any))doc";
 
+static const char *__doc_mitsuba_Scene_hit_compute_flags =
+R"doc(Return the fields of SurfaceInteraction needed to shade any
+intersection with the scene geometry
+
+This is the union of Shape::hit_compute_flags() over all shapes.
+Integrators should pass it to ray_intersect() instead of
+HitComputeFlags::All, so that e.g. UV coordinates are not computed in
+scenes without textures.)doc";
+
 static const char *__doc_mitsuba_Scene_integrator = R"doc(Return the scene's integrator)doc";
 
 static const char *__doc_mitsuba_Scene_integrator_2 = R"doc(Return the scene's integrator)doc";
 
+static const char *__doc_mitsuba_Scene_is_periodic =
+R"doc(Return whether the scene has periodic lateral boundaries
+
+In this case, rays leaving the periodic cell (periodic_bbox()) through
+one of its lateral (X or Y) faces re-enter it through the opposite
+face, so that the scene content is repeated infinitely along these two
+axes. This is handled by ray_intersect(), ray_intersect_preliminary()
+and ray_test(). The returned interactions are expressed along the
+unwrapped ray: their position lies in the copy of the cell that was
+hit, consistently with their distance ``t``.
+
+Medium boundaries that lie on a lateral face of the cell are ignored,
+so that a medium filling the cell continues across the wrap (see the
+``periodic`` flag of the ``heterogeneous`` medium).
+
+Emitters are not replicated: emitter sampling only considers the
+emitters inside the cell. Shapes with an attached (area) emitter and
+point-like emitters should therefore not be used in periodic scenes,
+whose illumination should come from environment or directional
+emitters.)doc";
+
 static const char *__doc_mitsuba_Scene_m_accel = R"doc(Acceleration data structure (type depends on implementation))doc";
 
 static const char *__doc_mitsuba_Scene_m_bbox = R"doc()doc";
@@ -5178,8 +5367,16 @@ static const char *__doc_mitsuba_Scene_m_emitters = R"doc()doc";
 
 static const char *__doc_mitsuba_Scene_m_environment = R"doc()doc";
 
+static const char *__doc_mitsuba_Scene_m_hit_compute_flags = R"doc(Union of the interaction fields needed by the shapes of the scene)doc";
+
 static const char *__doc_mitsuba_Scene_m_integrator = R"doc()doc";
 
+static const char *__doc_mitsuba_Scene_m_periodic = R"doc(Periodic lateral boundary conditions)doc";
+
+static const char *__doc_mitsuba_Scene_m_periodic_bbox = R"doc()doc";
+
+static const char *__doc_mitsuba_Scene_m_periodic_max_wraps = R"doc(Maximum number of times that a ray is wrapped around the periodic cell)doc";
+
 static const char *__doc_mitsuba_Scene_m_sensors = R"doc()doc";
 
 static const char *__doc_mitsuba_Scene_m_shapes = R"doc()doc";
@@ -5201,6 +5398,24 @@ Parameter ``ds``:
 Returns:
     The solid angle density expressed of the sample)doc";
 
+static const char *__doc_mitsuba_Scene_periodic_advance = R"doc(Move a ray that reaches a lateral face at distance ``t`` to the opposite face)doc";
+
+static const char *__doc_mitsuba_Scene_periodic_bbox = R"doc(Return the cell of the periodic boundary conditions)doc";
+
+static const char *__doc_mitsuba_Scene_periodic_enter =
+R"doc(Bring a ray into the periodic cell
+
+The origin is wrapped laterally and advanced to the vertical extent of
+the cell if it lies above or below. Returns the distance that the ray
+was advanced by.)doc";
+
+static const char *__doc_mitsuba_Scene_periodic_exit =
+R"doc(Distance at which a ray inside the periodic cell reaches one of its
+lateral faces
+
+Returns infinity when the ray leaves the cell vertically first, after
+which it cannot intersect anything anymore.)doc";
+
 static const char *__doc_mitsuba_Scene_ray_intersect =
 R"doc(Intersect a ray against all primitives stored in the scene and return
 information about the resulting surface interaction
@@ -5229,12 +5444,21 @@ Remark:
 
 static const char *__doc_mitsuba_Scene_ray_intersect_naive_cpu = R"doc()doc";
 
+static const char *__doc_mitsuba_Scene_ray_intersect_periodic = R"doc(Trace a ray through the periodic cell, wrapping it around its lateral faces)doc";
+
 static const char *__doc_mitsuba_Scene_ray_intersect_preliminary = R"doc()doc";
 
 static const char *__doc_mitsuba_Scene_ray_intersect_preliminary_cpu = R"doc(Trace a ray and only return a preliminary intersection data structure)doc";
 
 static const char *__doc_mitsuba_Scene_ray_intersect_preliminary_gpu = R"doc()doc";
 
+static const char *__doc_mitsuba_Scene_ray_intersect_preliminary_periodic =
+R"doc(Find the preliminary intersection of a ray with a periodic scene
+
+The returned ``t`` is measured along the unwrapped ray, and the
+``offset`` field holds the translation of the copy of the cell that
+was hit.)doc";
+
 static const char *__doc_mitsuba_Scene_ray_test =
 R"doc(Intersect a ray against all primitives stored in the scene and *only*
 determine whether or not there is an intersection.
@@ -5255,6 +5479,8 @@ static const char *__doc_mitsuba_Scene_ray_test_cpu = R"doc(Trace a shadow ray)d
 
 static const char *__doc_mitsuba_Scene_ray_test_gpu = R"doc()doc";
 
+static const char *__doc_mitsuba_Scene_ray_test_periodic = R"doc(Trace a shadow ray through the periodic cell)doc";
+
 static const char *__doc_mitsuba_Scene_sample_emitter_direction =
 R"doc(Direct illumination sampling routine
 
@@ -5294,6 +5520,10 @@ static const char *__doc_mitsuba_Scene_to_string = R"doc(Return a human-readable
 
 static const char *__doc_mitsuba_Scene_traverse = R"doc(Perform a custom traversal over the scene graph)doc";
 
+static const char *__doc_mitsuba_Scene_update_hit_compute_flags =
+R"doc(Recompute m_hit_compute_flags from the current shapes, BSDFs and
+emitters)doc";
+
 static const char *__doc_mitsuba_ScopedPhase = R"doc()doc";
 
 static const char *__doc_mitsuba_ScopedPhase_ScopedPhase = R"doc()doc";
@@ -5334,12 +5564,59 @@ static const char *__doc_mitsuba_Sensor_Sensor = R"doc()doc";
 
 static const char *__doc_mitsuba_Sensor_class = R"doc()doc";
 
+static const char *__doc_mitsuba_Sensor_eval_direct =
+R"doc(Evaluate the part of the measurement that the sensor estimates
+deterministically for a sample of sample_ray_differential()
+
+Some sensors (e.g. irradiancemeter) split their measurement into a
+component that can be computed analytically given the sampled sensor
+position (e.g. the unoccluded contribution of delta emitters) and a
+Monte Carlo component that is estimated by tracing the sampled ray. The
+value returned by this function is added to the incident radiance
+estimate along the sampled ray *before* it is multiplied by the
+importance weight returned by sample_ray_differential().
+
+Integrators only need to invoke this function when
+has_direct_estimate() returns True. The default implementation
+returns zero.
+
+Parameter scene:
+   The scene used to perform visibility tests
+
+Parameter wavelengths:
+   The wavelengths associated with the ray generated by
+   sample_ray_differential()
+
+The remaining parameters must match those passed to
+sample_ray_differential().)doc";
+
 static const char *__doc_mitsuba_Sensor_film = R"doc(Return the Film instance associated with this sensor)doc";
 
 static const char *__doc_mitsuba_Sensor_film_2 = R"doc(Return the Film instance associated with this sensor (const))doc";
 
+static const char *__doc_mitsuba_Sensor_has_direct_estimate = R"doc(Does the sensor provide a deterministic contribution via eval_direct()?)doc";
+
+static const char *__doc_mitsuba_Sensor_has_direction_sampling =
+R"doc(Can particles traced from the emitters be splatted into the film of
+this sensor?
+
+Sensors that return ``True`` implement sample_direction() for particle
+tracing integrators: given a point in the scene, it samples a position
+on the sensor and returns the importance of the connection divided by
+its (solid angle) density. The film position of the connection is
+stored in the ``uv`` field of the returned direction sample, in pixel
+units relative to the crop window.)doc";
+
+static const char *__doc_mitsuba_Sensor_has_volume_tally = R"doc(Does the sensor tally power deposited in space via tally()?)doc";
+
 static const char *__doc_mitsuba_Sensor_m_film = R"doc()doc";
 
+static const char *__doc_mitsuba_Sensor_m_has_direct_estimate = R"doc()doc";
+
+static const char *__doc_mitsuba_Sensor_m_has_direction_sampling = R"doc()doc";
+
+static const char *__doc_mitsuba_Sensor_m_has_volume_tally = R"doc()doc";
+
 static const char *__doc_mitsuba_Sensor_m_resolution = R"doc()doc";
 
 static const char *__doc_mitsuba_Sensor_m_sampler = R"doc()doc";
@@ -5411,6 +5688,37 @@ static const char *__doc_mitsuba_Sensor_shutter_open = R"doc(Return the time val
 
 static const char *__doc_mitsuba_Sensor_shutter_open_time = R"doc(Return the length, for which the shutter remains open)doc";
 
+static const char *__doc_mitsuba_Sensor_tally =
+R"doc(Record the power deposited at a path vertex
+
+Sensors that tally power in space (e.g. ``voxeltally``) store it in the
+channels of their film, which are listed by tally_channels(). Particle
+tracing integrators call this function at every scattering event with
+the power that is absorbed and scattered there, and accumulate the
+result in a per-thread image block that is merged into the film at the
+end of the render.
+
+Integrators only need to invoke this function when has_volume_tally()
+returns ``True``. The default implementation raises an exception.
+
+Parameter ``block``:
+    An image block with the size and offset of the film's crop window
+    and one channel per entry of tally_channels()
+
+Parameter ``p``:
+    The position of the path vertex
+
+Parameter ``absorbed``:
+    The power absorbed at the vertex
+
+Parameter ``scattered``:
+    The power scattered at the vertex
+
+Parameter ``wavelengths``:
+    The wavelengths carried by the path)doc";
+
+static const char *__doc_mitsuba_Sensor_tally_channels = R"doc(Return the names of the film channels written by tally())doc";
+
 static const char *__doc_mitsuba_Sensor_traverse = R"doc(//! @})doc";
 
 static const char *__doc_mitsuba_Shape =
@@ -5420,6 +5728,8 @@ This class provides core functionality for sampling positions on
 surfaces, computing ray intersections, and bounding shapes within ray
 intersection acceleration data structures.)doc";
 
+static const char *__doc_mitsuba_ShapeGroup_m_hit_compute_flags = R"doc(Union of the interaction fields needed by the shapes of this group)doc";
+
 static const char *__doc_mitsuba_Shape_2 = R"doc()doc";
 
 static const char *__doc_mitsuba_Shape_3 = R"doc()doc";
@@ -5619,6 +5929,14 @@ static const char *__doc_mitsuba_Shape_exterior_medium = R"doc(Return the medium
 
 static const char *__doc_mitsuba_Shape_get_children_string = R"doc()doc";
 
+static const char *__doc_mitsuba_Shape_hit_compute_flags =
+R"doc(Return the fields of SurfaceInteraction that must be computed at
+intersections with this shape
+
+The position and shading frame are always needed. UV coordinates and
+position partials are only requested when the BSDF or emitter of the
+shape is spatially varying, or when the BSDF is anisotropic.)doc";
+
 static const char *__doc_mitsuba_Shape_id = R"doc(Return a string identifier)doc";
 
 static const char *__doc_mitsuba_Shape_interior_medium = R"doc(Return the medium that lies on the interior of this shape)doc";
@@ -7599,10 +7917,25 @@ static const char *__doc_mitsuba_Volume_eval_3 =
 R"doc(Evaluate this texture as a three-channel quantity with no color
 processing (e.g. normal map).)doc";
 
+static const char *__doc_mitsuba_Volume_eval_fields =
+R"doc(Evaluate all fields stored by the volume with a single lookup
+
+Volumes may hold several co-located quantities per voxel (e.g. the
+extinction coefficient and albedo of a medium). This function shares
+the index computation and memory accesses between them.
+
+Parameter ``fields``:
+    Output array with room for field_count() entries
+
+The default implementation stores the result of eval() as the only
+field.)doc";
+
 static const char *__doc_mitsuba_Volume_eval_gradient =
 R"doc(Evaluate the texture at the given surface interaction, and compute the
 gradients of the linear interpolant as well.)doc";
 
+static const char *__doc_mitsuba_Volume_field_count = R"doc(Returns the number of fields written by eval_fields())doc";
+
 static const char *__doc_mitsuba_Volume_is_inside = R"doc()doc";
 
 static const char *__doc_mitsuba_Volume_m_bbox = R"doc(Bounding box)doc";
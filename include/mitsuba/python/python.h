@@ -59,6 +59,8 @@ PYBIND11_DECLARE_HOLDER_TYPE(T, mitsuba::ref<T>, true);
         [](const std::string &name, std::function<py::object(const Properties *)> &constructor) {  \
             (void) new Class(name, #Name, ::mitsuba::detail::get_variant<Float, Spectrum>(),       \
                             [=](const Properties &p) {                                             \
+                                /* May run on a worker thread that does not hold the GIL */        \
+                                py::gil_scoped_acquire acquire;                                    \
                                 py::object o = constructor(&p);                                    \
                                 return o.release().cast<ref<Name>>();                              \
                             },                                                                     \
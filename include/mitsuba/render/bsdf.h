@@ -279,7 +279,7 @@ template <typename Float, typename Spectrum> struct BSDFSample3 {
 template <typename Float, typename Spectrum>
 class MTS_EXPORT_RENDER BSDF : public Object {
 public:
-    MTS_IMPORT_TYPES()
+    MTS_IMPORT_TYPES(Texture)
 
     /**
      * \brief Importance sample the BSDF model
@@ -449,6 +449,21 @@ protected:
     BSDF(const Properties &props);
     virtual ~BSDF();
 
+    /**
+     * \brief Add \ref BSDFFlags::SpatiallyVarying to the flags of all
+     * components
+     *
+     * Implementations must call this function when they depend on the UV
+     * parameterization of the surface. The scene uses this flag to determine
+     * which fields of \ref SurfaceInteraction must be computed at ray
+     * intersections.
+     */
+    void mark_spatially_varying();
+
+    /// Call \ref mark_spatially_varying() if one of the given textures (which
+    /// may be \c nullptr) is spatially varying
+    void mark_spatially_varying(std::initializer_list<const Texture *> textures);
+
 protected:
     /// Combined flags for all components of this BSDF.
     uint32_t m_flags;
@@ -125,6 +125,27 @@ public:
      */
     virtual std::vector<std::string> aov_names() const;
 
+    /**
+     * \brief Number of leading passes that are followed by a call to
+     * \ref pass_completed()
+     *
+     * Integrators that learn from their own samples (e.g. for path guiding)
+     * return a positive value to render these passes one at a time: all
+     * render threads finish a pass and \ref pass_completed() is invoked
+     * before the next pass starts. The remaining passes are rendered without
+     * interruption. The default implementation returns zero.
+     */
+    virtual size_t synchronized_passes() const;
+
+    /**
+     * \brief Invoked after each of the first \ref synchronized_passes()
+     * passes, while no render thread is running
+     *
+     * \param pass
+     *    Index of the completed pass
+     */
+    virtual void pass_completed(size_t pass);
+
     // =========================================================================
     //! @{ \name Integrator interface implementation
     // =========================================================================
@@ -170,6 +191,18 @@ protected:
                        ScalarFloat diff_scale_factor,
                        Mask active = true) const;
 
+    /**
+     * \brief Convert a partial radiance estimate into XYZ tristimulus values
+     * that can be written to the AOV channels of the film
+     *
+     * Unlike the main image, AOVs are not multiplied by the importance weight
+     * of the sensor. In spectral variants, this function therefore assumes
+     * that the sensor sampled \c wavelengths using \ref sample_rgb_spectrum()
+     * and divides by the associated density.
+     */
+    Color3f aov_xyz(const Spectrum &value, const Wavelength &wavelengths,
+                    Mask active = true) const;
+
 protected:
     /// Integrators should stop all work when this flag is set to true.
     bool m_stop;
@@ -199,6 +232,81 @@ protected:
     bool m_hide_emitters;
 };
 
+/**
+ * \brief Base class of integrators that post-process the samples of a single
+ * nested integrator (e.g. \c bins, \c nbins or \c stokes)
+ *
+ * The nested integrator is invoked exactly once per sample, after which \ref
+ * accumulate() turns its result into the AOVs of this stage. Stages can be
+ * nested into each other to form a pipeline that feeds a single radiance
+ * sample to several estimators, e.g. spectral binning followed by moment
+ * accumulation, without tracing additional paths.
+ *
+ * The AOV channels of a stage are stored contiguously: the channels written by
+ * \ref accumulate() come first and are followed by those of the nested
+ * integrator.
+ */
+template <typename Float, typename Spectrum>
+class MTS_EXPORT_RENDER AccumulatorIntegrator : public SamplingIntegrator<Float, Spectrum> {
+public:
+    MTS_IMPORT_BASE(SamplingIntegrator)
+    MTS_IMPORT_TYPES(Scene, Sampler, Medium)
+
+    std::pair<Spectrum, Mask> sample(const Scene *scene,
+                                     Sampler *sampler,
+                                     const RayDifferential3f &ray,
+                                     const Medium *medium = nullptr,
+                                     Float *aovs = nullptr,
+                                     Mask active = true) const override;
+
+    std::vector<std::string> aov_names() const override;
+
+    void traverse(TraversalCallback *callback) override;
+
+    /// Return the nested integrator
+    const Base *integrator() const { return m_integrator.get(); }
+
+    MTS_DECLARE_CLASS()
+protected:
+    /// Create a stage, the properties must hold exactly one nested integrator
+    AccumulatorIntegrator(const Properties &props);
+
+    /// Virtual destructor
+    virtual ~AccumulatorIntegrator();
+
+    /**
+     * \brief Compute the AOVs of this stage from a sample of the nested
+     * integrator
+     *
+     * \param value
+     *    Radiance estimate returned by the nested integrator
+     *
+     * \param wavelengths
+     *    Wavelengths associated with \c value
+     *
+     * \param nested_aovs
+     *    The <tt>m_nested_aov_count</tt> AOVs written by the nested integrator
+     *
+     * \param aovs
+     *    Storage for the <tt>m_accumulator_aov_names.size()</tt> AOVs of this
+     *    stage
+     */
+    virtual void accumulate(const Spectrum &value,
+                            const Wavelength &wavelengths,
+                            const Float *nested_aovs,
+                            Float *aovs,
+                            Mask active) const = 0;
+
+protected:
+    ref<Base> m_integrator;
+
+    /// Number of AOVs written by the nested integrator
+    size_t m_nested_aov_count;
+
+    /// Names of the AOVs written by \ref accumulate(), set by subclasses
+    std::vector<std::string> m_accumulator_aov_names;
+};
+
 /*
  * \brief Base class of all recursive Monte Carlo integrators, which compute
  * unbiased solutions to the rendering equation (and optionally the radiative
@@ -208,6 +316,7 @@ template <typename Float, typename Spectrum>
 class MTS_EXPORT_RENDER MonteCarloIntegrator : public SamplingIntegrator<Float, Spectrum> {
 public:
     MTS_IMPORT_BASE(SamplingIntegrator)
+    MTS_IMPORT_TYPES()
 
 protected:
     /// Create an integrator
@@ -216,6 +325,32 @@ protected:
     /// Virtual destructor
     virtual ~MonteCarloIntegrator();
 
+    /**
+     * \brief Add \c value to entry \c index of a histogram that occupies
+     * \c size consecutive AOV channels starting at \c aovs
+     *
+     * Lanes with an out-of-range index are ignored. On the CPU, packet
+     * variants perform a single scatter-add into the AOV storage.
+     */
+    void accumulate_aov(Float *aovs, size_t size, const UInt32 &index,
+                        const Float &value, Mask active = true) const;
+
+    /**
+     * \brief Add a contribution to AOVs that decompose the radiance estimate
+     * by scattering order
+     *
+     * The AOVs consist of \c order_count groups of XYZ channels (see \ref
+     * order_aov_names()), where group \c i holds light that scattered exactly
+     * <tt>i + 1</tt> times. Contributions of order zero (directly visible
+     * emitters) or greater than \c order_count are ignored.
+     */
+    void accumulate_order(Float *aovs, size_t order_count, const UInt32 &order,
+                          const Spectrum &value, const Wavelength &wavelengths,
+                          Mask active = true) const;
+
+    /// Return the channel names of the AOVs written by \ref accumulate_order()
+    std::vector<std::string> order_aov_names(size_t order_count) const;
+
     MTS_DECLARE_CLASS()
 protected:
     int m_max_depth;
@@ -224,5 +359,6 @@ protected:
 
 MTS_EXTERN_CLASS_RENDER(Integrator)
 MTS_EXTERN_CLASS_RENDER(SamplingIntegrator)
+MTS_EXTERN_CLASS_RENDER(AccumulatorIntegrator)
 MTS_EXTERN_CLASS_RENDER(MonteCarloIntegrator)
 NAMESPACE_END(mitsuba)
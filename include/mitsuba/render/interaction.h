@@ -400,6 +400,9 @@ struct MediumInteraction : Interaction<Float_, Spectrum_> {
     /// mint used when sampling the given distance "t".
     Float mint;
 
+    /// Empty interval of the medium skipped when sampling "t" (infinite if none)
+    Float hole_mint, hole_maxt;
+
     //! @}
     // =============================================================
 
@@ -418,13 +421,24 @@ struct MediumInteraction : Interaction<Float_, Spectrum_> {
         return sh_frame.to_local(v);
     }
 
+    /**
+     * \brief Distance travelled through the medium's active region between
+     * \ref mint and \c t_end, i.e. excluding the skipped empty interval.
+     */
+    Float active_distance(const Float &t_end) const {
+        Float dist = t_end - mint;
+        masked(dist, t_end > hole_mint) -= min(t_end, hole_maxt) - hole_mint;
+        return dist;
+    }
+
     //! @}
     // =============================================================
 
 
     ENOKI_DERIVED_STRUCT(MediumInteraction, Base,
         ENOKI_BASE_FIELDS(t, time, wavelengths, p),
-        ENOKI_DERIVED_FIELDS(medium, sh_frame, wi, sigma_s, sigma_n, sigma_t, combined_extinction, mint)
+        ENOKI_DERIVED_FIELDS(medium, sh_frame, wi, sigma_s, sigma_n, sigma_t,
+                             combined_extinction, mint, hole_mint, hole_maxt)
     )
 };
 
@@ -546,6 +560,12 @@ struct PreliminaryIntersection {
     /// Stores a pointer to the parent instance (if applicable)
     ShapePtr instance = nullptr;
 
+    /**
+     * \brief Translation from the periodic cell to the copy of the scene
+     * that was hit (see \ref Scene::is_periodic()), zero otherwise
+     */
+    Vector3f offset = zero<Vector3f>();
+
     //! @}
     // =============================================================
 
@@ -572,7 +592,18 @@ struct PreliminaryIntersection {
                                                      HitComputeFlags flags,
                                                      Mask active) {
         ShapePtr target = select(eq(instance, nullptr), shape, instance);
-        SurfaceInteraction3f si = target->compute_surface_interaction(ray, *this, flags, active);
+
+        // Hits on a periodic copy of the scene are computed within the cell
+        Mask has_offset = any(neq(offset, 0.f));
+        SurfaceInteraction3f si;
+        if (unlikely(any_or<true>(has_offset))) {
+            Ray3f ray_cell(ray);
+            ray_cell.o -= offset;
+            si = target->compute_surface_interaction(ray_cell, *this, flags, active);
+            si.p += offset;
+        } else {
+            si = target->compute_surface_interaction(ray, *this, flags, active);
+        }
         active &= si.is_valid();
         si.t = select(active, si.t, math::Infinity<Float>);
         si.prim_index  = prim_index;
@@ -584,8 +615,13 @@ struct PreliminaryIntersection {
         si.time        = ray.time;
         si.wavelengths = ray.wavelengths;
 
-        if (has_flag(flags, HitComputeFlags::ShadingFrame))
-            si.initialize_sh_frame();
+        if (has_flag(flags, HitComputeFlags::ShadingFrame)) {
+            // Without position partials, any frame around the normal will do
+            if (has_flag(flags, HitComputeFlags::dPdUV))
+                si.initialize_sh_frame();
+            else
+                si.sh_frame = Frame3f(si.sh_frame.n);
+        }
 
         // Incident direction in local coordinates
         si.wi = select(active, si.to_local(-ray.d), -ray.d);
@@ -598,7 +634,8 @@ struct PreliminaryIntersection {
     //! @}
     // =============================================================
 
-    ENOKI_STRUCT(PreliminaryIntersection, t, prim_uv, prim_index, shape_index, shape, instance);
+    ENOKI_STRUCT(PreliminaryIntersection, t, prim_uv, prim_index, shape_index, shape, instance,
+                 offset);
 };
 
 // -----------------------------------------------------------------------------
@@ -682,6 +719,7 @@ std::ostream &operator<<(std::ostream &os, const PreliminaryIntersection<Float,
         << "  shape_index = " << pi.shape_index << "," << std::endl
         << "  shape = " << string::indent(pi.shape, 6) << "," << std::endl
         << "  instance = " << string::indent(pi.instance, 6) << "," << std::endl
+        << "  offset = " << string::indent(pi.offset, 6) << "," << std::endl
         << "]";
     }
     return os;
@@ -702,7 +740,8 @@ ENOKI_STRUCT_SUPPORT(mitsuba::SurfaceInteraction, t, time, wavelengths, p,
 ENOKI_STRUCT_SUPPORT(mitsuba::MediumInteraction, t, time, wavelengths, p,
                      medium, sh_frame, wi, sigma_s, sigma_n, sigma_t, combined_extinction, mint)
 
-ENOKI_STRUCT_SUPPORT(mitsuba::PreliminaryIntersection, t, prim_uv, prim_index, shape_index, shape, instance)
+ENOKI_STRUCT_SUPPORT(mitsuba::PreliminaryIntersection, t, prim_uv, prim_index, shape_index, shape, instance,
+                     offset)
 
 //! @}
 // -----------------------------------------------------------------------
@@ -2041,6 +2041,14 @@ public:
     /// Build the kd-tree
     void build();
 
+    /**
+     * \brief Remove all shapes and release the tree nodes
+     *
+     * The build parameters are preserved, so that the tree can be rebuilt
+     * from a new set of shapes using \ref add_shape() and \ref build().
+     */
+    void clear();
+
     /// Return the number of registered shapes
     Size shape_count() const { return Size(m_shapes.size()); }
 
@@ -2372,7 +2380,7 @@ protected:
                 const Mesh *mesh = (const Mesh *) shape;
                 hit = mesh->ray_intersect_triangle(prim_index, ray, active).is_valid();
             } else {
-                hit = shape->ray_test(ray, active);
+                hit = shape->ray_test_primitive(prim_index, ray, active);
             }
 
             pi.t = select(hit, Float(0.f), math::Infinity<Float>);
@@ -2382,7 +2390,7 @@ protected:
                 const Mesh *mesh = (const Mesh *) shape;
                 pi = mesh->ray_intersect_triangle(prim_index, ray, active);
             } else {
-                pi = shape->ray_intersect_preliminary(ray, active);
+                pi = shape->ray_intersect_primitive(prim_index, ray, active);
             }
 
             return pi;
@@ -2392,6 +2400,7 @@ protected:
 protected:
     std::vector<ref<Shape>> m_shapes;
     std::vector<Size> m_primitive_map;
+    Size m_max_depth_param;
 };
 
 MTS_EXTERN_CLASS_RENDER(ShapeKDTree)
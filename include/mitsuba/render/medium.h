@@ -16,6 +16,25 @@ public:
     virtual std::tuple<Mask, Float, Float>
     intersect_aabb(const Ray3f &ray) const = 0;
 
+    /**
+     * \brief Intersect a ray with the medium's active region
+     *
+     * The active region is the part of the medium's bounding box in which the
+     * extinction coefficient may be nonzero. Along a ray, it is described by a
+     * segment <tt>[mint, maxt]</tt> which may contain an empty interval
+     * <tt>[hole_mint, hole_maxt]</tt> that free-flight sampling skips over.
+     * An infinite \c hole_mint indicates that there is no such interval.
+     *
+     * The default implementation clips \ref intersect_aabb() against the
+     * optional bounding spherical shell specified with the
+     * \c bounding_shell_center, \c bounding_shell_inner_radius and
+     * \c bounding_shell_outer_radius parameters.
+     *
+     * \return A tuple <tt>(valid, mint, maxt, hole_mint, hole_maxt)</tt>.
+     */
+    virtual std::tuple<Mask, Float, Float, Float, Float>
+    intersect_bounds(const Ray3f &ray) const;
+
     /// Returns the medium's majorant used for delta tracking
     virtual UnpolarizedSpectrum
     get_combined_extinction(const MediumInteraction3f &mi,
@@ -46,8 +65,8 @@ public:
      *                 The MediumInteraction will always be valid,
      *                 except if the ray missed the Medium's bounding box.
      */
-    MediumInteraction3f sample_interaction(const Ray3f &ray, Float sample,
-                                           UInt32 channel, Mask active) const;
+    virtual MediumInteraction3f sample_interaction(const Ray3f &ray, Float sample,
+                                                   UInt32 channel, Mask active) const;
 
     /**
      * \brief Compute the transmittance and PDF
@@ -64,7 +83,7 @@ public:
      * \return   This method returns a pair of (Transmittance, PDF).
      *
      */
-    std::pair<UnpolarizedSpectrum, UnpolarizedSpectrum>
+    virtual std::pair<UnpolarizedSpectrum, UnpolarizedSpectrum>
     eval_tr_and_pdf(const MediumInteraction3f &mi,
                     const SurfaceInteraction3f &si, Mask active) const;
 
@@ -84,6 +103,9 @@ public:
         return m_has_spectral_extinction;
     }
 
+    /// Returns whether this medium is bounded by a spherical shell
+    MTS_INLINE bool has_bounding_shell() const { return m_has_bounding_shell; }
+
     /// Return a string identifier
     std::string id() const override { return m_id; }
 
@@ -101,6 +123,11 @@ protected:
     ref<PhaseFunction> m_phase_function;
     bool m_sample_emitters, m_is_homogeneous, m_has_spectral_extinction;
 
+    /// Optional bounding spherical shell (center and inner/outer radii)
+    bool m_has_bounding_shell;
+    ScalarPoint3f m_shell_center;
+    ScalarFloat m_shell_inner_radius, m_shell_outer_radius;
+
     /// Identifier (if available)
     std::string m_id;
 };
@@ -120,6 +147,7 @@ ENOKI_CALL_SUPPORT_TEMPLATE_BEGIN(mitsuba::Medium)
     ENOKI_CALL_SUPPORT_METHOD(has_spectral_extinction)
     ENOKI_CALL_SUPPORT_METHOD(get_combined_extinction)
     ENOKI_CALL_SUPPORT_METHOD(intersect_aabb)
+    ENOKI_CALL_SUPPORT_METHOD(intersect_bounds)
     ENOKI_CALL_SUPPORT_METHOD(sample_interaction)
     ENOKI_CALL_SUPPORT_METHOD(eval_tr_and_pdf)
     ENOKI_CALL_SUPPORT_METHOD(get_scattering_coefficients)
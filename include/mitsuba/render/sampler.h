@@ -4,6 +4,7 @@
 #include <mitsuba/render/fwd.h>
 #include <mitsuba/core/logger.h>
 #include <mitsuba/core/object.h>
+#include <mitsuba/core/qmc.h>
 #include <mitsuba/core/vector.h>
 #include <mitsuba/core/random.h>
 
@@ -140,6 +141,52 @@ protected:
     PCG32 m_rng;
 };
 
+/**
+ * \brief Interface for sampler plugins based on the scrambled radical inverse
+ *
+ * Subclasses map the index of a sample and a dimension to a point of a
+ * low-discrepancy sequence using \ref radical_inverse(). Every sequence (i.e.
+ * pixel) then applies its own Cranley-Patterson rotation to each dimension.
+ */
+template <typename Float, typename Spectrum>
+class MTS_EXPORT_RENDER RadicalInverseSampler : public Sampler<Float, Spectrum> {
+public:
+    MTS_IMPORT_BASE(Sampler, m_sample_count, m_base_seed, m_samples_per_wavefront,
+                    m_dimension_index, seeded, current_sample_index,
+                    compute_per_sequence_seed)
+    MTS_IMPORT_TYPES()
+
+    virtual void seed(uint64_t seed_offset, size_t wavefront_size = 1) override;
+    virtual Float next_1d(Mask active = true) override;
+    virtual Point2f next_2d(Mask active = true) override;
+
+    MTS_DECLARE_CLASS()
+protected:
+    RadicalInverseSampler(const Properties &props);
+
+    /// Copy the parameters of \c sampler, sharing its permutation tables
+    RadicalInverseSampler(const RadicalInverseSampler &sampler);
+
+    /// Evaluate dimension \c dim of the samples \c index, before the rotation
+    virtual Float sample(const UInt32 &index, uint32_t dim) const = 0;
+
+    /**
+     * \brief Evaluate the scrambled radical inverse of \c index in the prime
+     * base with index \c base_index (modulo the number of bases)
+     *
+     * GPU variants do not support the digit permutations, which are stored
+     * in host memory, and fall back to the plain radical inverse.
+     */
+    Float radical_inverse(const UInt32 &index, uint32_t base_index) const;
+
+protected:
+    /// Prime bases and digit permutation tables (shared between clones)
+    ref<RadicalInverse> m_inverse;
+    /// Per-sequence scramble seed
+    UInt32 m_scramble_seed;
+};
+
 MTS_EXTERN_CLASS_RENDER(Sampler)
 MTS_EXTERN_CLASS_RENDER(PCG32Sampler)
+MTS_EXTERN_CLASS_RENDER(RadicalInverseSampler)
 NAMESPACE_END(mitsuba)
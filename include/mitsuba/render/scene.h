@@ -1,5 +1,6 @@
 #pragma once
 
+#include <mitsuba/core/properties.h>
 #include <mitsuba/core/spectrum.h>
 #include <mitsuba/render/emitter.h>
 #include <mitsuba/render/shapegroup.h>
@@ -137,6 +138,33 @@ public:
     /// Return a bounding box surrounding the scene
     const ScalarBoundingBox3f &bbox() const { return m_bbox; }
 
+    /**
+     * \brief Return whether the scene has periodic lateral boundaries
+     *
+     * In this case, rays leaving the periodic cell (\ref periodic_bbox())
+     * through one of its lateral (X or Y) faces re-enter it through the
+     * opposite face, so that the scene content is repeated infinitely along
+     * these two axes. This is handled by \ref ray_intersect(), \ref
+     * ray_intersect_preliminary() and \ref ray_test(). The returned
+     * interactions are expressed along the unwrapped ray: their position lies
+     * in the copy of the cell that was hit, consistently with their distance
+     * \c t.
+     *
+     * Medium boundaries that lie on a lateral face of the cell are ignored,
+     * so that a medium filling the cell continues across the wrap (see the
+     * \c periodic flag of the \c heterogeneous medium).
+     *
+     * Emitters are not replicated: emitter sampling only considers the
+     * emitters inside the cell. Shapes with an attached (area) emitter and
+     * point-like emitters should therefore not be used in periodic scenes,
+     * whose illumination should come from environment or directional
+     * emitters.
+     */
+    bool is_periodic() const { return m_periodic; }
+
+    /// Return the cell of the periodic boundary conditions
+    const ScalarBoundingBox3f &periodic_bbox() const { return m_periodic_bbox; }
+
     /// Return the list of sensors
     std::vector<ref<Sensor>> &sensors() { return m_sensors; }
     /// Return the list of sensors (const version)
@@ -155,6 +183,17 @@ public:
     /// Return the list of shapes
     const std::vector<ref<Shape>> &shapes() const { return m_shapes; }
 
+    /**
+     * \brief Return the fields of \ref SurfaceInteraction needed to shade
+     * any intersection with the scene geometry
+     *
+     * This is the union of \ref Shape::hit_compute_flags() over all shapes.
+     * Integrators should pass it to \ref ray_intersect() instead of \ref
+     * HitComputeFlags::All, so that e.g. UV coordinates are not computed in
+     * scenes without textures.
+     */
+    HitComputeFlags hit_compute_flags() const { return m_hit_compute_flags; }
+
     /// Return the scene's integrator
     Integrator* integrator() { return m_integrator; }
     /// Return the scene's integrator
@@ -185,12 +224,16 @@ protected:
     void accel_init_gpu(const Properties &props);
 
     /// Updates the ray-intersection acceleration data structure
+    void accel_parameters_changed_cpu(const std::vector<Shape *> &shapes);
     void accel_parameters_changed_gpu();
 
     /// Release the ray-intersection acceleration data structure
     void accel_release_cpu();
     void accel_release_gpu();
 
+    /// Recompute \ref m_hit_compute_flags from the current shapes, BSDFs and emitters
+    void update_hit_compute_flags();
+
     /// Trace a ray and only return a preliminary intersection data structure
     MTS_INLINE PreliminaryIntersection3f ray_intersect_preliminary_cpu(const Ray3f &ray, Mask active) const;
     MTS_INLINE PreliminaryIntersection3f ray_intersect_preliminary_gpu(const Ray3f &ray, Mask active) const;
@@ -204,12 +247,61 @@ protected:
     MTS_INLINE Mask ray_test_cpu(const Ray3f &ray, Mask active) const;
     MTS_INLINE Mask ray_test_gpu(const Ray3f &ray, Mask active) const;
 
+    /// Trace a ray through the periodic cell, wrapping it around its lateral faces
+    SurfaceInteraction3f ray_intersect_periodic(const Ray3f &ray, HitComputeFlags flags,
+                                                Mask active) const;
+
+    /**
+     * \brief Find the preliminary intersection of a ray with a periodic scene
+     *
+     * The returned \c t is measured along the unwrapped ray, and the \c
+     * offset field holds the translation of the copy of the cell that was hit.
+     */
+    PreliminaryIntersection3f ray_intersect_preliminary_periodic(const Ray3f &ray,
+                                                                 Mask active) const;
+
+    /// Trace a shadow ray through the periodic cell
+    Mask ray_test_periodic(const Ray3f &ray, Mask active) const;
+
+    /**
+     * \brief Bring a ray into the periodic cell
+     *
+     * The origin is wrapped laterally and advanced to the vertical extent of
+     * the cell if it lies above or below. Returns the distance that the ray
+     * was advanced by.
+     */
+    Float periodic_enter(Ray3f &ray, Mask active) const;
+
+    /**
+     * \brief Distance at which a ray inside the periodic cell reaches one
+     * of its lateral faces
+     *
+     * Returns infinity when the ray leaves the cell vertically first, after
+     * which it cannot intersect anything anymore.
+     */
+    Float periodic_exit(const Ray3f &ray) const;
+
+    /// Move a ray that reaches a lateral face at distance \c t to the opposite face
+    void periodic_advance(Ray3f &ray, const Float &t, Mask active) const;
+
     using ShapeKDTree = mitsuba::ShapeKDTree<Float, Spectrum>;
 
 protected:
     /// Acceleration data structure (type depends on implementation)
     void *m_accel = nullptr;
 
+    /**
+     * Secondary kd-tree holding the shapes updated by \ref parameters_changed(),
+     * so that only these need to be rebuilt (native CPU backend only)
+     */
+    void *m_accel_dynamic = nullptr;
+
+    /// Is the i-th shape stored in \ref m_accel_dynamic?
+    std::vector<bool> m_shapes_dynamic;
+
+    /// kd-tree construction parameters (\c kd_*) also used for \ref m_accel_dynamic
+    Properties m_accel_props;
+
     ScalarBoundingBox3f m_bbox;
 
     host_vector<ref<Emitter>, Float> m_emitters;
@@ -221,6 +313,15 @@ protected:
     ref<Emitter> m_environment;
 
     bool m_shapes_grad_enabled;
+
+    /// Union of the interaction fields needed by the shapes of the scene
+    HitComputeFlags m_hit_compute_flags;
+
+    /// Periodic lateral boundary conditions
+    bool m_periodic;
+    ScalarBoundingBox3f m_periodic_bbox;
+    /// Maximum number of times that a ray is wrapped around the periodic cell
+    uint32_t m_periodic_max_wraps;
 };
 
 /// Dummy function which can be called to ensure that the librender shared library is loaded
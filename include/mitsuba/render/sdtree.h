@@ -0,0 +1,379 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <memory>
+#include <vector>
+#include <mitsuba/core/atomic.h>
+#include <mitsuba/core/bbox.h>
+#include <mitsuba/core/logger.h>
+#include <mitsuba/core/vector.h>
+#include <mitsuba/core/warp.h>
+
+NAMESPACE_BEGIN(mitsuba)
+
+/**
+ * \brief Directional quadtree storing an estimate of the incident radiance at
+ * a region of space
+ *
+ * Directions are mapped to the unit square with the equal-area cylindrical
+ * mapping of \ref warp::square_to_uniform_sphere(), which is recursively
+ * subdivided into quadrants. The tree holds two distributions:
+ *
+ * - The \a sampling distribution, which is read-only during rendering and
+ *   drives \ref sample() and \ref pdf().
+ *
+ * - The \a recording distribution, into which \ref record() accumulates new
+ *   radiance estimates. Its topology is fixed during rendering and its sums
+ *   are updated with atomic operations, so that any number of threads can
+ *   record concurrently without locks.
+ *
+ * Calling \ref build() (while no thread is rendering) turns the recorded
+ * estimates into the new sampling distribution, and adapts the topology of
+ * the recording distribution to it.
+ *
+ * This is the directional component of the SD-tree described in the paper
+ * "Practical Path Guiding for Efficient Light-Transport Simulation" by Thomas
+ * Müller, Markus Gross and Jan Novák.
+ *
+ * The template parameter \c Float must be a scalar type.
+ */
+template <typename Float> class DirectionalTree {
+public:
+    using Point2f  = Point<Float, 2>;
+    using Vector3f = Vector<Float, 3>;
+
+    /// Quadtree node. Child indices of zero denote leaf quadrants.
+    struct Node {
+        std::array<Float, 4> sum { };
+        std::array<uint32_t, 4> children { };
+    };
+
+    /// Create a tree with a uniform sampling distribution
+    DirectionalTree() : m_nodes(1), m_record_nodes(1) { reset_recording(); }
+
+    /// Copy the distributions of another tree, including the recorded sums
+    DirectionalTree(const DirectionalTree &other)
+        : m_nodes(other.m_nodes), m_total(other.m_total),
+          m_record_nodes(other.m_record_nodes) {
+        reset_recording();
+        for (size_t i = 0; i < 4 * m_record_nodes.size(); ++i)
+            m_record_sums[i] = (Float) other.m_record_sums[i];
+        m_sample_count = other.sample_count();
+    }
+
+    /// Accumulate the estimate \c value of the incident radiance along \c d
+    void record(const Vector3f &d, Float value) {
+        if (!std::isfinite(value) || !(value > 0.f))
+            return;
+        Point2f p = warp::uniform_sphere_to_square(d);
+        uint32_t node = 0;
+        while (true) {
+            uint32_t q = quadrant(p);
+            uint32_t child = m_record_nodes[node].children[q];
+            if (child == 0) {
+                m_record_sums[4 * node + q] += value;
+                break;
+            }
+            node = child;
+        }
+    }
+
+    /// Count a path vertex that recorded into this tree
+    void add_sample() { m_sample_count.fetch_add(1, std::memory_order_relaxed); }
+
+    /// Return the number of path vertices recorded since the last \ref build()
+    size_t sample_count() const { return m_sample_count.load(std::memory_order_relaxed); }
+
+    /// Set the number of recorded path vertices (used when splitting regions)
+    void set_sample_count(size_t count) { m_sample_count = count; }
+
+    /// Does the tree hold a learned (non-uniform) sampling distribution?
+    bool is_trained() const { return m_total > 0.f; }
+
+    /**
+     * \brief Sample a direction from the sampling distribution
+     *
+     * \return The sampled direction and its density with respect to solid
+     *         angles
+     */
+    std::pair<Vector3f, Float> sample(Point2f u) const {
+        if (!is_trained())
+            return { warp::square_to_uniform_sphere(u), math::InvFourPi<Float> };
+
+        Point2f origin(0.f);
+        Float scale = 1.f, pdf = 1.f;
+        uint32_t node = 0;
+        while (true) {
+            const std::array<Float, 4> &s = m_nodes[node].sum;
+            Float total = s[0] + s[1] + s[2] + s[3];
+
+            // Choose the column, then the quadrant within the column
+            Float left = (s[0] + s[2]) / total;
+            uint32_t x = u.x() < left ? 0 : 1;
+            u.x() = x == 0 ? u.x() / left : (u.x() - left) / (1.f - left);
+
+            Float column = s[x] + s[x + 2];
+            Float bottom = column > 0.f ? s[x] / column : .5f;
+            uint32_t y = u.y() < bottom ? 0 : 1;
+            u.y() = y == 0 ? u.y() / bottom : (u.y() - bottom) / (1.f - bottom);
+
+            uint32_t q = x + 2 * y;
+            pdf *= 4.f * s[q] / total;
+            scale *= .5f;
+            origin += Point2f(Float(x), Float(y)) * scale;
+
+            uint32_t child = m_nodes[node].children[q];
+            if (child == 0)
+                break;
+            node = child;
+        }
+
+        u = min(max(u, 0.f), math::OneMinusEpsilon<Float>);
+        Vector3f d = warp::square_to_uniform_sphere(origin + u * scale);
+        return { d, pdf * math::InvFourPi<Float> };
+    }
+
+    /// Density of \ref sample() with respect to solid angles
+    Float pdf(const Vector3f &d) const {
+        if (!is_trained())
+            return math::InvFourPi<Float>;
+
+        Point2f p = warp::uniform_sphere_to_square(d);
+        Float pdf = math::InvFourPi<Float>;
+        uint32_t node = 0;
+        while (true) {
+            const std::array<Float, 4> &s = m_nodes[node].sum;
+            uint32_t q = quadrant(p);
+            Float total = s[0] + s[1] + s[2] + s[3];
+            pdf *= total > 0.f ? 4.f * s[q] / total : 0.f;
+            uint32_t child = m_nodes[node].children[q];
+            if (child == 0 || !(pdf > 0.f))
+                break;
+            node = child;
+        }
+        return pdf;
+    }
+
+    /**
+     * \brief Turn the recorded estimates into the sampling distribution
+     *
+     * Afterwards, the quadrants of the recording topology holding more than
+     * a fraction \c subdivision_threshold of the recorded energy are
+     * subdivided (up to a depth of \c max_depth), and the others are merged.
+     * The recorded sums and sample count are reset. Must not be called
+     * concurrently with \ref record().
+     */
+    void build(Float subdivision_threshold, uint32_t max_depth) {
+        // Copy the recorded sums, and propagate them towards the root
+        std::vector<Node> nodes(m_record_nodes.size());
+        for (size_t i = 0; i < nodes.size(); ++i) {
+            nodes[i].children = m_record_nodes[i].children;
+            for (uint32_t q = 0; q < 4; ++q)
+                nodes[i].sum[q] = m_record_sums[4 * i + q];
+        }
+        Float total = accumulate(nodes, 0);
+
+        /* Keep the previous distribution if nothing was recorded. Quadrants
+           without energy are never sampled, callers must therefore combine
+           the tree with another sampling technique. */
+        if (total > 0.f) {
+            m_total = total;
+            m_nodes = std::move(nodes);
+        }
+
+        // Adapt the recording topology to the new distribution
+        std::vector<Node> record_nodes(1);
+        if (m_total > 0.f)
+            refine(record_nodes, 0, 0, 1, subdivision_threshold * m_total, max_depth);
+        m_record_nodes = std::move(record_nodes);
+        reset_recording();
+        m_sample_count = 0;
+    }
+
+    /// Return the number of nodes of the sampling distribution
+    size_t node_count() const { return m_nodes.size(); }
+
+private:
+    static uint32_t quadrant(Point2f &p) {
+        uint32_t x = p.x() >= .5f ? 1 : 0,
+                 y = p.y() >= .5f ? 1 : 0;
+        p = p * 2.f - Point2f(Float(x), Float(y));
+        return x + 2 * y;
+    }
+
+    /// Replace the sums of interior quadrants by those of their subtrees
+    static Float accumulate(std::vector<Node> &nodes, uint32_t node) {
+        Float total = 0.f;
+        for (uint32_t q = 0; q < 4; ++q) {
+            uint32_t child = nodes[node].children[q];
+            if (child != 0)
+                nodes[node].sum[q] = accumulate(nodes, child);
+            total += nodes[node].sum[q];
+        }
+        return total;
+    }
+
+    /// Build the recording topology below \c target from sampling node \c source
+    void refine(std::vector<Node> &target, uint32_t target_node, uint32_t source,
+                uint32_t depth, Float threshold, uint32_t max_depth) const {
+        for (uint32_t q = 0; q < 4; ++q) {
+            Float energy = m_nodes[source].sum[q];
+            if (depth >= max_depth || !(energy > threshold))
+                continue;
+            uint32_t index = (uint32_t) target.size();
+            target.emplace_back();
+            target[target_node].children[q] = index;
+
+            /* Descend into the matching sampling node if it exists. Otherwise,
+               the energy is assumed to be spread uniformly over the quadrant */
+            uint32_t child = m_nodes[source].children[q];
+            if (child == 0)
+                refine_uniform(target, index, energy * .25f, depth + 1, threshold, max_depth);
+            else
+                refine(target, index, child, depth + 1, threshold, max_depth);
+        }
+    }
+
+    void refine_uniform(std::vector<Node> &target, uint32_t target_node, Float energy,
+                        uint32_t depth, Float threshold, uint32_t max_depth) const {
+        if (depth >= max_depth || !(energy > threshold))
+            return;
+        for (uint32_t q = 0; q < 4; ++q) {
+            uint32_t index = (uint32_t) target.size();
+            target.emplace_back();
+            target[target_node].children[q] = index;
+            refine_uniform(target, index, energy * .25f, depth + 1, threshold, max_depth);
+        }
+    }
+
+    void reset_recording() {
+        m_record_sums.reset(new AtomicFloat<Float>[4 * m_record_nodes.size()]);
+    }
+
+private:
+    /// Sampling distribution
+    std::vector<Node> m_nodes;
+    Float m_total = 0.f;
+
+    /// Recording topology (the sums of these nodes are unused)
+    std::vector<Node> m_record_nodes;
+    /// Recorded sums, four per node of \ref m_record_nodes
+    std::unique_ptr<AtomicFloat<Float>[]> m_record_sums;
+    std::atomic<size_t> m_sample_count { 0 };
+};
+
+/**
+ * \brief Spatio-directional tree (SD-tree) for path guiding
+ *
+ * A binary tree subdivides the (cubified) bounding box of the scene by
+ * alternately halving it along the X, Y and Z axes. Each leaf holds a
+ * \ref DirectionalTree that learns the incident radiance in its region.
+ *
+ * The spatial topology is only modified by \ref refine(), which must be
+ * called while no thread is rendering: lookups are thus lock-free, and
+ * recording only uses atomic operations.
+ *
+ * The template parameter \c Float must be a scalar type.
+ */
+template <typename Float> class SpatialDirectionalTree {
+public:
+    using Point3f         = Point<Float, 3>;
+    using Vector3f        = Vector<Float, 3>;
+    using BoundingBox3f   = BoundingBox<Point3f>;
+    using DirectionalTree = mitsuba::DirectionalTree<Float>;
+
+    /// Create a tree with a single region covering \c bbox
+    SpatialDirectionalTree(const BoundingBox3f &bbox) {
+        // Use a cube, so that the regions remain (roughly) isotropic
+        Float size = hmax(bbox.extents()) * (1.f + math::RayEpsilon<Float>);
+        if (!(size > 0.f))
+            size = 1.f;
+        m_origin = bbox.center() - Vector3f(.5f * size);
+        m_inv_size = 1.f / size;
+
+        m_nodes.emplace_back();
+        m_dtrees.emplace_back(new DirectionalTree());
+    }
+
+    /// Return the directional tree of the region containing \c p
+    DirectionalTree *lookup(const Point3f &p) const {
+        Point3f x = min(max((p - m_origin) * m_inv_size, 0.f), 1.f);
+        uint32_t node = 0;
+        for (uint32_t axis = 0;; axis = (axis + 1) % 3) {
+            const SpatialNode &n = m_nodes[node];
+            if (n.leaf)
+                return m_dtrees[n.dtree].get();
+            uint32_t side = x[axis] >= .5f ? 1 : 0;
+            x[axis] = x[axis] * 2.f - Float(side);
+            node = n.children[side];
+        }
+    }
+
+    /**
+     * \brief Update the guiding distributions from the recorded estimates
+     *
+     * First, regions in which more than \c spatial_threshold path vertices
+     * were recorded are split in two (recursively), and their directional
+     * trees, including the recorded estimates, are copied to both halves.
+     * Then, every directional tree is built from its recorded estimates (see
+     * \ref DirectionalTree::build()).
+     */
+    void refine(size_t spatial_threshold, Float subdivision_threshold,
+                uint32_t max_depth) {
+        size_t node_count = m_nodes.size();
+        for (size_t i = 0; i < node_count; ++i) {
+            if (m_nodes[i].leaf)
+                subdivide((uint32_t) i, spatial_threshold);
+        }
+        for (auto &dtree : m_dtrees)
+            dtree->build(subdivision_threshold, max_depth);
+    }
+
+    /// Return the number of regions (leaves) of the spatial tree
+    size_t region_count() const { return m_dtrees.size(); }
+
+private:
+    struct SpatialNode {
+        bool leaf = true;
+        uint32_t dtree = 0;
+        std::array<uint32_t, 2> children { };
+    };
+
+    void subdivide(uint32_t node, size_t spatial_threshold) {
+        // Limit the depth so that regions remain representable
+        static constexpr size_t MaxSpatialNodes = 1u << 24;
+
+        DirectionalTree *dtree = m_dtrees[m_nodes[node].dtree].get();
+        size_t count = dtree->sample_count();
+        if (count <= spatial_threshold || m_nodes.size() + 2 > MaxSpatialNodes)
+            return;
+
+        // The first child reuses the tree of the parent
+        uint32_t dtree_index = m_nodes[node].dtree;
+        std::unique_ptr<DirectionalTree> copy(new DirectionalTree(*dtree));
+        dtree->set_sample_count(count / 2);
+        copy->set_sample_count(count / 2);
+        m_dtrees.push_back(std::move(copy));
+
+        for (uint32_t side = 0; side < 2; ++side) {
+            SpatialNode child;
+            child.dtree = side == 0 ? dtree_index : (uint32_t) m_dtrees.size() - 1;
+            m_nodes[node].children[side] = (uint32_t) m_nodes.size();
+            m_nodes.push_back(child);
+        }
+        m_nodes[node].leaf = false;
+
+        subdivide(m_nodes[node].children[0], spatial_threshold);
+        subdivide(m_nodes[node].children[1], spatial_threshold);
+    }
+
+private:
+    Point3f m_origin;
+    Float m_inv_size;
+    std::vector<SpatialNode> m_nodes;
+    std::vector<std::unique_ptr<DirectionalTree>> m_dtrees;
+};
+
+NAMESPACE_END(mitsuba)
@@ -15,7 +15,7 @@ NAMESPACE_BEGIN(mitsuba)
 template <typename Float, typename Spectrum>
 class MTS_EXPORT_RENDER Sensor : public Endpoint<Float, Spectrum> {
 public:
-    MTS_IMPORT_TYPES(Film, Sampler)
+    MTS_IMPORT_TYPES(Film, Sampler, Scene, ImageBlock)
     MTS_IMPORT_BASE(Endpoint, sample_ray, m_needs_sample_3)
 
     // =============================================================
@@ -62,6 +62,83 @@ public:
                             const Point2f &sample2, const Point2f &sample3,
                             Mask active = true) const;
 
+    /**
+     * \brief Evaluate the part of the measurement that the sensor estimates
+     * deterministically for a sample of \ref sample_ray_differential()
+     *
+     * Some sensors (e.g. \c irradiancemeter) split their measurement into a
+     * component that can be computed analytically given the sampled sensor
+     * position (e.g. the unoccluded contribution of delta emitters) and a
+     * Monte Carlo component that is estimated by tracing the sampled ray. The
+     * value returned by this function is added to the incident radiance
+     * estimate along the sampled ray \a before it is multiplied by the
+     * importance weight returned by \ref sample_ray_differential().
+     *
+     * Integrators only need to invoke this function when
+     * \ref has_direct_estimate() returns \c true. The default implementation
+     * returns zero.
+     *
+     * \param scene
+     *    The scene used to perform visibility tests
+     *
+     * \param wavelengths
+     *    The wavelengths associated with the ray generated by
+     *    \ref sample_ray_differential()
+     *
+     * The remaining parameters must match those passed to
+     * \ref sample_ray_differential().
+     */
+    virtual Spectrum eval_direct(const Scene *scene, Float time,
+                                 const Wavelength &wavelengths,
+                                 const Point2f &sample2, const Point2f &sample3,
+                                 Mask active = true) const;
+
+    //! @}
+    // =============================================================
+
+    // =============================================================
+    //! @{ \name Volume tallies
+    // =============================================================
+
+    /**
+     * \brief Record the power deposited at a path vertex
+     *
+     * Sensors that tally power in space (e.g. \c voxeltally) store it in the
+     * channels of their film, which are listed by \ref tally_channels().
+     * Particle tracing integrators call this function at every scattering
+     * event with the power that is absorbed and scattered there, and
+     * accumulate the result in a per-thread image block that is merged into
+     * the film at the end of the render.
+     *
+     * Integrators only need to invoke this function when
+     * \ref has_volume_tally() returns \c true. The default implementation
+     * raises an exception.
+     *
+     * \param block
+     *    An image block with the size and offset of the film's crop window
+     *    and one channel per entry of \ref tally_channels()
+     *
+     * \param p
+     *    The position of the path vertex
+     *
+     * \param absorbed
+     *    The power absorbed at the vertex
+     *
+     * \param scattered
+     *    The power scattered at the vertex
+     *
+     * \param wavelengths
+     *    The wavelengths carried by the path
+     */
+    virtual void tally(ImageBlock *block, const Point3f &p,
+                       const UnpolarizedSpectrum &absorbed,
+                       const UnpolarizedSpectrum &scattered,
+                       const Wavelength &wavelengths,
+                       Mask active = true) const;
+
+    /// Return the names of the film channels written by \ref tally()
+    virtual std::vector<std::string> tally_channels() const;
+
     //! @}
     // =============================================================
 
@@ -78,6 +155,25 @@ public:
     /// Does the sampling technique require a sample for the aperture position?
     bool needs_aperture_sample() const { return m_needs_sample_3; }
 
+    /// Does the sensor provide a deterministic contribution via \ref eval_direct()?
+    bool has_direct_estimate() const { return m_has_direct_estimate; }
+
+    /**
+     * \brief Can particles traced from the emitters be splatted into the film
+     * of this sensor?
+     *
+     * Sensors that return \c true implement \ref sample_direction() for
+     * particle tracing integrators: given a point in the scene, it samples a
+     * position on the sensor and returns the importance of the connection
+     * divided by its (solid angle) density. The film position of the
+     * connection is stored in the \c uv field of the returned direction
+     * sample, in pixel units relative to the crop window.
+     */
+    bool has_direction_sampling() const { return m_has_direction_sampling; }
+
+    /// Does the sensor tally power deposited in space via \ref tally()?
+    bool has_volume_tally() const { return m_has_volume_tally; }
+
     /// Return the \ref Film instance associated with this sensor
     Film *film() { return m_film; }
 
@@ -132,6 +228,9 @@ protected:
     ScalarVector2f m_resolution;
     ScalarFloat m_shutter_open;
     ScalarFloat m_shutter_open_time;
+    bool m_has_direct_estimate = false;
+    bool m_has_direction_sampling = false;
+    bool m_has_volume_tally = false;
 };
 
 
@@ -155,6 +155,35 @@ public:
      */
     virtual Mask ray_test(const Ray3f &ray, Mask active = true) const;
 
+    /**
+     * \brief Fast ray intersection test against a single primitive
+     *
+     * Acceleration data structures call this method for shapes made of
+     * several primitives (see \ref primitive_count()) that are not meshes.
+     * The returned \c prim_index identifies the primitive for the subsequent
+     * call to \ref compute_surface_interaction(). The default implementation
+     * ignores \c prim_index and forwards the call to
+     * \ref ray_intersect_preliminary().
+     *
+     * \param prim_index
+     *     Index of the primitive to be tested, in <tt>[0, primitive_count())</tt>
+     *
+     * \param ray
+     *     The ray to be tested for an intersection
+     */
+    virtual PreliminaryIntersection3f ray_intersect_primitive(ScalarIndex prim_index,
+                                                              const Ray3f &ray,
+                                                              Mask active = true) const;
+
+    /**
+     * \brief Fast ray shadow test against a single primitive
+     *
+     * The default implementation ignores \c prim_index and forwards the call
+     * to \ref ray_test().
+     */
+    virtual Mask ray_test_primitive(ScalarIndex prim_index, const Ray3f &ray,
+                                    Mask active = true) const;
+
     /**
      * \brief Compute and return detailed information related to a surface interaction
      *
@@ -362,6 +391,16 @@ public:
     /// Return the area emitter associated with this shape (if any)
     Emitter *emitter(Mask /* unused */ = false) { return m_emitter.get(); }
 
+    /**
+     * \brief Return the fields of \ref SurfaceInteraction that must be
+     * computed at intersections with this shape
+     *
+     * The position and shading frame are always needed. UV coordinates and
+     * position partials are only requested when the BSDF or emitter of the
+     * shape is spatially varying, or when the BSDF is anisotropic.
+     */
+    virtual HitComputeFlags hit_compute_flags() const;
+
     /// Is this shape also an area sensor?
     bool is_sensor() const { return (bool) m_sensor; }
 
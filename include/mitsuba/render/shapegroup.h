@@ -42,8 +42,13 @@ public:
 
     ScalarFloat surface_area() const override { return 0.f; }
 
+    HitComputeFlags hit_compute_flags() const override { return m_hit_compute_flags; }
+
     MTS_INLINE ScalarSize effective_primitive_count() const override { return 0; }
 
+    /// Return the list of shapes contained in this group
+    const std::vector<ref<Base>> &shapes() const { return m_shapes; }
+
     std::string to_string() const override;
 
 #if defined(MTS_ENABLE_OPTIX)
@@ -68,9 +73,10 @@ public:
 private:
     ScalarBoundingBox3f m_bbox;
 
-#if defined(MTS_ENABLE_EMBREE) || defined(MTS_ENABLE_OPTIX)
+    /// Union of the interaction fields needed by the shapes of this group
+    HitComputeFlags m_hit_compute_flags;
+
     std::vector<ref<Base>> m_shapes;
-#endif
 
 #if defined(MTS_ENABLE_EMBREE)
     RTCScene m_embree_scene = nullptr;
@@ -231,6 +231,25 @@ public:
     virtual std::pair<UnpolarizedSpectrum, Vector3f> eval_gradient(const Interaction3f &it,
                                                                    Mask active = true) const;
 
+    /**
+     * \brief Evaluate all fields stored by the volume with a single lookup
+     *
+     * Volumes may hold several co-located quantities per voxel (e.g. the
+     * extinction coefficient and albedo of a medium). This function shares
+     * the index computation and memory accesses between them.
+     *
+     * \param fields
+     *     Output array with room for \ref field_count() entries
+     *
+     * The default implementation stores the result of \ref eval() as the
+     * only field.
+     */
+    virtual void eval_fields(const Interaction3f &it, UnpolarizedSpectrum *fields,
+                             Mask active = true) const;
+
+    /// Returns the number of fields written by \ref eval_fields()
+    virtual size_t field_count() const { return 1; }
+
     /// Returns the maximum value of the texture over all dimensions.
     virtual ScalarFloat max() const;
 
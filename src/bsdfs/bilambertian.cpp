@@ -41,7 +41,7 @@ light scattered into the outgoing hemisphere. This material is two-sided.
 template <typename Float, typename Spectrum>
 class BiLambertian final : public BSDF<Float, Spectrum> {
 public:
-    MTS_IMPORT_BASE(BSDF, m_flags, m_components)
+    MTS_IMPORT_BASE(BSDF, m_flags, m_components, mark_spatially_varying)
     MTS_IMPORT_TYPES(Texture)
 
     BiLambertian(const Properties &props) : Base(props) {
@@ -54,6 +54,7 @@ public:
                                BSDFFlags::FrontSide | BSDFFlags::BackSide);
 
         m_flags = m_components[0] | m_components[1];
+        mark_spatially_varying({ m_reflectance.get(), m_transmittance.get() });
     }
 
     std::pair<BSDFSample3f, Spectrum>
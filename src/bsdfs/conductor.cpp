@@ -194,7 +194,7 @@ the computation of Fresnel reflectances and produces an idealized
 template <typename Float, typename Spectrum>
 class SmoothConductor final : public BSDF<Float, Spectrum> {
 public:
-    MTS_IMPORT_BASE(BSDF, m_flags, m_components)
+    MTS_IMPORT_BASE(BSDF, m_flags, m_components, mark_spatially_varying)
     MTS_IMPORT_TYPES(Texture)
 
     SmoothConductor(const Properties &props) : Base(props) {
@@ -212,6 +212,8 @@ public:
         } else {
             std::tie(m_eta, m_k) = complex_ior_from_file<Spectrum, Texture>(props.string("material", "Cu"));
         }
+
+        mark_spatially_varying({ m_specular_reflectance.get(), m_eta.get(), m_k.get() });
     }
 
     std::pair<BSDFSample3f, Spectrum> sample(const BSDFContext &ctx,
@@ -168,7 +168,7 @@ parameter:
 template <typename Float, typename Spectrum>
 class SmoothDielectric final : public BSDF<Float, Spectrum> {
 public:
-    MTS_IMPORT_BASE(BSDF, m_flags, m_components)
+    MTS_IMPORT_BASE(BSDF, m_flags, m_components, mark_spatially_varying)
     MTS_IMPORT_TYPES(Texture)
 
     SmoothDielectric(const Properties &props) : Base(props) {
@@ -196,6 +196,8 @@ public:
                                BSDFFlags::BackSide | BSDFFlags::NonSymmetric);
 
         m_flags = m_components[0] | m_components[1];
+        mark_spatially_varying({ m_specular_reflectance.get(),
+                                 m_specular_transmittance.get() });
     }
 
     std::pair<BSDFSample3f, Spectrum> sample(const BSDFContext &ctx,
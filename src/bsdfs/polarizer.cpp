@@ -61,7 +61,7 @@ transmitting material that absorbs 50% of the incident illumination.
 template <typename Float, typename Spectrum>
 class LinearPolarizer final : public BSDF<Float, Spectrum> {
 public:
-    MTS_IMPORT_BASE(BSDF, m_flags, m_components)
+    MTS_IMPORT_BASE(BSDF, m_flags, m_components, mark_spatially_varying)
     MTS_IMPORT_TYPES(Texture)
 
     LinearPolarizer(const Properties &props) : Base(props) {
@@ -70,6 +70,7 @@ public:
 
         m_flags = BSDFFlags::FrontSide | BSDFFlags::BackSide | BSDFFlags::Null;
         m_components.push_back(m_flags);
+        mark_spatially_varying({ m_theta.get(), m_transmittance.get() });
     }
 
     std::pair<BSDFSample3f, Spectrum> sample(const BSDFContext &ctx, const SurfaceInteraction3f &si,
@@ -141,7 +141,7 @@ implementation of the underlying Fresnel equations.
 template <typename Float, typename Spectrum>
 class RoughConductor final : public BSDF<Float, Spectrum> {
 public:
-    MTS_IMPORT_BASE(BSDF, m_flags, m_components)
+    MTS_IMPORT_BASE(BSDF, m_flags, m_components, mark_spatially_varying)
     MTS_IMPORT_TYPES(Texture, MicrofacetDistribution)
 
     RoughConductor(const Properties &props) : Base(props) {
@@ -191,6 +191,8 @@ public:
 
         m_components.clear();
         m_components.push_back(m_flags);
+        mark_spatially_varying({ m_eta.get(), m_k.get(), m_alpha_u.get(),
+                                 m_alpha_v.get(), m_specular_reflectance.get() });
     }
 
     std::pair<BSDFSample3f, Spectrum> sample(const BSDFContext &ctx,
@@ -136,7 +136,7 @@ to significantly slower convergence.
 template <typename Float, typename Spectrum>
 class RoughDielectric final : public BSDF<Float, Spectrum> {
 public:
-    MTS_IMPORT_BASE(BSDF, m_flags, m_components)
+    MTS_IMPORT_BASE(BSDF, m_flags, m_components, mark_spatially_varying)
     MTS_IMPORT_TYPES(Texture, MicrofacetDistribution)
 
     RoughDielectric(const Properties &props) : Base(props) {
@@ -192,6 +192,9 @@ public:
         m_components.push_back(BSDFFlags::GlossyTransmission | BSDFFlags::FrontSide |
                                BSDFFlags::BackSide | BSDFFlags::NonSymmetric | extra);
         m_flags = m_components[0] | m_components[1];
+        mark_spatially_varying({ m_specular_reflectance.get(),
+                                 m_specular_transmittance.get(),
+                                 m_alpha_u.get(), m_alpha_v.get() });
 
         parameters_changed();
     }
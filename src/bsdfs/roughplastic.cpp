@@ -142,7 +142,7 @@ of this parameter given in the :ref:`plastic <bsdf-plastic>` plugin section.
 template <typename Float, typename Spectrum>
 class RoughPlastic final : public BSDF<Float, Spectrum> {
 public:
-    MTS_IMPORT_BASE(BSDF, m_flags, m_components)
+    MTS_IMPORT_BASE(BSDF, m_flags, m_components, mark_spatially_varying)
     MTS_IMPORT_TYPES(Texture, MicrofacetDistribution)
 
     RoughPlastic(const Properties &props) : Base(props) {
@@ -178,6 +178,8 @@ public:
         m_components.push_back(BSDFFlags::GlossyReflection | BSDFFlags::FrontSide);
         m_components.push_back(BSDFFlags::DiffuseReflection | BSDFFlags::FrontSide);
         m_flags =  m_components[0] | m_components[1];
+        mark_spatially_varying({ m_diffuse_reflectance.get(),
+                                 m_specular_reflectance.get() });
 
         parameters_changed();
     }
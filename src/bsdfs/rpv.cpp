@@ -72,7 +72,7 @@ parameters:
 MTS_VARIANT
 class RPV final : public BSDF<Float, Spectrum> {
 public:
-    MTS_IMPORT_BASE(BSDF, m_flags, m_components)
+    MTS_IMPORT_BASE(BSDF, m_flags, m_components, mark_spatially_varying)
     MTS_IMPORT_TYPES(Texture)
 
     RPV(const Properties &props) : Base(props) {
@@ -86,6 +86,7 @@ public:
         }
         m_flags = BSDFFlags::GlossyReflection | BSDFFlags::FrontSide;
         m_components.push_back(m_flags);
+        mark_spatially_varying({ m_rho_0.get(), m_g.get(), m_k.get(), m_rho_c.get() });
     }
 
     std::pair<BSDFSample3f, Spectrum> sample(const BSDFContext & /* ctx */,
@@ -72,7 +72,7 @@ which describe a borosilicate glass (BK7) ↔ air interface.
 template <typename Float, typename Spectrum>
 class ThinDielectric final : public BSDF<Float, Spectrum> {
 public:
-    MTS_IMPORT_BASE(BSDF, m_flags, m_components)
+    MTS_IMPORT_BASE(BSDF, m_flags, m_components, mark_spatially_varying)
     MTS_IMPORT_TYPES(Texture)
 
     ThinDielectric(const Properties &props) : Base(props) {
@@ -96,6 +96,8 @@ public:
                                BSDFFlags::BackSide);
         m_components.push_back(BSDFFlags::Null | BSDFFlags::FrontSide | BSDFFlags::BackSide);
         m_flags = m_components[0] | m_components[1];
+        mark_spatially_varying({ m_specular_reflectance.get(),
+                                 m_specular_transmittance.get() });
     }
 
     std::pair<BSDFSample3f, Spectrum> sample(const BSDFContext &ctx,
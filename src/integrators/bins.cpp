@@ -9,10 +9,10 @@ NAMESPACE_BEGIN(mitsuba)
 // TODO: fix and finish this
 // TODO: write docs
 template <typename Float, typename Spectrum>
-class BinsIntegrator final : public SamplingIntegrator<Float, Spectrum> {
+class BinsIntegrator final : public AccumulatorIntegrator<Float, Spectrum> {
 public:
-    MTS_IMPORT_BASE(SamplingIntegrator)
-    MTS_IMPORT_TYPES(Scene, Sampler, Medium, Texture)
+    MTS_IMPORT_BASE(AccumulatorIntegrator, m_integrator, m_accumulator_aov_names)
+    MTS_IMPORT_TYPES(Texture)
 
     BinsIntegrator(const Properties &props) : Base(props) {
         // If used in nonspectral mode, raise
@@ -23,19 +23,6 @@ public:
         if constexpr (is_polarized_v<Spectrum>)
             Throw("This integrator cannot (yet) be used in polarized mode!");
 
-        // Get sub-integrator
-        for (auto &kv : props.objects()) {
-            Base *integrator = dynamic_cast<Base *>(kv.second.get());
-            if (!integrator)
-                Throw("Child objects must be of type 'SamplingIntegrator'!");
-            if (m_integrator)
-                Throw("More than one sub-integrator specified!");
-            m_integrator = integrator;
-        }
-
-        if (!m_integrator)
-            Throw("Must specify a sub-integrator!");
-
         // Parse bin specification
         std::vector<std::string> tokens =
             string::tokenize(props.string("bins"), " ,");
@@ -82,43 +69,31 @@ public:
             props.set_float("value", 1.0);
             m_bin_weights.push_back(pmgr->create_object<Texture>(props));
         }
-    }
 
-    std::pair<Spectrum, Mask> sample(const Scene *scene, Sampler *sampler,
-                                     const RayDifferential3f &ray,
-                                     const Medium *medium, Float *aovs,
-                                     Mask active) const override {
-        MTS_MASKED_FUNCTION(ProfilerPhase::SamplingIntegratorSample, active);
-
-        auto result =
-            m_integrator->sample(scene, sampler, ray, medium, aovs, active);
+        for (auto &bin_name : m_bin_names) {
+            m_accumulator_aov_names.push_back(bin_name);
+            m_accumulator_aov_names.push_back(bin_name + "_weights");
+        }
+    }
 
+    void accumulate(const Spectrum &value, const Wavelength &wavelengths,
+                    const Float * /* nested_aovs */, Float *aovs,
+                    Mask active) const override {
         if constexpr (is_spectral_v<Spectrum>) {
             SurfaceInteraction3f si = zero<SurfaceInteraction3f>();
-            si.wavelengths          = ray.wavelengths;
+            si.wavelengths          = wavelengths;
 
             for (size_t i = 0; i < m_bin_names.size(); ++i) {
                 auto bin_weights = m_bin_weights[i]->eval(si, active);
-                *aovs++          = hsum(bin_weights * result.first);
+                *aovs++          = hsum(bin_weights * value);
                 *aovs++          = hsum(bin_weights);
             }
+        } else {
+            ENOKI_MARK_USED(value);
+            ENOKI_MARK_USED(wavelengths);
+            ENOKI_MARK_USED(aovs);
+            ENOKI_MARK_USED(active);
         }
-
-        // Forward result
-        return result;
-    }
-
-    std::vector<std::string> aov_names() const override {
-        std::vector<std::string> names;
-        for (auto &bin_name : m_bin_names) {
-            names.push_back(bin_name);
-            names.push_back(bin_name + "_weights");
-        }
-        return names;
-    }
-
-    void traverse(TraversalCallback *callback) override {
-        callback->put_object("integrator", m_integrator.get());
     }
 
     std::string to_string() const override {
@@ -138,10 +113,9 @@ private:
     std::vector<std::string> m_bin_names;
     std::vector<ScalarFloat> m_bin_lower_bounds;
     std::vector<ScalarFloat> m_bin_upper_bounds;
-    ref<Base> m_integrator;
     std::vector<ref<Texture>> m_bin_weights;
 };
 
-MTS_IMPLEMENT_CLASS_VARIANT(BinsIntegrator, SamplingIntegrator)
+MTS_IMPLEMENT_CLASS_VARIANT(BinsIntegrator, AccumulatorIntegrator)
 MTS_EXPORT_PLUGIN(BinsIntegrator, "Bins integrator");
 NAMESPACE_END(mitsuba)
@@ -22,12 +22,26 @@ Moment integrator (:monosp:`moment`)
 This integrator returns one AOVs recording the second moment of the samples of the nested
 integrator.
 
+Second moments are also computed for the AOVs of the nested integrators. Nesting
+a post-processing integrator such as :ref:`nbins <integrator-nbins>` or
+:ref:`stokes <integrator-stokes>` therefore yields the moments of its outputs
+from the same radiance samples, without tracing additional paths:
+
+.. code-block:: xml
+
+    <integrator type="moment">
+        <integrator type="nbins">
+            <string name="wavelengths" value="450, 550, 650"/>
+            <integrator type="path"/>
+        </integrator>
+    </integrator>
+
  */
 
 template <typename Float, typename Spectrum>
 class MomentIntegrator final : public SamplingIntegrator<Float, Spectrum> {
 public:
-    MTS_IMPORT_BASE(SamplingIntegrator)
+    MTS_IMPORT_BASE(SamplingIntegrator, aov_xyz)
     MTS_IMPORT_TYPES(Scene, Sampler, Medium)
 
     MomentIntegrator(const Properties &props) : Base(props) {
@@ -69,20 +83,7 @@ public:
                 m_integrators[i].first->sample(scene, sampler, ray, medium, aovs, active);
             aovs += m_integrators[i].second;
 
-            UnpolarizedSpectrum spec_u = depolarize(result_sub.first);
-
-            Color3f xyz;
-            if constexpr (is_monochromatic_v<Spectrum>) {
-                xyz = spec_u.x();
-            } else if constexpr (is_rgb_v<Spectrum>) {
-                xyz = srgb_to_xyz(spec_u, active);
-            } else {
-                static_assert(is_spectral_v<Spectrum>);
-                /// Note: this assumes that sensor used sample_rgb_spectrum() to generate 'ray.wavelengths'
-                auto pdf = pdf_rgb_spectrum(ray.wavelengths);
-                spec_u *= select(neq(pdf, 0.f), rcp(pdf), 0.f);
-                xyz = spectrum_to_xyz(spec_u, ray.wavelengths, active);
-            }
+            Color3f xyz = aov_xyz(result_sub.first, ray.wavelengths, active);
 
             *aovs++ = xyz.x(); *aovs++ = xyz.y(); *aovs++ = xyz.z();
 
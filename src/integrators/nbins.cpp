@@ -13,8 +13,8 @@ Narrow bins integrator (:monosp:`nbins`)
 .. pluginparameters::
 
  * - wavelengths
-   - |string|
-   - A comma-separated list of wavelengths used for bin detection.
+   - |floats|
+   - A list of wavelengths used for bin detection.
 
  * - tolerance
    - |float|
@@ -24,7 +24,7 @@ Narrow bins integrator (:monosp:`nbins`)
  * - (Nested plugin)
    - :paramtype:`integrator`
    - Sub-integrator (only one can be specified) which will be sampled along the
-     narrow bins integrator.
+     narrow bins integrator. Its AOVs are written after the bins.
 
 This integrator computes radiance for selected wavelengths in spectral mode.
 It is intended to be used when wavelengths are sampled from discrete spectral
@@ -47,10 +47,10 @@ step to normalize the obtained values.
 
  */
 template <typename Float, typename Spectrum>
-class NarrowBinsIntegrator final : public SamplingIntegrator<Float, Spectrum> {
+class NarrowBinsIntegrator final : public AccumulatorIntegrator<Float, Spectrum> {
 public:
-    MTS_IMPORT_BASE(SamplingIntegrator)
-    MTS_IMPORT_TYPES(Scene, Sampler, Medium, Texture)
+    MTS_IMPORT_BASE(AccumulatorIntegrator, m_integrator, m_accumulator_aov_names)
+    MTS_IMPORT_TYPES()
 
     NarrowBinsIntegrator(const Properties &props) : Base(props) {
         // If used in nonspectral mode, raise
@@ -61,30 +61,17 @@ public:
         if constexpr (is_polarized_v<Spectrum>)
             Throw("This integrator cannot (yet) be used in polarized mode!");
 
-        // Get sub-integrator
-        for (auto &kv : props.objects()) {
-            Base *integrator = dynamic_cast<Base *>(kv.second.get());
-            if (!integrator)
-                Throw("Child objects must be of type 'SamplingIntegrator'!");
-            if (m_integrator)
-                Throw("More than one sub-integrator specified!");
-            m_integrator = integrator;
-        }
-
-        if (!m_integrator)
-            Throw("Must specify a sub-integrator!");
-
-        // Parse wavelengths
-        std::vector<std::string> tokens =
-            string::tokenize(props.string("wavelengths"), " ,");
-
-        for (const std::string &token : tokens) {
-            try {
-                m_bin_wavelengths.push_back((ScalarFloat) std::stod(token));
-            } catch (...) {
-                Throw("Could not parse floating point value '%s'", token);
-            }
-            m_bin_names.push_back(token);
+        // Parse wavelengths. Bins are named after the wavelengths as
+        // written by the user when they are specified as a string.
+        std::vector<std::string> tokens;
+        if (props.type("wavelengths") == Properties::Type::String)
+            tokens = string::tokenize(props.string("wavelengths"), " ,");
+
+        FloatArray wavelengths = props.float_array("wavelengths");
+        for (size_t i = 0; i < wavelengths.size(); ++i) {
+            m_bin_wavelengths.push_back((ScalarFloat) wavelengths[i]);
+            m_bin_names.push_back(tokens.empty() ? tfm::format("%g", wavelengths[i])
+                                                 : tokens[i]);
         }
 
         if (m_bin_names.empty())
@@ -92,49 +79,36 @@ public:
 
         // Get tolerance value
         m_tolerance = props.float_("tolerance", 1e-5);
-    }
-
-    std::pair<Spectrum, Mask> sample(const Scene *scene, Sampler *sampler,
-                                     const RayDifferential3f &ray,
-                                     const Medium *medium, Float *aovs,
-                                     Mask active) const override {
-        MTS_MASKED_FUNCTION(ProfilerPhase::SamplingIntegratorSample, active);
 
-        auto result =
-            m_integrator->sample(scene, sampler, ray, medium, aovs, active);
+        for (auto &bin_name : m_bin_names) {
+            m_accumulator_aov_names.push_back(bin_name);
+            m_accumulator_aov_names.push_back(bin_name + "_pop");
+        }
+    }
 
+    void accumulate(const Spectrum &value, const Wavelength &wavelengths,
+                    const Float * /* nested_aovs */, Float *aovs,
+                    Mask /* active */) const override {
         if constexpr (is_spectral_v<Spectrum>) {
             // Compute bin values
             for (size_t i = 0; i < m_bin_names.size(); ++i) {
                 // Select wavelengths fitting current bin
                 auto bin_mask =
-                    abs(ray.wavelengths - m_bin_wavelengths[i]) <= m_tolerance;
+                    abs(wavelengths - m_bin_wavelengths[i]) <= m_tolerance;
 
                 // Gather radiance values
-                auto bin_values = select(bin_mask, result.first, 0.f);
+                auto bin_values = select(bin_mask, value, 0.f);
                 *aovs++         = hsum(bin_values);
 
                 // Compute bin population for post-processing
                 auto bin_population = select(bin_mask, Spectrum(1.f), 0.f);
                 *aovs++             = hsum(bin_population);
             }
+        } else {
+            ENOKI_MARK_USED(value);
+            ENOKI_MARK_USED(wavelengths);
+            ENOKI_MARK_USED(aovs);
         }
-
-        // Forward result
-        return result;
-    }
-
-    std::vector<std::string> aov_names() const override {
-        std::vector<std::string> names;
-        for (auto &bin_name : m_bin_names) {
-            names.push_back(bin_name);
-            names.push_back(bin_name + "_pop");
-        }
-        return names;
-    }
-
-    void traverse(TraversalCallback *callback) override {
-        callback->put_object("integrator", m_integrator.get());
     }
 
     std::string to_string() const override {
@@ -152,9 +126,8 @@ private:
     std::vector<std::string> m_bin_names;
     std::vector<ScalarFloat> m_bin_wavelengths;
     ScalarFloat m_tolerance;
-    ref<Base> m_integrator;
 };
 
-MTS_IMPLEMENT_CLASS_VARIANT(NarrowBinsIntegrator, SamplingIntegrator)
+MTS_IMPLEMENT_CLASS_VARIANT(NarrowBinsIntegrator, AccumulatorIntegrator)
 MTS_EXPORT_PLUGIN(NarrowBinsIntegrator, "Narrow bins integrator");
 NAMESPACE_END(mitsuba)
@@ -30,6 +30,15 @@ Path tracer (:monosp:`path`)
  * - hide_emitters
    - |bool|
    - Hide directly visible emitters. (Default: no, i.e. |false|)
+ * - delta_direct
+   - |bool|
+   - Evaluate the single-scattering contribution of delta emitters (e.g. a
+     :monosp:`directional` sun) deterministically and write it to a separate
+     AOV. (Default: |false|)
+ * - order_aovs
+   - |int|
+   - Number of scattering orders for which the contribution is written to
+     separate AOVs. (Default: 0)
 
 This integrator implements a basic path tracer and is a **good default choice**
 when there is no strong reason to prefer another method.
@@ -85,6 +94,25 @@ both direct and indirect illumination.
    are poorly tesselated, this latter option may cause them to lose a significant amount of the
    incident radiation (or, in other words, they will look dark).
 
+When :monosp:`delta_direct` is enabled, the illumination that delta emitters
+(:monosp:`directional`, :monosp:`point`, :monosp:`spot`, ...) deposit at the
+first intersection is not estimated by sampling one of the scene's emitters.
+Instead, every delta emitter is connected to the first intersection using a
+deterministic shadow ray. The result is added to the rendered image as usual
+and additionally written to the AOV channels
+:monosp:`delta_direct.X`, :monosp:`delta_direct.Y`, :monosp:`delta_direct.Z`,
+while light that scattered more than once is still estimated stochastically.
+For a typical remote sensing setup (a :monosp:`distant` sensor, a
+:monosp:`directional` sun and a sky emitter), this removes the variance that
+emitter selection adds to the dominant single-scattering term.
+
+Setting :monosp:`order_aovs` to :math:`K > 0` decomposes the rendered image by
+scattering order in a single pass: the AOV channels :monosp:`order_i.X`,
+:monosp:`order_i.Y`, :monosp:`order_i.Z` (:math:`1 \le i \le K`) hold the
+light that was scattered exactly :math:`i` times before reaching the sensor.
+Directly visible emitters and higher scattering orders only contribute to the
+rendered image.
+
 .. note:: This integrator does not handle participating media
 
  */
@@ -92,16 +120,20 @@ both direct and indirect illumination.
 template <typename Float, typename Spectrum>
 class PathIntegrator : public MonteCarloIntegrator<Float, Spectrum> {
 public:
-    MTS_IMPORT_BASE(MonteCarloIntegrator, m_max_depth, m_rr_depth)
+    MTS_IMPORT_BASE(MonteCarloIntegrator, m_max_depth, m_rr_depth, aov_xyz,
+                    accumulate_order, order_aov_names)
     MTS_IMPORT_TYPES(Scene, Sampler, Medium, Emitter, EmitterPtr, BSDF, BSDFPtr)
 
-    PathIntegrator(const Properties &props) : Base(props) { }
+    PathIntegrator(const Properties &props) : Base(props) {
+        m_delta_direct = props.bool_("delta_direct", false);
+        m_order_aovs = props.size_("order_aovs", 0);
+    }
 
     std::pair<Spectrum, Mask> sample(const Scene *scene,
                                      Sampler *sampler,
                                      const RayDifferential3f &ray_,
                                      const Medium * /* medium */,
-                                     Float * /* aovs */,
+                                     Float *aovs,
                                      Mask active) const override {
         MTS_MASKED_FUNCTION(ProfilerPhase::SamplingIntegratorSample, active);
 
@@ -113,11 +145,18 @@ public:
         // MIS weight for intersected emitters (set by prev. iteration)
         Float emission_weight(1.f);
 
-        Spectrum throughput(1.f), result(0.f);
+        Spectrum throughput(1.f), result(0.f), delta_direct(0.f);
+
+        Float *order_aovs = nullptr;
+        if (aovs && m_order_aovs > 0) {
+            order_aovs = aovs + (m_delta_direct ? 3 : 0);
+            for (size_t i = 0; i < 3 * m_order_aovs; ++i)
+                order_aovs[i] = 0.f;
+        }
 
         // ---------------------- First intersection ----------------------
 
-        SurfaceInteraction3f si = scene->ray_intersect(ray, active);
+        SurfaceInteraction3f si = scene->ray_intersect(ray, scene->hit_compute_flags(), active);
         Mask valid_ray = si.is_valid();
         EmitterPtr emitter = si.emitter(scene);
 
@@ -125,8 +164,12 @@ public:
 
             // ---------------- Intersection with emitters ----------------
 
-            if (any_or<true>(neq(emitter, nullptr)))
-                result[active] += emission_weight * throughput * emitter->eval(si, active);
+            if (any_or<true>(neq(emitter, nullptr))) {
+                Spectrum contrib = emission_weight * throughput * emitter->eval(si, active);
+                result[active] += contrib;
+                accumulate_order(order_aovs, m_order_aovs, UInt32(depth - 1), contrib,
+                                 ray_.wavelengths, active);
+            }
 
             active &= si.is_valid();
 
@@ -154,10 +197,21 @@ public:
             BSDFPtr bsdf = si.bsdf(ray);
             Mask active_e = active && has_flag(bsdf->flags(), BSDFFlags::Smooth);
 
+            // Delta emitters are connected deterministically at the first intersection
+            bool first_delta = m_delta_direct && depth == 1;
+            if (first_delta && any_or<true>(active_e)) {
+                delta_direct = eval_delta_direct(scene, si, bsdf, active_e);
+                result[active_e] += delta_direct;
+                accumulate_order(order_aovs, m_order_aovs, UInt32(1), delta_direct,
+                                 ray_.wavelengths, active_e);
+            }
+
             if (likely(any_or<true>(active_e))) {
                 auto [ds, emitter_val] = scene->sample_emitter_direction(
                     si, sampler->next_2d(active_e), true, active_e);
                 active_e &= neq(ds.pdf, 0.f);
+                if (first_delta)
+                    active_e &= !ds.delta;
 
                 // Query the BSDF for that emitter-sampled direction
                 Vector3f wo = si.to_local(ds.d);
@@ -168,7 +222,10 @@ public:
                 Float bsdf_pdf = bsdf->pdf(ctx, si, wo, active_e);
 
                 Float mis = select(ds.delta, 1.f, mis_weight(ds.pdf, bsdf_pdf));
-                result[active_e] += mis * throughput * bsdf_val * emitter_val;
+                Spectrum contrib = mis * throughput * bsdf_val * emitter_val;
+                result[active_e] += contrib;
+                accumulate_order(order_aovs, m_order_aovs, UInt32(depth), contrib,
+                                 ray_.wavelengths, active_e);
             }
 
             // ----------------------- BSDF sampling ----------------------
@@ -187,7 +244,7 @@ public:
 
             // Intersect the BSDF ray against the scene geometry
             ray = si.spawn_ray(si.to_world(bs.wo));
-            SurfaceInteraction3f si_bsdf = scene->ray_intersect(ray, active);
+            SurfaceInteraction3f si_bsdf = scene->ray_intersect(ray, scene->hit_compute_flags(), active);
 
             /* Determine probability of having sampled that same
                direction using emitter sampling. */
@@ -207,17 +264,66 @@ public:
             si = std::move(si_bsdf);
         }
 
+        if (m_delta_direct && aovs) {
+            Color3f xyz = aov_xyz(delta_direct, ray_.wavelengths, valid_ray);
+            *aovs++ = xyz.x(); *aovs++ = xyz.y(); *aovs++ = xyz.z();
+        }
+
         return { result, valid_ray };
     }
 
+    /**
+     * \brief Deterministically evaluate the radiance that all delta emitters
+     * scatter towards \c si.wi, accounting for visibility
+     */
+    Spectrum eval_delta_direct(const Scene *scene, const SurfaceInteraction3f &si,
+                               const BSDFPtr &bsdf, Mask active) const {
+        BSDFContext ctx;
+        Spectrum result(0.f);
+
+        for (const auto &emitter : scene->emitters()) {
+            if (!has_flag(emitter->flags(), EmitterFlags::DeltaPosition) &&
+                !has_flag(emitter->flags(), EmitterFlags::DeltaDirection))
+                continue;
+
+            auto [ds, emitter_val] = emitter->sample_direction(si, Point2f(.5f), active);
+            Mask active_e = active && neq(ds.pdf, 0.f);
+            if (none_or<false>(active_e))
+                continue;
+
+            Ray3f ray(si.p, ds.d, math::RayEpsilon<Float> * (1.f + hmax(abs(si.p))),
+                      ds.dist * (1.f - math::ShadowEpsilon<Float>), si.time, si.wavelengths);
+            active_e &= !scene->ray_test(ray, active_e);
+
+            Vector3f wo = si.to_local(ds.d);
+            Spectrum bsdf_val = bsdf->eval(ctx, si, wo, active_e);
+            bsdf_val = si.to_world_mueller(bsdf_val, -wo, si.wi);
+
+            result[active_e] += bsdf_val * emitter_val;
+        }
+
+        return result;
+    }
+
+    std::vector<std::string> aov_names() const override {
+        std::vector<std::string> names;
+        if (m_delta_direct)
+            names = { "delta_direct.X", "delta_direct.Y", "delta_direct.Z" };
+        for (auto &name : order_aov_names(m_order_aovs))
+            names.push_back(name);
+        return names;
+    }
+
     //! @}
     // =============================================================
 
     std::string to_string() const override {
         return tfm::format("PathIntegrator[\n"
             "  max_depth = %i,\n"
-            "  rr_depth = %i\n"
-            "]", m_max_depth, m_rr_depth);
+            "  rr_depth = %i,\n"
+            "  delta_direct = %s,\n"
+            "  order_aovs = %i\n"
+            "]", m_max_depth, m_rr_depth, m_delta_direct, m_order_aovs);
     }
 
     Float mis_weight(Float pdf_a, Float pdf_b) const {
@@ -227,6 +333,9 @@ public:
     }
 
     MTS_DECLARE_CLASS()
+private:
+    bool m_delta_direct;
+    size_t m_order_aovs;
 };
 
 MTS_IMPLEMENT_CLASS_VARIANT(PathIntegrator, MonteCarloIntegrator)
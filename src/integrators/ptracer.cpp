@@ -0,0 +1,447 @@
+#include <mutex>
+
+#include <enoki/stl.h>
+#include <mitsuba/core/profiler.h>
+#include <mitsuba/core/progress.h>
+#include <mitsuba/core/properties.h>
+#include <mitsuba/core/spectrum.h>
+#include <mitsuba/core/timer.h>
+#include <mitsuba/core/util.h>
+#include <mitsuba/render/bsdf.h>
+#include <mitsuba/render/emitter.h>
+#include <mitsuba/render/film.h>
+#include <mitsuba/render/imageblock.h>
+#include <mitsuba/render/integrator.h>
+#include <mitsuba/render/records.h>
+#include <mitsuba/render/sampler.h>
+#include <mitsuba/render/sensor.h>
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#include <tbb/task_arena.h>
+
+NAMESPACE_BEGIN(mitsuba)
+
+/**!
+
+.. _integrator-ptracer:
+
+Particle tracer (:monosp:`ptracer`)
+-----------------------------------
+
+.. pluginparameters::
+
+ * - max_depth
+   - |int|
+   - Specifies the longest path depth in the generated output image (where -1
+     corresponds to :math:`\infty`). The depth is counted as in the
+     :ref:`path <integrator-path>` tracer, e.g. a value of 2 only records
+     single-bounce illumination. (Default: -1)
+ * - rr_depth
+   - |int|
+   - Specifies the minimum path depth, after which the implementation will
+     start to use the *russian roulette* path termination criterion.
+     (Default: 5)
+ * - sample_count
+   - |int|
+   - Total number of particles. By default, this is the sample count of the
+     rendered sensor's sampler times the number of pixels of its film.
+ * - timeout
+   - |float|
+   - Maximum amount of time to spend rendering, in seconds. A negative value
+     indicates no timeout. (Default: -1)
+
+This integrator traces particles (light paths) forward from the emitters,
+which are sampled uniformly, and records their contribution to *every* sensor
+of the scene at once. At each scattering event on a non-specular surface,
+the particle is connected to each sensor through the sensor's
+:code:`sample_direction()` method, and the resulting contribution is splatted
+into that sensor's film. A single particle batch therefore updates all
+sensors, which is much faster than rendering each of them with a backward
+integrator when a scene contains many small sensors (e.g. a large number of
+irradiance meters lit by a :monosp:`directional` sun).
+
+Calling :code:`render()` with any sensor of the scene develops the films of
+all supported sensors, which can then be read individually. Supported sensors
+are the :ref:`perspective <sensor-perspective>` camera and the
+:ref:`irradiancemeter <sensor-irradiancemeter>`. Light arriving on an
+irradiance meter straight from a delta emitter or after specular scattering
+cannot be connected, and is instead recorded when the particle hits the
+sensor's shape. The :ref:`voxeltally <sensor-voxeltally>` sensor receives the
+power absorbed and scattered at every surface interaction, which is estimated
+from the weight of the sampled BSDF direction (with glossy BSDFs, the absorbed
+power of a single interaction can thus be negative). Other sensors, e.g.
+:monosp:`radiancemeter`, measure radiance along a single ray that particles
+cannot reach, and are skipped with a warning.
+
+.. note:: The particle tracer ignores participating media and polarization,
+   does not support the :monosp:`envmap` emitter, and does not record
+   emitters that are directly visible to cameras. It is not supported in GPU
+   variants.
+
+ */
+
+template <typename Float, typename Spectrum>
+class ParticleTracerIntegrator final : public Integrator<Float, Spectrum> {
+public:
+    MTS_IMPORT_BASE(Integrator)
+    MTS_IMPORT_TYPES(Scene, Sensor, Film, ImageBlock, Sampler, Emitter,
+                     EmitterPtr, BSDF, BSDFPtr, Shape, ShapePtr)
+
+    ParticleTracerIntegrator(const Properties &props) : Base(props) {
+        if constexpr (is_cuda_array_v<Float>)
+            Throw("The particle tracer is not supported in GPU variants!");
+
+        m_rr_depth = props.int_("rr_depth", 5);
+        if (m_rr_depth <= 0)
+            Throw("\"rr_depth\" must be set to a value greater than zero!");
+
+        m_max_depth = props.int_("max_depth", -1);
+        if (m_max_depth < 0 && m_max_depth != -1)
+            Throw("\"max_depth\" must be set to -1 (infinite) or a value >= 0");
+
+        m_sample_count = props.size_("sample_count", 0);
+        m_timeout = props.float_("timeout", -1.f);
+    }
+
+    bool render(Scene *scene, Sensor *sensor) override {
+        ScopedPhase sp(ProfilerPhase::Render);
+        m_stop = false;
+
+        if (scene->emitters().empty())
+            Throw("The particle tracer requires at least one emitter!");
+
+        for (const auto &shape : scene->shapes()) {
+            if (shape->is_medium_transition()) {
+                Log(Warn, "The particle tracer ignores participating media!");
+                break;
+            }
+        }
+
+        // Collect the sensors that particles can contribute to
+        std::vector<Sensor *> sensors, tallies;
+        for (const auto &s : scene->sensors()) {
+            if (s->has_direction_sampling())
+                sensors.push_back(s.get());
+            else if (s->has_volume_tally())
+                tallies.push_back(s.get());
+            else
+                Log(Warn, "Sensor \"%s\" does not support particle tracing, "
+                          "skipping it.", s->id());
+        }
+
+        size_t particle_count = m_sample_count;
+        if (particle_count == 0)
+            particle_count = sensor->sampler()->sample_count() *
+                             hprod(sensor->film()->crop_size());
+
+        /* Splats add the contribution of a single particle to the pixels
+           covered by the reconstruction filter. To turn the sum of all splats
+           into per-pixel averages, they are scaled by the number of pixels
+           and divided by the number of particles. */
+        std::vector<std::string> channels = { "X", "Y", "Z", "A", "W" };
+        std::vector<ScalarFloat> scales;
+        for (Sensor *s : sensors) {
+            s->film()->prepare(channels);
+            scales.push_back((ScalarFloat) hprod(s->film()->crop_size()) /
+                             (ScalarFloat) particle_count);
+        }
+
+        // Tallies sum the power deposited by all particles
+        ScalarFloat tally_scale = 1.f / (ScalarFloat) particle_count;
+        for (Sensor *s : tallies)
+            s->film()->prepare(s->tally_channels());
+
+        size_t n_units = (particle_count + ParticlesPerUnit - 1) / ParticlesPerUnit;
+        size_t n_threads = std::min(__global_thread_count,
+                                    (size_t) tbb::this_task_arena::max_concurrency());
+
+        m_render_timer.reset();
+        size_t n_sensors = sensors.size() + tallies.size();
+        Log(Info, "Starting particle tracing job (%i particles, %i sensor%s, %i thread%s)",
+            particle_count, n_sensors, n_sensors == 1 ? "" : "s",
+            n_threads, n_threads == 1 ? "" : "s");
+
+        ThreadEnvironment env;
+        ref<ProgressReporter> progress = new ProgressReporter("Tracing particles");
+        std::mutex mutex;
+        size_t units_done = 0;
+
+        tbb::parallel_for(
+            tbb::blocked_range<size_t>(0, n_units, 1),
+            [&](const tbb::blocked_range<size_t> &units) {
+                ScopedSetThreadEnvironment set_env(env);
+                ref<Sampler> sampler = sensor->sampler()->clone();
+                scoped_flush_denormals flush_denormals(true);
+
+                std::vector<ref<ImageBlock>> blocks;
+                for (Sensor *s : sensors) {
+                    const Film *film = s->film();
+                    ref<ImageBlock> block =
+                        new ImageBlock(film->crop_size(), channels.size(),
+                                       film->reconstruction_filter(), true,
+                                       true, true, true);
+                    block->set_offset(film->crop_offset());
+                    block->clear();
+                    blocks.push_back(block);
+                }
+
+                // Private tally grids, merged into the films at the end
+                std::vector<ref<ImageBlock>> tally_blocks;
+                for (Sensor *s : tallies) {
+                    const Film *film = s->film();
+                    ref<ImageBlock> block =
+                        new ImageBlock(film->crop_size(), s->tally_channels().size(),
+                                       film->reconstruction_filter(), false,
+                                       false, false, false);
+                    block->set_offset(film->crop_offset());
+                    block->clear();
+                    tally_blocks.push_back(block);
+                }
+
+                for (auto i = units.begin(); i != units.end() && !should_stop(); ++i) {
+                    size_t count = std::min(ParticlesPerUnit, particle_count - i * ParticlesPerUnit);
+
+                    if constexpr (!is_array_v<Float>) {
+                        sampler->seed(i);
+                        for (size_t j = 0; j < count; ++j) {
+                            trace_particle(scene, sensor, sensors, blocks, scales,
+                                           tallies, tally_blocks, tally_scale, sampler);
+                            sampler->advance();
+                        }
+                    } else {
+                        sampler->seed(i);
+                        for (auto [index, active] : range<UInt32>((uint32_t) count)) {
+                            ENOKI_MARK_USED(index);
+                            trace_particle(scene, sensor, sensors, blocks, scales,
+                                           tallies, tally_blocks, tally_scale,
+                                           sampler, active);
+                            sampler->advance();
+                        }
+                    }
+
+                    /* Critical section: update progress bar */ {
+                        std::lock_guard<std::mutex> lock(mutex);
+                        units_done++;
+                        progress->update(units_done / (ScalarFloat) n_units);
+                    }
+                }
+
+                for (size_t k = 0; k < sensors.size(); ++k)
+                    sensors[k]->film()->put(blocks[k]);
+                for (size_t k = 0; k < tallies.size(); ++k)
+                    tallies[k]->film()->put(tally_blocks[k]);
+            }
+        );
+
+        // Splats don't carry a sample weight, use unit weights in all pixels
+        auto put_unit_weights = [](Film *film, size_t channel_count) {
+            ref<ImageBlock> block = new ImageBlock(film->crop_size(), channel_count,
+                                                   nullptr, true, true, false);
+            block->set_offset(film->crop_offset());
+            block->clear();
+            ScalarFloat *data = block->data().data();
+            for (size_t i = 0; i < (size_t) hprod(film->crop_size()); ++i)
+                data[i * channel_count + 3] = data[i * channel_count + 4] = 1.f;
+            film->put(block);
+        };
+        for (Sensor *s : sensors)
+            put_unit_weights(s->film(), channels.size());
+        for (Sensor *s : tallies)
+            put_unit_weights(s->film(), s->tally_channels().size());
+
+        if (!m_stop)
+            Log(Info, "Particle tracing finished. (took %s)",
+                util::time_string(m_render_timer.value(), true));
+
+        return !m_stop;
+    }
+
+    void cancel() override { m_stop = true; }
+
+    /// Trace a particle from a randomly chosen emitter and splat its contributions
+    void trace_particle(const Scene *scene, const Sensor *sensor,
+                        const std::vector<Sensor *> &sensors,
+                        const std::vector<ref<ImageBlock>> &blocks,
+                        const std::vector<ScalarFloat> &scales,
+                        const std::vector<Sensor *> &tallies,
+                        const std::vector<ref<ImageBlock>> &tally_blocks,
+                        ScalarFloat tally_scale,
+                        Sampler *sampler, Mask active = true) const {
+        MTS_MASK_ARGUMENT(active);
+
+        // Pick an emitter uniformly and sample an emitted ray
+        const auto &emitters = scene->emitters();
+        UInt32 index = min(UInt32(sampler->next_1d(active) * (ScalarFloat) emitters.size()),
+                           (uint32_t) emitters.size() - 1);
+        EmitterPtr emitter = gather<EmitterPtr>(emitters.data(), index, active);
+
+        Float time = sensor->shutter_open();
+        if (sensor->shutter_open_time() > 0.f)
+            time += sampler->next_1d(active) * sensor->shutter_open_time();
+
+        Float wavelength_sample = sampler->next_1d(active);
+        Point2f sample2 = sampler->next_2d(active),
+                sample3 = sampler->next_2d(active);
+        auto [ray, emitter_weight] =
+            emitter->sample_ray(time, wavelength_sample, sample2, sample3, active);
+
+        UnpolarizedSpectrum throughput =
+            depolarize(emitter_weight) * (ScalarFloat) emitters.size();
+        Wavelength wavelengths = ray.wavelengths;
+
+        /* Emitted light and vertices reached through a specular scattering
+           event aren't connected to the sensors. Their contribution is
+           recorded when the particle hits the shape of a sensor. */
+        Mask specular = true;
+        UInt32 depth = 0;
+        BSDFContext ctx(TransportMode::Importance);
+
+        while (true) {
+            active &= any(neq(throughput, 0.f));
+            if (none_or<false>(active))
+                break;
+
+            SurfaceInteraction3f si = scene->ray_intersect(ray, active);
+            active &= si.is_valid();
+            if (none_or<false>(active))
+                break;
+
+            // ------------------- Hits on sensor shapes ------------------
+            Mask record_hit = active && specular && depth < (uint32_t) m_max_depth;
+            if (any_or<true>(record_hit)) {
+                for (size_t k = 0; k < sensors.size(); ++k) {
+                    const Shape *shape = sensors[k]->shape();
+                    if (!shape)
+                        continue;
+                    Mask hit = record_hit && eq(si.shape, ShapePtr(shape));
+                    if (none_or<false>(hit))
+                        continue;
+                    UnpolarizedSpectrum importance =
+                        depolarize(sensors[k]->eval(si, hit));
+                    const Film *film = sensors[k]->film();
+                    Point2f pos = ScalarPoint2f(film->crop_offset()) +
+                                  .5f * ScalarVector2f(film->crop_size());
+                    splat(blocks[k], pos, throughput * importance * scales[k],
+                          wavelengths, hit);
+                }
+            }
+
+            depth++;
+            active &= depth < (uint32_t) m_max_depth;
+            if (none_or<false>(active))
+                break;
+
+            // ------------------- Connections to sensors -------------------
+            BSDFPtr bsdf = si.bsdf(ray);
+            Mask connect = active && has_flag(bsdf->flags(), BSDFFlags::Smooth);
+            if (any_or<true>(connect)) {
+                for (size_t k = 0; k < sensors.size(); ++k) {
+                    auto [ds, importance] =
+                        sensors[k]->sample_direction(si, sampler->next_2d(connect), connect);
+                    Mask valid = connect && neq(ds.pdf, 0.f) &&
+                                 any(neq(depolarize(importance), 0.f));
+                    if (none_or<false>(valid))
+                        continue;
+
+                    Vector3f wo = si.to_local(ds.d);
+                    UnpolarizedSpectrum bsdf_val = depolarize(bsdf->eval(ctx, si, wo, valid));
+                    valid &= any(neq(bsdf_val, 0.f));
+
+                    Ray3f shadow_ray(si.p, ds.d,
+                                     math::RayEpsilon<Float> * (1.f + hmax(abs(si.p))),
+                                     ds.dist * (1.f - math::ShadowEpsilon<Float>),
+                                     si.time, wavelengths);
+                    valid &= !scene->ray_test(shadow_ray, valid);
+                    if (none_or<false>(valid))
+                        continue;
+
+                    const Film *film = sensors[k]->film();
+                    splat(blocks[k], ds.uv + ScalarVector2f(film->crop_offset()),
+                          throughput * bsdf_val * depolarize(importance) * scales[k],
+                          wavelengths, valid);
+                }
+            }
+
+            // ------------------------ BSDF sampling ------------------------
+            auto [bs, bsdf_weight] = bsdf->sample(ctx, si, sampler->next_1d(active),
+                                                  sampler->next_2d(active), active);
+
+            // -------------------- Deposited power tallies -------------------
+            if (!tallies.empty()) {
+                /* Collision estimator: the sampled BSDF weight estimates the
+                   fraction of the incident power that is scattered */
+                UnpolarizedSpectrum scattered = throughput * depolarize(bsdf_weight);
+                for (size_t k = 0; k < tallies.size(); ++k)
+                    tallies[k]->tally(tally_blocks[k], si.p,
+                                      (throughput - scattered) * tally_scale,
+                                      scattered * tally_scale, wavelengths, active);
+            }
+
+            // ----------------------- Russian roulette ----------------------
+            Mask perform_rr = active && depth > (uint32_t) m_rr_depth;
+            if (any_or<true>(perform_rr)) {
+                Float q = min(hmax(throughput), .95f);
+                active &= sampler->next_1d(active) < q || !perform_rr;
+                masked(throughput, perform_rr) *= rcp(q);
+            }
+
+            masked(throughput, active) *= depolarize(bsdf_weight);
+            active &= bs.pdf > 0.f;
+
+            specular = has_flag(bs.sampled_type, BSDFFlags::Delta);
+            masked(ray, active) = si.spawn_ray(si.to_world(bs.wo));
+        }
+    }
+
+    std::string to_string() const override {
+        return tfm::format("ParticleTracerIntegrator[\n"
+                           "  max_depth = %i,\n"
+                           "  rr_depth = %i,\n"
+                           "  sample_count = %i\n"
+                           "]",
+                           m_max_depth, m_rr_depth, m_sample_count);
+    }
+
+    MTS_DECLARE_CLASS()
+private:
+    /// Number of particles traced per work unit
+    static constexpr size_t ParticlesPerUnit = 4096;
+
+    bool should_stop() const {
+        return m_stop || (m_timeout > 0.f &&
+                          m_render_timer.value() > 1000.f * m_timeout);
+    }
+
+    /// Add a contribution to an image block without incrementing the sample weight
+    void splat(ImageBlock *block, const Point2f &pos,
+               const UnpolarizedSpectrum &value,
+               const Wavelength &wavelengths, Mask active) const {
+        Color3f xyz;
+        if constexpr (is_monochromatic_v<Spectrum>) {
+            ENOKI_MARK_USED(wavelengths);
+            xyz = value.x();
+        } else if constexpr (is_rgb_v<Spectrum>) {
+            ENOKI_MARK_USED(wavelengths);
+            xyz = srgb_to_xyz(value, active);
+        } else {
+            static_assert(is_spectral_v<Spectrum>);
+            xyz = spectrum_to_xyz(value, wavelengths, active);
+        }
+
+        Float values[5] = { xyz.x(), xyz.y(), xyz.z(), 0.f, 0.f };
+        block->put(pos, values, active);
+    }
+
+private:
+    int m_max_depth;
+    int m_rr_depth;
+    size_t m_sample_count;
+    float m_timeout;
+
+    bool m_stop = false;
+    Timer m_render_timer;
+};
+
+MTS_IMPLEMENT_CLASS_VARIANT(ParticleTracerIntegrator, Integrator);
+MTS_EXPORT_PLUGIN(ParticleTracerIntegrator, "Particle tracer integrator");
+NAMESPACE_END(mitsuba)
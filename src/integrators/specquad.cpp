@@ -0,0 +1,329 @@
+#include <enoki/morton.h>
+#include <mitsuba/core/properties.h>
+#include <mitsuba/core/quad.h>
+#include <mitsuba/core/spectrum.h>
+#include <mitsuba/core/string.h>
+#include <mitsuba/render/film.h>
+#include <mitsuba/render/imageblock.h>
+#include <mitsuba/render/integrator.h>
+#include <mitsuba/render/sampler.h>
+#include <mitsuba/render/sensor.h>
+
+NAMESPACE_BEGIN(mitsuba)
+
+/**!
+
+.. _integrator-specquad:
+
+Spectral quadrature integrator (:monosp:`specquad`)
+---------------------------------------------------
+
+.. pluginparameters::
+
+ * - bins
+   - |string|
+   - Comma-separated list of spectral bins, each given as
+     :monosp:`name:lambda_min:lambda_max` (in nanometers), e.g.
+     :monosp:`"blue:400:500, green:500:600, red:600:700"`.
+ * - rule
+   - |string|
+   - Quadrature rule used within each bin, either :monosp:`gauss_legendre`
+     or :monosp:`gauss_lobatto`. (Default: :monosp:`gauss_legendre`)
+ * - (Nested plugin)
+   - :paramtype:`integrator`
+   - Sub-integrator (only one can be specified) that computes the radiance
+     along the camera rays.
+
+Spectral variants normally assign random wavelengths to each sample, so that
+narrow-band quantities carry spectral Monte Carlo noise on top of the spatial
+noise. This integrator instead evaluates each camera ray at the fixed nodes of
+a quadrature rule: the spectral lanes of a sample (4 by default) are filled
+with the nodes of one bin, and its contribution is weighted with the
+quadrature weights. Samples cycle through the bins, so that each pixel
+receives the same number of samples per bin. The band integrals then only
+carry spatial noise, and converge with far fewer samples when the spectra of
+the scene are smooth within each bin: an :math:`n`-point Gauss-Legendre rule
+integrates polynomials of degree :math:`2n - 1` exactly.
+
+For each bin, the film receives a channel with the average radiance over the
+bin (multiply by the bin width to obtain the band integral). The XYZ channels
+hold the tristimulus values integrated over the bins, which match a regular
+spectral rendering when the bins cover the visible range.
+
+.. code-block:: xml
+
+    <integrator type="specquad">
+        <string name="bins" value="blue:400:500, green:500:600, red:600:700"/>
+        <integrator type="path"/>
+    </integrator>
+
+.. note::
+
+   This integrator can only be used with non-polarized spectral variants on
+   the CPU. The number of samples per pass must be a multiple of the number of
+   bins. The sensor must sample wavelengths with the default strategy (i.e.
+   without a spectral response function), whose weight is replaced by the
+   quadrature weights. AOVs of the nested integrator are written after the bin
+   channels.
+
+ */
+template <typename Float, typename Spectrum>
+class SpectralQuadratureIntegrator final : public AccumulatorIntegrator<Float, Spectrum> {
+public:
+    MTS_IMPORT_BASE(AccumulatorIntegrator, m_integrator, m_accumulator_aov_names,
+                    m_block_size, m_samples_per_pass, should_stop)
+    MTS_IMPORT_TYPES(Scene, Sensor, Sampler, ImageBlock, Medium)
+    using FloatStorage = DynamicBuffer<Float>;
+
+    SpectralQuadratureIntegrator(const Properties &props) : Base(props) {
+        if constexpr (!is_spectral_v<Spectrum>)
+            Throw("This integrator can only be used with a spectral variant!");
+        if constexpr (is_polarized_v<Spectrum>)
+            Throw("This integrator cannot (yet) be used in polarized mode!");
+        if constexpr (is_cuda_array_v<Float>)
+            Throw("This integrator is only supported on the CPU!");
+
+        // Quadrature rule over [-1, 1] with one node per spectral lane
+        using FloatX = DynamicArray<Packet<ScalarFloat>>;
+        int node_count = (int) array_size_v<Wavelength>;
+        std::string rule = props.string("rule", "gauss_legendre");
+        FloatX rule_nodes, rule_weights;
+        if (rule == "gauss_legendre")
+            std::tie(rule_nodes, rule_weights) = quad::gauss_legendre<FloatX>(node_count);
+        else if (rule == "gauss_lobatto")
+            std::tie(rule_nodes, rule_weights) = quad::gauss_lobatto<FloatX>(node_count);
+        else
+            Throw("Invalid quadrature rule \"%s\", must be one of: \"gauss_legendre\", "
+                  "\"gauss_lobatto\"!", rule);
+
+        // Parse bin specification
+        std::vector<std::string> tokens = string::tokenize(props.string("bins"), " ,");
+        std::vector<ScalarFloat> nodes, weights, widths;
+        for (const std::string &token : tokens) {
+            std::vector<std::string> item = string::tokenize(token, ":");
+            if (item.size() != 3 || item[0].empty())
+                Throw("Invalid spectral bin specification '%s'", token);
+
+            ScalarFloat lower, upper;
+            try {
+                lower = (ScalarFloat) std::stod(item[1]);
+                upper = (ScalarFloat) std::stod(item[2]);
+            } catch (...) {
+                Throw("Could not parse spectral bin '%s'", token);
+            }
+            if (!(lower < upper))
+                Throw("Empty spectral bin '%s'", token);
+
+            /* Map the rule to the bin. The weights are normalized to sum to
+               one, so that the quadrature yields the average over the bin. */
+            for (int i = 0; i < node_count; ++i) {
+                nodes.push_back(lower + .5f * (rule_nodes[i] + 1.f) * (upper - lower));
+                weights.push_back(.5f * rule_weights[i]);
+            }
+            widths.push_back(upper - lower);
+            m_accumulator_aov_names.push_back(item[0]);
+        }
+
+        if (m_accumulator_aov_names.empty())
+            Throw("No spectral bin was specified!");
+
+        m_nodes   = FloatStorage::copy(nodes.data(), nodes.size());
+        m_weights = FloatStorage::copy(weights.data(), weights.size());
+        m_widths  = FloatStorage::copy(widths.data(), widths.size());
+    }
+
+    bool render(Scene *scene, Sensor *sensor) override {
+        size_t total_spp = sensor->sampler()->sample_count(),
+               samples_per_pass = std::min((size_t) m_samples_per_pass, total_spp);
+        size_t bin_count = m_accumulator_aov_names.size();
+        if (samples_per_pass % bin_count != 0)
+            Throw("The number of samples per pass (%i) must be a multiple of the "
+                  "number of spectral bins (%i)!", samples_per_pass, bin_count);
+        return Base::render(scene, sensor);
+    }
+
+    std::string to_string() const override {
+        std::ostringstream oss;
+        oss << "SpectralQuadratureIntegrator[" << std::endl
+            << "  bins = " << string::indent(m_accumulator_aov_names) << "," << std::endl
+            << "  integrator = " << string::indent(m_integrator) << std::endl
+            << "]";
+        return oss.str();
+    }
+
+    MTS_DECLARE_CLASS()
+protected:
+    /**
+     * Writes the average radiance over the bin of the sample into its channel.
+     * The bin is identified by the wavelengths, which are exactly its nodes.
+     */
+    void accumulate(const Spectrum &value, const Wavelength &wavelengths,
+                    const Float * /* nested_aovs */, Float *aovs,
+                    Mask active) const override {
+        size_t node_count = array_size_v<Wavelength>,
+               bin_count  = m_accumulator_aov_names.size();
+        UnpolarizedSpectrum spec_u = depolarize(value);
+
+        for (size_t i = 0; i < bin_count; ++i) {
+            Mask match = active;
+            Wavelength weights;
+            for (size_t j = 0; j < node_count; ++j) {
+                UInt32 index = (uint32_t)(i * node_count + j);
+                match &= eq(wavelengths[j], gather<Float>(m_nodes, index, active));
+                weights[j] = gather<Float>(m_weights, index, active);
+            }
+            aovs[i] = select(match, hsum(spec_u * weights) * (ScalarFloat) bin_count, 0.f);
+        }
+    }
+
+    /**
+     * Same as the default implementation, but assigns a bin to each sample,
+     * which the default \ref render_sample() has no means to do
+     */
+    void render_block(const Scene *scene, const Sensor *sensor, Sampler *sampler,
+                      ImageBlock *block, Float *aovs, size_t sample_count_,
+                      size_t block_id) const override {
+        block->clear();
+        uint32_t pixel_count  = (uint32_t)(m_block_size * m_block_size),
+                 sample_count = (uint32_t)(sample_count_ == (size_t) -1
+                                               ? sampler->sample_count()
+                                               : sample_count_),
+                 bin_count    = (uint32_t) m_accumulator_aov_names.size();
+
+        ScalarFloat diff_scale_factor = rsqrt((ScalarFloat) sampler->sample_count());
+
+        if constexpr (!is_array_v<Float>) {
+            for (uint32_t i = 0; i < pixel_count && !should_stop(); ++i) {
+                sampler->seed(block_id * pixel_count + i);
+
+                ScalarPoint2u pos = enoki::morton_decode<ScalarPoint2u>(i);
+                if (any(pos >= block->size()))
+                    continue;
+
+                pos += block->offset();
+                for (uint32_t j = 0; j < sample_count && !should_stop(); ++j) {
+                    render_quadrature_sample(scene, sensor, sampler, block, aovs, pos,
+                                             diff_scale_factor, j % bin_count);
+                }
+            }
+        } else if constexpr (is_array_v<Float> && !is_cuda_array_v<Float>) {
+            // Ensure that the sample generation is fully deterministic
+            sampler->seed(block_id);
+
+            for (auto [index, active] : range<UInt32>(pixel_count * sample_count)) {
+                if (should_stop())
+                    break;
+                Point2u pos = enoki::morton_decode<Point2u>(index / UInt32(sample_count));
+                active &= !any(pos >= block->size());
+                pos += block->offset();
+                UInt32 bin = (index % UInt32(sample_count)) % bin_count;
+                render_quadrature_sample(scene, sensor, sampler, block, aovs, pos,
+                                         diff_scale_factor, bin, active);
+            }
+        } else {
+            ENOKI_MARK_USED(scene);
+            ENOKI_MARK_USED(sensor);
+            ENOKI_MARK_USED(aovs);
+            ENOKI_MARK_USED(diff_scale_factor);
+            ENOKI_MARK_USED(pixel_count);
+            ENOKI_MARK_USED(sample_count);
+            ENOKI_MARK_USED(bin_count);
+            Throw("Not implemented for CUDA arrays.");
+        }
+    }
+
+    /// Render a sample at the quadrature nodes of spectral bin \c bin
+    void render_quadrature_sample(const Scene *scene, const Sensor *sensor,
+                                  Sampler *sampler, ImageBlock *block, Float *aovs,
+                                  const Vector2f &pos,
+                                  ScalarFloat diff_scale_factor, const UInt32 &bin,
+                                  Mask active = true) const {
+        if constexpr (!is_spectral_v<Spectrum>) {
+            ENOKI_MARK_USED(scene);
+            ENOKI_MARK_USED(sensor);
+            ENOKI_MARK_USED(sampler);
+            ENOKI_MARK_USED(block);
+            ENOKI_MARK_USED(aovs);
+            ENOKI_MARK_USED(pos);
+            ENOKI_MARK_USED(diff_scale_factor);
+            ENOKI_MARK_USED(bin);
+            ENOKI_MARK_USED(active);
+            Throw("This integrator can only be used with a spectral variant!");
+        } else {
+            Vector2f position_sample = pos + sampler->next_2d(active);
+
+            Point2f aperture_sample(.5f);
+            if (sensor->needs_aperture_sample())
+                aperture_sample = sampler->next_2d(active);
+
+            Float time = sensor->shutter_open();
+            if (sensor->shutter_open_time() > 0.f)
+                time += sampler->next_1d(active) * sensor->shutter_open_time();
+
+            Float wavelength_sample = sampler->next_1d(active);
+
+            Vector2f adjusted_position =
+                (position_sample - sensor->film()->crop_offset()) /
+                sensor->film()->crop_size();
+
+            auto [ray, ray_weight] = sensor->sample_ray_differential(
+                time, wavelength_sample, adjusted_position, aperture_sample);
+
+            ray.scale_differential(diff_scale_factor);
+
+            /* Remove the inverse density of the sampled wavelengths from the
+               sensor weight (see aov_xyz()), and move the ray to the nodes */
+            Float sensor_weight =
+                hmean(depolarize(ray_weight) * pdf_rgb_spectrum(ray.wavelengths));
+
+            size_t node_count = array_size_v<Wavelength>;
+            Wavelength weights;
+            for (size_t i = 0; i < node_count; ++i) {
+                UInt32 index = bin * (uint32_t) node_count + (uint32_t) i;
+                ray.wavelengths[i] = gather<Float>(m_nodes, index, active);
+                weights[i] = gather<Float>(m_weights, index, active);
+            }
+
+            /* Same as AccumulatorIntegrator::sample(), but the direct estimate
+               of the sensor must enter the bins as well */
+            ScalarFloat bin_count = (ScalarFloat) m_accumulator_aov_names.size();
+            Float *nested_aovs = aovs + 5 + m_accumulator_aov_names.size();
+            const Medium *medium = sensor->medium();
+            std::pair<Spectrum, Mask> result =
+                m_integrator->sample(scene, sampler, ray, medium, nested_aovs, active);
+            if (sensor->has_direct_estimate())
+                result.first += sensor->eval_direct(scene, time, ray.wavelengths, adjusted_position,
+                                                    aperture_sample, active);
+            result.first *= sensor_weight;
+            accumulate(result.first, ray.wavelengths, nested_aovs, aovs + 5, active);
+
+            UnpolarizedSpectrum spec_u = depolarize(result.first) * weights;
+
+            /* Each bin is visited by a fraction 1 / bin_count of the samples.
+               spectrum_to_xyz() averages over the lanes, hence the node count. */
+            Float scale = gather<Float>(m_widths, bin, active) * (bin_count * node_count);
+            Color3f xyz = spectrum_to_xyz(spec_u * scale, ray.wavelengths, active);
+
+            aovs[0] = xyz.x();
+            aovs[1] = xyz.y();
+            aovs[2] = xyz.z();
+            aovs[3] = select(result.second, Float(1.f), Float(0.f));
+            aovs[4] = 1.f;
+
+            block->put(position_sample, aovs, active);
+
+            sampler->advance();
+        }
+    }
+
+private:
+    /// Quadrature nodes (in nm) and normalized weights, one lane per node
+    FloatStorage m_nodes;
+    FloatStorage m_weights;
+    /// Width of each bin (in nm)
+    FloatStorage m_widths;
+};
+
+MTS_IMPLEMENT_CLASS_VARIANT(SpectralQuadratureIntegrator, AccumulatorIntegrator)
+MTS_EXPORT_PLUGIN(SpectralQuadratureIntegrator, "Spectral quadrature integrator");
+NAMESPACE_END(mitsuba)
@@ -55,39 +55,25 @@ integrator:
  */
 
 template <typename Float, typename Spectrum>
-class StokesIntegrator final : public SamplingIntegrator<Float, Spectrum> {
+class StokesIntegrator final : public AccumulatorIntegrator<Float, Spectrum> {
 public:
-    MTS_IMPORT_BASE(SamplingIntegrator)
-    MTS_IMPORT_TYPES(Scene, Sampler, Medium)
+    MTS_IMPORT_BASE(AccumulatorIntegrator, m_accumulator_aov_names)
+    MTS_IMPORT_TYPES()
 
     StokesIntegrator(const Properties &props) : Base(props) {
         if constexpr (!is_polarized_v<Spectrum>)
             Throw("This integrator should only be used in polarized mode!");
-        for (auto &kv : props.objects()) {
-            Base *integrator = dynamic_cast<Base *>(kv.second.get());
-            if (!integrator)
-                Throw("Child objects must be of type 'SamplingIntegrator'!");
-            if (m_integrator)
-                Throw("More than one sub-integrator specified!");
-            m_integrator = integrator;
-        }
 
-        if (!m_integrator)
-            Throw("Must specify a sub-integrator!");
+        for (int i = 0; i < 4; ++i)
+            for (int j = 0; j < 3; ++j)
+                m_accumulator_aov_names.push_back("S" + std::to_string(i) + "." + ("RGB"[j]));
     }
 
-    std::pair<Spectrum, Mask> sample(const Scene *scene,
-                                     Sampler * sampler,
-                                     const RayDifferential3f &ray,
-                                     const Medium *medium,
-                                     Float *aovs,
-                                     Mask active) const override {
-        MTS_MASKED_FUNCTION(ProfilerPhase::SamplingIntegratorSample, active);
-
-        auto result = m_integrator->sample(scene, sampler, ray, medium, aovs + 12, active);
-
+    void accumulate(const Spectrum &value, const Wavelength &wavelengths,
+                    const Float * /* nested_aovs */, Float *aovs,
+                    Mask active) const override {
         if constexpr (is_polarized_v<Spectrum>) {
-            auto const &stokes = result.first.coeff(0);
+            auto const &stokes = value.coeff(0);
             for (int i = 0; i < 4; ++i) {
                 Color3f rgb;
                 if constexpr (is_monochromatic_v<Spectrum>) {
@@ -97,35 +83,24 @@ public:
                 } else {
                     static_assert(is_spectral_v<Spectrum>);
                     /// Note: this assumes that sensor used sample_rgb_spectrum() to generate 'ray.wavelengths'
-                    auto pdf = pdf_rgb_spectrum(ray.wavelengths);
+                    auto pdf = pdf_rgb_spectrum(wavelengths);
                     UnpolarizedSpectrum spec = stokes[i] * select(neq(pdf, 0.f), rcp(pdf), 0.f);
-                    rgb = xyz_to_srgb(spectrum_to_xyz(spec, ray.wavelengths, active));
+                    rgb = xyz_to_srgb(spectrum_to_xyz(spec, wavelengths, active));
                 }
 
                 *aovs++ = rgb.r(); *aovs++ = rgb.g(); *aovs++ = rgb.b();
             }
+        } else {
+            ENOKI_MARK_USED(value);
+            ENOKI_MARK_USED(wavelengths);
+            ENOKI_MARK_USED(aovs);
+            ENOKI_MARK_USED(active);
         }
-
-        return result;
-    }
-
-    std::vector<std::string> aov_names() const override {
-        std::vector<std::string> result = m_integrator->aov_names();
-        for (int i = 0; i < 4; ++i)
-            for (int j = 0; j < 3; ++j)
-                result.insert(result.begin() + 3*i + j, "S" + std::to_string(i) + "." + ("RGB"[j]));
-        return result;
-    }
-
-    void traverse(TraversalCallback *callback) override {
-        callback->put_object("integrator", m_integrator.get());
     }
 
     MTS_DECLARE_CLASS()
-private:
-    ref<Base> m_integrator;
 };
 
-MTS_IMPLEMENT_CLASS_VARIANT(StokesIntegrator, SamplingIntegrator)
+MTS_IMPLEMENT_CLASS_VARIANT(StokesIntegrator, AccumulatorIntegrator)
 MTS_EXPORT_PLUGIN(StokesIntegrator, "Stokes integrator");
 NAMESPACE_END(mitsuba)
@@ -164,3 +164,43 @@ def test_sample(variant_scalar_spectral):
         result = run(scene)
     # We expect divide-by-zero problems with unpopulated bins
     assert any(np.isnan(result))
+
+
+def test_pipeline(variant_scalar_spectral):
+    from mitsuba.core.xml import load_dict
+
+    # Nested stages store their AOVs after those of the outer stage
+    integrator = load_dict({
+        "type": "moment",
+        "bins": {
+            "type": "nbins",
+            "wavelengths": "400, 500",
+            "integrator": {
+                "type": "nbins",
+                "wavelengths": "600",
+                "integrator": {"type": "path"}
+            }
+        }
+    })
+    names = ["400", "400_pop", "500", "500_pop", "600", "600_pop"]
+    names = ["bins." + name for name in names] + ["bins.X", "bins.Y", "bins.Z"]
+    assert integrator.aov_names() == names + ["m2_" + name for name in names]
+
+    # Both moments are computed from the same radiance samples. All spectral
+    # lanes fall into the single bin, so that its population is constant.
+    radiance = 2.0
+    scene = load_dict(scene_dict(
+        [500],
+        integrator={
+            "type": "moment",
+            "bins": integrator_dict(wavelengths=[500]),
+        },
+        spp=10,
+        radiance=radiance
+    ))
+    sensor = scene.sensors()[0]
+    scene.integrator().render(scene, sensor)
+    aovs = np.array(sensor.film().bitmap()).squeeze()[4:]
+
+    assert np.allclose(aovs[0] / aovs[1], radiance)
+    assert np.allclose(aovs[5] / aovs[6], radiance**2)
@@ -0,0 +1,144 @@
+import numpy as np
+import pytest
+
+import enoki as ek
+import mitsuba
+
+
+def make_scene(sky=None, occluder=False, **kwargs):
+    from mitsuba.core import ScalarTransform4f
+    from mitsuba.core.xml import load_dict
+
+    d = {
+        "type": "scene",
+        "surface": {
+            "type": "rectangle",
+            "bsdf": {
+                "type": "diffuse",
+                "reflectance": {"type": "uniform", "value": 0.5}
+            }
+        },
+        "sun": {
+            "type": "directional",
+            "direction": [0, 0, -1],
+            "irradiance": {"type": "uniform", "value": 1.0}
+        },
+        "integrator": dict(type="path", delta_direct=True, **kwargs)
+    }
+
+    if sky is not None:
+        d["sky"] = {
+            "type": "constant",
+            "radiance": {"type": "uniform", "value": sky}
+        }
+
+    if occluder:
+        d["occluder"] = {
+            "type": "rectangle",
+            "to_world": ScalarTransform4f.translate([0, 0, 2]) *
+                        ScalarTransform4f.scale(0.1)
+        }
+
+    return load_dict(d)
+
+
+def sample_path(scene, count=10):
+    from mitsuba.core import RayDifferential3f
+
+    sampler = scene.sensors()[0].sampler()
+    sampler.seed(0)
+    integrator = scene.integrator()
+
+    results = []
+    for o in np.random.uniform(-0.5, 0.5, size=(count, 2)):
+        ray = RayDifferential3f([o[0], o[1], 1], [0, 0, -1], 0, [])
+        value, valid, aovs = integrator.sample(scene, sampler, ray)
+        assert valid
+        results.append((value, aovs))
+    return results
+
+
+def test01_delta_direct_aov(variant_scalar_rgb):
+    scene = make_scene(max_depth=2)
+    assert scene.integrator().aov_names() == \
+        ["delta_direct.X", "delta_direct.Y", "delta_direct.Z"]
+
+    # Single scattering of the sun only: fully deterministic
+    for value, aovs in sample_path(scene):
+        assert ek.allclose(value, 0.5 / ek.pi)
+        assert ek.allclose(aovs[1], 0.5 / ek.pi)
+
+
+def test02_delta_direct_with_sky(variant_scalar_rgb):
+    # The sky is still sampled stochastically, but the sun term doesn't
+    # depend on emitter selection anymore
+    scene = make_scene(sky=1.0, max_depth=2)
+    results = sample_path(scene, count=200)
+
+    for value, aovs in results:
+        assert ek.allclose(aovs[1], 0.5 / ek.pi)
+
+    mean = np.mean([value[0] for value, _ in results])
+    assert ek.allclose(mean, 0.5 / ek.pi + 0.5, atol=0.12)
+
+
+def test03_delta_direct_occluded(variant_scalar_rgb):
+    from mitsuba.core import RayDifferential3f
+
+    scene = make_scene(occluder=True, max_depth=2)
+    sampler = scene.sensors()[0].sampler()
+    sampler.seed(0)
+
+    # The occluder sits between the sun and the center of the surface
+    ray = RayDifferential3f([0, 0, 1], [0, 0, -1], 0, [])
+    value, _, aovs = scene.integrator().sample(scene, sampler, ray)
+    assert ek.allclose(value, 0.0)
+    assert ek.allclose(aovs, 0.0)
+
+
+@pytest.mark.parametrize("integrator", ["path", "volpath"])
+def test04_order_aovs(variant_scalar_rgb, integrator):
+    from mitsuba.core import RayDifferential3f, ScalarTransform4f
+    from mitsuba.core.xml import load_dict
+
+    scene = load_dict({
+        "type": "scene",
+        "floor": {
+            "type": "rectangle",
+            "bsdf": {"type": "diffuse", "reflectance": {"type": "uniform", "value": 0.5}}
+        },
+        "wall": {
+            "type": "rectangle",
+            "to_world": ScalarTransform4f.translate([1, 0, 1]) *
+                        ScalarTransform4f.rotate([0, 1, 0], -90),
+            "bsdf": {"type": "diffuse", "reflectance": {"type": "uniform", "value": 0.8}}
+        },
+        "sun": {
+            "type": "directional",
+            "direction": [-1, 0, -1],
+            "irradiance": {"type": "uniform", "value": 1.0}
+        },
+        "sky": {
+            "type": "constant",
+            "radiance": {"type": "uniform", "value": 0.5}
+        },
+        "integrator": {"type": integrator, "max_depth": 4, "order_aovs": 3}
+    })
+
+    names = scene.integrator().aov_names()
+    assert names == ["order_%i.%s" % (i, c) for i in range(1, 4) for c in "XYZ"]
+
+    sampler = scene.sensors()[0].sampler()
+    sampler.seed(0)
+
+    # Every contribution has an order between 1 and 3, so the AOVs add up to
+    # the total estimate
+    nonzero = [False] * 3
+    for o in np.random.uniform(-0.9, 0.9, size=(50, 2)):
+        ray = RayDifferential3f([o[0], o[1], 1], [0, 0, -1], 0, [])
+        value, _, aovs = scene.integrator().sample(scene, sampler, ray)
+        orders = [aovs[3 * i + 1] for i in range(3)]
+        assert ek.allclose(sum(orders), value[1], rtol=1e-4, atol=1e-6)
+        for i in range(3):
+            nonzero[i] |= orders[i] > 0
+    assert all(nonzero)
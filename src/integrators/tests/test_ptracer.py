@@ -0,0 +1,162 @@
+import numpy as np
+import pytest
+
+import enoki as ek
+import mitsuba
+
+
+def scene_dict(sample_count=10000):
+    from mitsuba.core import ScalarTransform4f
+
+    film = {
+        "type": "hdrfilm",
+        "width": 1,
+        "height": 1,
+        "pixel_format": "luminance",
+        "rfilter": {"type": "box"}
+    }
+
+    return {
+        "type": "scene",
+        "integrator": {"type": "ptracer", "sample_count": sample_count},
+        "emitter": {
+            "type": "point",
+            "position": [0, 0, 2],
+            "intensity": {"type": "rgb", "value": [1, 1, 1]}
+        },
+        "meter": {
+            "type": "rectangle",
+            "bsdf": {
+                "type": "diffuse",
+                "reflectance": {"type": "rgb", "value": [0, 0, 0]}
+            },
+            "sensor": {"type": "irradiancemeter", "film": film}
+        },
+        "radiancemeter": {
+            "type": "radiancemeter",
+            "origin": [0, 0, 1],
+            "direction": [0, 0, -1],
+            "film": film
+        }
+    }
+
+
+def test01_construct(variant_scalar_rgb):
+    from mitsuba.core.xml import load_dict
+
+    integrator = load_dict({"type": "ptracer", "max_depth": 3})
+    assert integrator is not None
+
+    with pytest.raises(RuntimeError):
+        load_dict({"type": "ptracer", "rr_depth": 0})
+
+
+def test02_direction_sampling(variant_scalar_rgb):
+    from mitsuba.core.xml import load_dict
+
+    scene = load_dict(scene_dict())
+    sensors = scene.sensors()
+    assert len(sensors) == 2
+    has = sorted(s.has_direction_sampling() for s in sensors)
+    assert has == [False, True]
+
+    camera = load_dict({"type": "perspective"})
+    assert camera.has_direction_sampling()
+
+
+def test03_point_light_irradiance(variant_scalar_rgb):
+    """A point light with unit intensity above the center of a 2x2 irradiance
+    meter, at a distance of 2: the mean irradiance is the solid angle
+    subtended by the meter divided by its area."""
+    from mitsuba.core.xml import load_dict
+
+    scene = load_dict(scene_dict(sample_count=100000))
+    meter = [s for s in scene.sensors() if s.has_direction_sampling()][0]
+    assert scene.integrator().render(scene, meter)
+
+    value = np.array(meter.film().bitmap()).squeeze()
+    expected = 4.0 * np.arcsin(1.0 / 5.0) / 4.0
+    assert np.allclose(value, expected, rtol=2e-2)
+
+
+def test04_splat_all_sensors(variant_scalar_rgb):
+    """Two irradiance meters and a camera above a diffuse floor lit by a point
+    light. The meters face the floor, so that they only receive light through
+    the sample_direction() connections. A single particle tracing pass must
+    match separate path traced renders of each sensor."""
+    from mitsuba.core import ScalarTransform4f
+    from mitsuba.core.xml import load_dict
+
+    def film(size):
+        return {
+            "type": "hdrfilm",
+            "width": size,
+            "height": size,
+            "pixel_format": "luminance",
+            "rfilter": {"type": "box"}
+        }
+
+    def meter(x):
+        return {
+            "type": "rectangle",
+            "to_world": ScalarTransform4f.translate([x, 0, 1])
+                        * ScalarTransform4f.rotate([1, 0, 0], 180)
+                        * ScalarTransform4f.scale(0.1),
+            "bsdf": {
+                "type": "diffuse",
+                "reflectance": {"type": "rgb", "value": [0, 0, 0]}
+            },
+            "sensor": {
+                "type": "irradiancemeter",
+                "film": film(1),
+                "sampler": {"type": "independent", "sample_count": 4096}
+            }
+        }
+
+    def make_scene(integrator):
+        return load_dict({
+            "type": "scene",
+            "integrator": integrator,
+            "emitter": {
+                "type": "point",
+                "position": [0, 0, 2],
+                "intensity": {"type": "rgb", "value": [10, 10, 10]}
+            },
+            "floor": {
+                "type": "rectangle",
+                "to_world": ScalarTransform4f.scale(2),
+                "bsdf": {
+                    "type": "diffuse",
+                    "reflectance": {"type": "rgb", "value": [0.5, 0.5, 0.5]}
+                }
+            },
+            "meter_a": meter(-0.5),
+            "meter_b": meter(0.5),
+            "camera": {
+                "type": "perspective",
+                "fov": 60,
+                "to_world": ScalarTransform4f.look_at(origin=[0, 0, 1.5],
+                                                      target=[0, 0, 0],
+                                                      up=[0, 1, 0]),
+                "film": film(4),
+                "sampler": {"type": "independent", "sample_count": 1024}
+            }
+        })
+
+    def values(scene):
+        return [np.array(s.film().bitmap()).squeeze() for s in scene.sensors()]
+
+    scene = make_scene({"type": "ptracer", "sample_count": 2000000})
+    assert len(scene.sensors()) == 3
+    assert scene.integrator().render(scene, scene.sensors()[0])
+    result = values(scene)
+
+    reference = make_scene({"type": "path"})
+    for sensor in reference.sensors():
+        assert reference.integrator().render(reference, sensor)
+    expected = values(reference)
+
+    for value, ref in zip(result, expected):
+        assert np.all(ref > 0)
+        assert np.allclose(np.mean(value), np.mean(ref), rtol=5e-2)
+        assert np.allclose(value, ref, rtol=1e-1)
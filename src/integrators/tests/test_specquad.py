@@ -0,0 +1,92 @@
+import numpy as np
+import pytest
+
+import mitsuba
+
+
+def make_scene(spp, bins="a:400:500, b:500:600, c:600:700", rule="gauss_legendre"):
+    from mitsuba.core.xml import load_dict
+
+    return load_dict({
+        "type": "scene",
+        "sensor": {
+            "type": "radiancemeter",
+            "film": {
+                "type": "hdrfilm",
+                "height": 1,
+                "width": 1,
+                "rfilter": {"type": "box"}
+            },
+            "sampler": {"type": "independent", "sample_count": spp}
+        },
+        "emitter": {
+            "type": "constant",
+            "radiance": {
+                "type": "irregular",
+                "wavelengths": "400, 500, 600, 700",
+                "values": "0.2, 0.4, 0.6, 0.4"
+            }
+        },
+        "integrator": {
+            "type": "specquad",
+            "bins": bins,
+            "rule": rule,
+            "integrator": {"type": "path"}
+        }
+    })
+
+
+def test01_construct(variants_cpu_spectral):
+    scene = make_scene(3)
+    assert scene.integrator().aov_names() == ["a", "b", "c"]
+
+    with pytest.raises(RuntimeError):
+        make_scene(3, bins="a:500:400")
+    with pytest.raises(RuntimeError):
+        make_scene(3, bins="oh-no")
+    with pytest.raises(RuntimeError):
+        make_scene(3, rule="simpson")
+
+
+@pytest.mark.parametrize("rule", ["gauss_legendre", "gauss_lobatto"])
+def test02_bin_averages(variants_cpu_spectral, rule):
+    # The emitted spectrum is linear within each bin: the quadrature is exact
+    scene = make_scene(6, rule=rule)
+    sensor = scene.sensors()[0]
+    assert scene.integrator().render(scene, sensor)
+
+    img = np.array(sensor.film().bitmap(raw=True)).squeeze()
+    assert np.allclose(img[5:8] / img[4], [0.3, 0.5, 0.5], rtol=1e-4)
+
+    # Each pixel must receive the same number of samples in every bin
+    with pytest.raises(RuntimeError):
+        scene = make_scene(4)
+        scene.integrator().render(scene, scene.sensors()[0])
+
+
+@pytest.mark.parametrize("rule", ["gauss_legendre", "gauss_lobatto"])
+def test03_xyz(variants_cpu_spectral, rule):
+    from mitsuba.core import cie1931_xyz
+
+    # Narrow bins, so that the quadrature resolves the color matching functions
+    bins = ", ".join("b%i:%i:%i" % (i, 400 + 20 * i, 420 + 20 * i) for i in range(15))
+    scene = make_scene(15, bins=bins, rule=rule)
+    sensor = scene.sensors()[0]
+    assert scene.integrator().render(scene, sensor)
+    img = np.array(sensor.film().bitmap(raw=True)).squeeze()
+
+    # The integrand is piecewise quadratic between the 5 nm knots of the
+    # tabulated color matching functions, where Simpson's rule is exact
+    wavelengths = np.linspace(400, 700, 601)
+    radiance = np.interp(wavelengths, [400, 500, 600, 700], [0.2, 0.4, 0.6, 0.4])
+    xyz = np.array([cie1931_xyz(w) for w in wavelengths]) * radiance[:, None]
+    simpson = np.ones(601)
+    simpson[1:-1:2] = 4
+    simpson[2:-1:2] = 2
+    ref = simpson @ xyz * (0.5 / 3)
+
+    assert np.allclose(img[:3] / img[4], ref, rtol=1e-3)
+
+    # The bin channels follow the XYZ channels and cover the same range
+    assert len(img) == 5 + 15
+    assert np.allclose(np.sum(img[5:] / img[4]) * 20, 130, rtol=1e-4)
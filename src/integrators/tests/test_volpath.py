@@ -0,0 +1,259 @@
+import numpy as np
+import pytest
+
+import enoki as ek
+import mitsuba
+
+
+def make_lidar_scene(range_bins):
+    from mitsuba.core import ScalarTransform4f
+    from mitsuba.core.xml import load_dict
+
+    return load_dict({
+        "type": "scene",
+        "ground": {
+            "type": "rectangle",
+            "to_world": ScalarTransform4f.translate([0, 0, -5]) *
+                        ScalarTransform4f.scale(10),
+            "bsdf": {
+                "type": "diffuse",
+                "reflectance": {"type": "uniform", "value": 0.5}
+            }
+        },
+        "laser": {
+            "type": "point",
+            "position": [0, 0, 0],
+            "intensity": {"type": "uniform", "value": 1.0}
+        },
+        "integrator": {
+            "type": "volpath",
+            "max_depth": 2,
+            "range_bins": range_bins
+        }
+    })
+
+
+def test01_range_bins_construct(variant_scalar_rgb):
+    from mitsuba.core.xml import load_dict
+
+    scene = make_lidar_scene("0, 9, 11, 20")
+    assert scene.integrator().aov_names() == ["range_0", "range_1", "range_2"]
+
+    with pytest.raises(RuntimeError):
+        make_lidar_scene("0, 11, 9")
+
+    with pytest.raises(RuntimeError):
+        make_lidar_scene("1")
+
+
+def test02_range_bins_single_scattering(variant_scalar_rgb):
+    from mitsuba.core import RayDifferential3f
+
+    scene = make_lidar_scene("0, 9, 11, 20")
+    sampler = scene.sensors()[0].sampler()
+    sampler.seed(0)
+
+    # Single scattering: 5 units to the ground and 5 units back to the laser
+    ray = RayDifferential3f([0, 0, 0], [0, 0, -1], 0, [])
+    value, valid, aovs = scene.integrator().sample(scene, sampler, ray)
+
+    expected = 0.5 / ek.pi / 25.0
+    assert valid
+    assert ek.allclose(value, expected)
+    assert ek.allclose(aovs, [0, expected, 0])
+
+    # Longer path through an oblique direction ends up in the last bin
+    d = np.array([0.8, 0, -1]) / np.sqrt(1.64)
+    ray = RayDifferential3f([0, 0, 0], d, 0, [])
+    value, valid, aovs = scene.integrator().sample(scene, sampler, ray)
+    assert aovs[0] == 0 and aovs[1] == 0
+    assert ek.allclose(aovs[2], value[1])
+
+
+def test03_null_interfaces(variant_scalar_rgb):
+    from mitsuba.core import ScalarTransform4f, RayDifferential3f
+    from mitsuba.core.xml import load_dict
+
+    scene_dict = {
+        "type": "scene",
+        "ground": {
+            "type": "rectangle",
+            "to_world": ScalarTransform4f.translate([0, 0, -5]) *
+                        ScalarTransform4f.scale(10),
+            "bsdf": {
+                "type": "diffuse",
+                "reflectance": {"type": "uniform", "value": 0.5}
+            }
+        },
+        "laser": {
+            "type": "point",
+            "position": [0, 0, 0],
+            "intensity": {"type": "uniform", "value": 1.0}
+        },
+        "integrator": {
+            "type": "volpath",
+            "max_depth": 2,
+            "range_bins": "0, 9, 11, 20"
+        }
+    }
+
+    # Stack of index-matched (null) interfaces between the laser and the ground
+    for i in range(3):
+        scene_dict["interface_%i" % i] = {
+            "type": "rectangle",
+            "to_world": ScalarTransform4f.translate([0, 0, -1 - i]) *
+                        ScalarTransform4f.scale(10),
+            "bsdf": {"type": "null"}
+        }
+
+    scene = load_dict(scene_dict)
+    sampler = scene.sensors()[0].sampler()
+    sampler.seed(0)
+
+    # The interfaces neither attenuate the path nor count as bounces
+    ray = RayDifferential3f([0, 0, 0], [0, 0, -1], 0, [])
+    value, valid, aovs = scene.integrator().sample(scene, sampler, ray)
+
+    expected = 0.5 / ek.pi / 25.0
+    assert valid
+    assert ek.allclose(value, expected)
+    assert ek.allclose(aovs, [0, expected, 0])
+
+
+def make_camera_scene(objects, fov, max_depth, sample_count=64, **integrator):
+    """Scene holding the given objects, viewed by a 4x4 pixel camera placed
+    at (0, 0, 5) and looking at the origin"""
+    from mitsuba.core import ScalarTransform4f
+    from mitsuba.core.xml import load_dict
+
+    scene_dict = {
+        "type": "scene",
+        "sensor": {
+            "type": "perspective",
+            "fov": fov,
+            "to_world": ScalarTransform4f.look_at(origin=[0, 0, 5],
+                                                  target=[0, 0, 0],
+                                                  up=[0, 1, 0]),
+            "sampler": {"type": "independent", "sample_count": sample_count},
+            "film": {
+                "type": "hdrfilm",
+                "width": 4,
+                "height": 4,
+                "pixel_format": "rgb",
+                "rfilter": {"type": "box"}
+            }
+        },
+        "integrator": dict(type="volpath", max_depth=max_depth, **integrator)
+    }
+    scene_dict.update(objects)
+    return load_dict(scene_dict)
+
+
+def make_guiding_scene(**integrator):
+    from mitsuba.core import ScalarTransform4f
+
+    return make_camera_scene({
+        "ground": {
+            "type": "rectangle",
+            "to_world": ScalarTransform4f.scale(100),
+            "bsdf": {
+                "type": "diffuse",
+                "reflectance": {"type": "uniform", "value": 0.5}
+            }
+        },
+        "sky": {
+            "type": "constant",
+            "radiance": {"type": "uniform", "value": 1.0}
+        }
+    }, fov=10, max_depth=2, **integrator)
+
+
+def test04_guiding_construct(variant_scalar_rgb):
+    scene = make_guiding_scene(guiding=True, training_passes=3)
+    assert scene.integrator().synchronized_passes() == 3
+    assert make_guiding_scene().integrator().synchronized_passes() == 0
+
+    with pytest.raises(RuntimeError):
+        make_guiding_scene(guiding=True, bsdf_sampling_fraction=0.0)
+
+
+def test05_guiding_unbiased(variant_scalar_rgb):
+    # A diffuse plane under a uniform sky reflects a radiance of 0.5
+    scene = make_guiding_scene(guiding=True, samples_per_pass=8,
+                               training_passes=4, spatial_threshold=64)
+    sensor = scene.sensors()[0]
+    assert scene.integrator().render(scene, sensor)
+
+    img = np.array(sensor.film().bitmap())
+    assert np.allclose(np.mean(img), 0.5, rtol=2e-2)
+
+
+def make_furnace_scene(**integrator):
+    return make_camera_scene({
+        "furnace": {
+            "type": "sphere",
+            "radius": 10,
+            "flip_normals": True,
+            "bsdf": {
+                "type": "diffuse",
+                "reflectance": {"type": "uniform", "value": 0.5}
+            },
+            "emitter": {
+                "type": "area",
+                "radiance": {"type": "uniform", "value": 1.0}
+            }
+        }
+    }, fov=90, max_depth=5, **integrator)
+
+
+def test06_weight_window_construct(variant_scalar_rgb):
+    scene = make_furnace_scene(weight_window=True)
+    assert scene.integrator().synchronized_passes() == 1
+
+    for props in [dict(window_size=1.0), dict(window_resolution=0),
+                  dict(max_split=0)]:
+        with pytest.raises(RuntimeError):
+            make_furnace_scene(weight_window=True, **props)
+
+
+def test07_weight_window_unbiased(variants_cpu_rgb):
+    # The radiance inside the furnace is the sum of the first bounces
+    scene = make_furnace_scene(weight_window=True, samples_per_pass=16,
+                               window_resolution=4, window_size=1.5)
+    sensor = scene.sensors()[0]
+    assert scene.integrator().render(scene, sensor)
+
+    img = np.array(sensor.film().bitmap())
+    expected = sum(0.5 ** k for k in range(5))
+    assert np.allclose(np.mean(img), expected, rtol=2e-2)
+
+
+def test08_guiding_medium(variant_scalar_rgb):
+    def make_scene(**integrator):
+        return make_camera_scene({
+            "cloud": {
+                "type": "sphere",
+                "bsdf": {"type": "null"},
+                "interior": {
+                    "type": "homogeneous",
+                    "sigma_t": {"type": "uniform", "value": 2.0},
+                    "albedo": {"type": "uniform", "value": 0.8}
+                }
+            },
+            "sky": {
+                "type": "constant",
+                "radiance": {"type": "uniform", "value": 1.0}
+            }
+        }, fov=10, max_depth=16, sample_count=256, **integrator)
+
+    # Guided phase function sampling, and the recording of medium vertices
+    # and of emitter samples taken in the medium, leave the estimate unbiased
+    images = []
+    for integrator in [dict(), dict(guiding=True, samples_per_pass=32,
+                                    training_passes=4, spatial_threshold=256)]:
+        scene = make_scene(**integrator)
+        sensor = scene.sensors()[0]
+        assert scene.integrator().render(scene, sensor)
+        images.append(np.array(sensor.film().bitmap()))
+
+    assert np.allclose(np.mean(images[1]), np.mean(images[0]), rtol=5e-2)
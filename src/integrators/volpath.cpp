@@ -8,19 +8,217 @@
 #include <mitsuba/render/records.h>
 #include <mitsuba/render/medium.h>
 #include <mitsuba/render/phase.h>
+#include <mitsuba/render/scene.h>
+#include <mitsuba/render/sdtree.h>
 
 
 NAMESPACE_BEGIN(mitsuba)
 
+/**
+ * Volumetric path tracer with null-collision tracking
+ *
+ * In addition to the parameters of \c path, this integrator accepts
+ *
+ *  - \c range_bins (floats): increasing edges of path length bins. When set,
+ *    the contribution of every path is additionally accumulated into one AOV
+ *    channel per bin (\c range_0, \c range_1, ...) according to the
+ *    geometric length of the path between the sensor and the emitter, which
+ *    yields a time-of-flight histogram (e.g. a lidar waveform) from a single
+ *    render. The last segment towards emitters at infinity (environment
+ *    maps, directional emitters) does not count towards the length. Each
+ *    channel stores the luminance (Y) of the contributions.
+ *  - \c order_aovs (int): number of scattering orders \c K for which the
+ *    contribution is written to separate XYZ AOV channels (\c order_1.X,
+ *    ..., \c order_K.Z). Both surface and medium scattering events count
+ *    towards the order, while null interactions do not.
+ *  - \c guiding (bool): enables path guiding with a spatio-directional tree
+ *    (SD-tree) that learns the incident radiance in the scene, following
+ *    "Practical Path Guiding for Efficient Light-Transport Simulation" by
+ *    Müller et al. The tree is trained during the first passes (see
+ *    \c samples_per_pass), and is refined after each of them. Scattering
+ *    directions at non-specular surfaces and in media are then drawn either
+ *    from the BSDF or phase function, or from the tree, and weighted by the
+ *    density of the mixture (one-sample MIS). Only available in scalar
+ *    variants.
+ *  - \c training_passes (int): number of passes that train the SD-tree.
+ *    Every pass contributes to the image. (Default: 4)
+ *  - \c bsdf_sampling_fraction (float): probability of sampling the BSDF or
+ *    phase function instead of the SD-tree. (Default: 0.5)
+ *  - \c spatial_threshold (int): number of path vertices recorded in a
+ *    region of the SD-tree during a pass above which the region is split.
+ *    (Default: 12000)
+ *  - \c weight_window (bool): replaces the throughput-based Russian roulette
+ *    by adjoint-driven Russian roulette and splitting, following "Adjoint-
+ *    Driven Russian Roulette and Splitting in Light Transport Simulation" by
+ *    Vorba and Křivánek. The first pass is a pilot that estimates the
+ *    radiance reaching the camera from each cell of a regular grid over the
+ *    scene. Afterwards, the expected contribution of a path (its throughput
+ *    times the estimate at its last vertex) is compared to the mean pixel
+ *    value: paths below the window play Russian roulette, and paths above it
+ *    are split into several copies of lower weight. Copies are traced one
+ *    after the other, so that the lanes of packet variants are regenerated
+ *    instead of spawning new ones. Only available on the CPU.
+ *  - \c window_resolution (int): number of grid cells along each axis of
+ *    the scene bounding box. (Default: 16)
+ *  - \c window_size (float): ratio between the upper and the lower bound of
+ *    the weight window, which is centered on the mean pixel value.
+ *    (Default: 5)
+ *  - \c max_split (int): maximum number of copies of a split path.
+ *    (Default: 8)
+ *
+ * Surfaces with a purely null BSDF (e.g. boundaries between index-matched
+ * media) are traversed without ending the current bounce: the path moves on
+ * to the medium behind the interface and continues until the next real
+ * scattering event or non-null surface. Such crossings are not subject to
+ * Russian roulette and do not consume BSDF samples.
+ */
 template <typename Float, typename Spectrum>
 class VolumetricPathIntegrator : public MonteCarloIntegrator<Float, Spectrum> {
 
 public:
-    MTS_IMPORT_BASE(MonteCarloIntegrator, m_max_depth, m_rr_depth, m_hide_emitters)
-    MTS_IMPORT_TYPES(Scene, Sampler, Emitter, EmitterPtr, BSDF, BSDFPtr,
-                     Medium, MediumPtr, PhaseFunctionContext)
+    MTS_IMPORT_BASE(MonteCarloIntegrator, m_max_depth, m_rr_depth, m_hide_emitters,
+                    m_samples_per_pass, aov_xyz, accumulate_aov, accumulate_order,
+                    order_aov_names)
+    MTS_IMPORT_TYPES(Scene, Sensor, Sampler, Emitter, EmitterPtr, BSDF, BSDFPtr,
+                     Medium, MediumPtr, PhaseFunctionPtr, PhaseFunctionContext)
+    using FloatStorage    = DynamicBuffer<Float>;
+    using SDTree          = SpatialDirectionalTree<ScalarFloat>;
+    using DirectionalTree = typename SDTree::DirectionalTree;
+
+    /// Path vertex whose incident radiance estimate is recorded in the SD-tree
+    struct GuidingVertex {
+        DirectionalTree *dtree;
+        Vector3f d;
+        UnpolarizedSpectrum throughput, radiance;
+        Float pdf;
+    };
+
+    // Path guiding is only available in scalar variants
+    static constexpr size_t MaxGuidingVertices = is_array_v<Float> ? 1 : 64;
+
+    /// Path vertex whose outgoing radiance estimate is recorded by the pilot pass
+    struct PilotVertex {
+        UInt32 cell;
+        Float throughput, result;
+        Mask active;
+    };
+
+    // Weight windows are only available on the CPU
+    static constexpr size_t MaxPilotVertices = is_cuda_array_v<Float> ? 1 : 64;
 
     VolumetricPathIntegrator(const Properties &props) : Base(props) {
+        if (props.has_property("range_bins")) {
+            FloatArray bins = props.float_array("range_bins");
+            if (bins.size() < 2)
+                Throw("\"range_bins\" must specify at least two bin edges!");
+            for (size_t i = 0; i < bins.size(); ++i) {
+                if (i > 0 && !(bins[i] > bins[i - 1]))
+                    Throw("\"range_bins\" must be strictly increasing!");
+                m_range_bins.push_back((ScalarFloat) bins[i]);
+            }
+            m_range_bins_buf = FloatStorage::copy(m_range_bins.data(), m_range_bins.size());
+        }
+
+        m_order_aovs = props.size_("order_aovs", 0);
+
+        m_guiding = props.bool_("guiding", false);
+        m_training_passes = props.size_("training_passes", 4);
+        m_bsdf_sampling_fraction = props.float_("bsdf_sampling_fraction", .5f);
+        m_spatial_threshold = props.size_("spatial_threshold", 12000);
+        if (m_guiding && is_array_v<Float>)
+            Throw("Path guiding is only supported in scalar variants!");
+        if (!(m_bsdf_sampling_fraction > 0.f && m_bsdf_sampling_fraction <= 1.f))
+            Throw("\"bsdf_sampling_fraction\" must be in (0, 1]!");
+
+        m_weight_window = props.bool_("weight_window", false);
+        m_window_resolution = (uint32_t) props.size_("window_resolution", 16);
+        ScalarFloat window_size = props.float_("window_size", 5.f);
+        m_max_split = (uint32_t) props.size_("max_split", 8);
+        if (m_weight_window && is_cuda_array_v<Float>)
+            Throw("Weight windows are only supported on the CPU!");
+        if (m_window_resolution == 0)
+            Throw("\"window_resolution\" must be positive!");
+        if (!(window_size > 1.f))
+            Throw("\"window_size\" must be greater than 1!");
+        if (m_max_split == 0)
+            Throw("\"max_split\" must be positive!");
+        m_window_lower = 2.f / (1.f + window_size);
+        m_window_upper = window_size * m_window_lower;
+    }
+
+    bool render(Scene *scene, Sensor *sensor) override {
+        if (m_guiding) {
+            m_sdtree.reset(new SDTree(scene->bbox()));
+            m_recording = m_training_passes > 0;
+        }
+
+        if (m_weight_window) {
+            ScalarBoundingBox3f bbox = scene->bbox();
+            ScalarVector3f extents = max(bbox.extents(), 1e-4f * hmax(bbox.extents()));
+            m_window_origin = bbox.min;
+            m_window_scale  = ScalarFloat(m_window_resolution) / extents;
+
+            size_t cell_count = (size_t) m_window_resolution * m_window_resolution *
+                                m_window_resolution;
+            m_window_pilot.reset(new WindowPilot(cell_count));
+            m_window_estimate = FloatStorage();
+            m_window_recording = true;
+        }
+
+        if ((m_guiding || m_weight_window) &&
+            m_samples_per_pass >= sensor->sampler()->sample_count())
+            Log(Warn, "Path guiding and weight windows learn from previous "
+                      "passes, but all samples are rendered in a single pass. "
+                      "Set \"samples_per_pass\" to train them.");
+
+        return Base::render(scene, sensor);
+    }
+
+    size_t synchronized_passes() const override {
+        return std::max(m_guiding ? m_training_passes : 0,
+                        m_weight_window ? (size_t) 1 : 0);
+    }
+
+    void pass_completed(size_t pass) override {
+        if (m_window_recording)
+            build_window_estimate();
+
+        if (!m_sdtree || !m_recording)
+            return;
+        m_sdtree->refine(m_spatial_threshold, GuidingSubdivisionThreshold,
+                         GuidingMaxDepth);
+        m_recording = pass + 1 < m_training_passes;
+        Log(Debug, "Path guiding: SD-tree has %i regions after pass %i.",
+            m_sdtree->region_count(), pass + 1);
+    }
+
+    /// Turn the sums recorded by the pilot pass into the grid of adjoint estimates
+    void build_window_estimate() {
+        m_window_recording = false;
+
+        WindowPilot &pilot = *m_window_pilot;
+        ScalarFloat pixel_mean = pilot.path_count > 0
+            ? (ScalarFloat) pilot.pixel_sum / (ScalarFloat) pilot.path_count : 0.f;
+        if (!(pixel_mean > 0.f)) {
+            Log(Warn, "The pilot pass did not record any radiance, disabling "
+                      "weight windows.");
+            return;
+        }
+
+        /* Store the estimates relative to the mean pixel value, so that the
+           product with the path throughput directly locates the path in the
+           window. Empty cells are marked with zero (unknown). */
+        std::unique_ptr<ScalarFloat[]> estimate(new ScalarFloat[pilot.cell_count]);
+        size_t known = 0;
+        for (size_t i = 0; i < pilot.cell_count; ++i) {
+            ScalarFloat count = pilot.counts[i];
+            estimate[i] = count > 0.f ? pilot.sums[i] / (count * pixel_mean) : 0.f;
+            known += estimate[i] > 0.f;
+        }
+        m_window_estimate = FloatStorage::copy(estimate.get(), pilot.cell_count);
+
+        Log(Debug, "Weight windows: %i of %i grid cells have an adjoint estimate.",
+            known, pilot.cell_count);
     }
 
     MTS_INLINE
@@ -39,10 +237,22 @@ public:
                                      Sampler *sampler,
                                      const RayDifferential3f &ray_,
                                      const Medium *initial_medium,
-                                     Float * /* aovs */,
+                                     Float *aovs,
                                      Mask active) const override {
         MTS_MASKED_FUNCTION(ProfilerPhase::SamplingIntegratorSample, active);
 
+        Float *range_aovs = m_range_bins.empty() ? nullptr : aovs;
+        if (range_aovs)
+            for (size_t i = 0; i + 1 < m_range_bins.size(); ++i)
+                range_aovs[i] = 0.f;
+
+        Float *order_aovs = nullptr;
+        if (aovs && m_order_aovs > 0) {
+            order_aovs = aovs + (m_range_bins.empty() ? 0 : m_range_bins.size() - 1);
+            for (size_t i = 0; i < 3 * m_order_aovs; ++i)
+                order_aovs[i] = 0.f;
+        }
+
         // If there is an environment emitter and emitters are visible: all rays will be valid
         // Otherwise, it will depend on whether a valid interaction is sampled
         Mask valid_ray = !m_hide_emitters && neq(scene->environment(), nullptr);
@@ -60,6 +270,21 @@ public:
         Mask specular_chain = active && !m_hide_emitters;
         UInt32 depth = 0;
 
+        // Geometric length of the path up to the current vertex
+        Float path_length = 0.f;
+
+        // Vertices whose incident radiance estimates train the SD-tree
+        GuidingVertex guiding_vertices[MaxGuidingVertices];
+        size_t guiding_vertex_count = 0;
+
+        // Vertices whose outgoing radiance estimates train the weight window
+        PilotVertex pilot_vertices[MaxPilotVertices];
+        size_t pilot_vertex_count = 0;
+        Mask primary = active;
+
+        bool use_window = m_weight_window && !m_window_recording &&
+                          m_window_estimate.size() > 0;
+
         UInt32 channel = 0;
         if (is_rgb_v<Spectrum>) {
             uint32_t n_channels = (uint32_t) array_size_v<Spectrum>;
@@ -69,6 +294,18 @@ public:
         SurfaceInteraction3f si = zero<SurfaceInteraction3f>();
         si.t = math::Infinity<Float>;
         Mask needs_intersection = true;
+
+        /* Path state at the last splitting vertex, which is restored to trace
+           the remaining copies once the current one has terminated */
+        UInt32 split_count = 0;
+        Ray3f split_ray;
+        Spectrum split_throughput;
+        Float split_eta, split_path_length;
+        MediumPtr split_medium;
+        SurfaceInteraction3f split_si;
+        Mask split_needs_intersection, split_specular_chain;
+        UInt32 split_depth;
+
         for (int bounce = 0;; ++bounce) {
             // ----------------- Handle termination of paths ------------------
 
@@ -79,58 +316,188 @@ public:
             active &= any(neq(depolarize(throughput), 0.f));
             Float q = min(hmax(depolarize(throughput)) * sqr(eta), .95f);
             Mask perform_rr = (depth > (uint32_t) m_rr_depth);
+
+            /* Weight window: the throughput times the adjoint estimate at the
+               path vertex predicts the contribution of the path, relative to
+               the mean pixel value. Below the window, the path survives
+               Russian roulette with a probability that brings it back to the
+               center of the window; above the window, it is split. Vertices
+               in cells without an estimate use the default roulette. */
+            Float window_ratio = 0.f;
+            Mask window_known = false;
+            if (use_window) {
+                Mask window_active = active && depth > 0;
+                window_ratio = hmean(depolarize(throughput)) *
+                               gather<Float>(m_window_estimate, window_cell(ray.o),
+                                             window_active);
+                window_known = window_active && window_ratio > 0.f;
+                masked(perform_rr, window_known) = window_ratio < m_window_lower;
+                masked(q, window_known) = max(window_ratio, WindowMinSurvival);
+            }
+
             active &= sampler->next_1d(active) < q || !perform_rr;
             masked(throughput, perform_rr) *= rcp(detach(q));
 
+            if (use_window) {
+                /* Only one splitting vertex per path is stored, so a copy
+                   is not split again while other copies are pending. The
+                   last copy starts with no pending copies and may split
+                   again at a later vertex, which then replaces the stored
+                   one. Splitting is also disabled while the SD-tree records
+                   paths. */
+                Mask split = window_known && active && window_ratio > m_window_upper &&
+                             eq(split_count, 0u) && !m_recording;
+                UInt32 copies = min(UInt32(window_ratio), m_max_split);
+                split &= copies > 1u;
+                if (any_or<true>(split)) {
+                    masked(throughput, split) /= Float(copies);
+                    masked(split_count, split) = copies - 1u;
+                    masked(split_ray, split) = ray;
+                    masked(split_throughput, split) = throughput;
+                    masked(split_eta, split) = eta;
+                    masked(split_path_length, split) = path_length;
+                    masked(split_medium, split) = medium;
+                    masked(split_si, split) = si;
+                    masked(split_needs_intersection, split) = needs_intersection;
+                    masked(split_specular_chain, split) = specular_chain;
+                    masked(split_depth, split) = depth;
+                }
+
+                // Regenerate terminated paths with the next copy
+                Mask regenerate = !active && split_count > 0u;
+                if (any_or<true>(regenerate)) {
+                    masked(split_count, regenerate) -= 1u;
+                    masked(ray, regenerate) = split_ray;
+                    masked(throughput, regenerate) = split_throughput;
+                    masked(eta, regenerate) = split_eta;
+                    masked(path_length, regenerate) = split_path_length;
+                    masked(medium, regenerate) = split_medium;
+                    masked(si, regenerate) = split_si;
+                    masked(needs_intersection, regenerate) = split_needs_intersection;
+                    masked(specular_chain, regenerate) = split_specular_chain;
+                    masked(depth, regenerate) = split_depth;
+                    active |= regenerate;
+                }
+            }
+
             Mask exceeded_max_depth = depth >= (uint32_t) m_max_depth;
             if (none(active) || all(exceeded_max_depth))
                 break;
 
+            if (m_window_recording && bounce < (int) MaxPilotVertices) {
+                pilot_vertices[pilot_vertex_count++] = {
+                    window_cell(ray.o), hmean(depolarize(throughput)),
+                    hmean(depolarize(result)), active && depth > 0
+                };
+            }
+
             // ----------------------- Sampling the RTE -----------------------
-            Mask active_medium  = active && neq(medium, nullptr);
-            Mask active_surface = active && !active_medium;
-            Mask act_null_scatter = false, act_medium_scatter = false,
-                 escaped_medium = false;
+            Mask active_medium = false, active_surface = false,
+                 act_null_scatter = false, act_medium_scatter = false;
 
             // If the medium does not have a spectrally varying extinction,
             // we can perform a few optimizations to speed up rendering
-            Mask is_spectral = active_medium;
-            Mask not_spectral = false;
-            if (any_or<true>(active_medium)) {
-                is_spectral &= medium->has_spectral_extinction();
-                not_spectral = !is_spectral && active_medium;
-            }
-
-            if (any_or<true>(active_medium)) {
-                mi = medium->sample_interaction(ray, sampler->next_1d(active_medium), channel, active_medium);
-                masked(ray.maxt, active_medium && medium->is_homogeneous() && mi.is_valid()) = mi.t;
-                Mask intersect = needs_intersection && active_medium;
-                if (any_or<true>(intersect))
-                    masked(si, intersect) = scene->ray_intersect(ray, intersect);
-                needs_intersection &= !active_medium;
-
-                masked(mi.t, active_medium && (si.t < mi.t)) = math::Infinity<Float>;
-                if (any_or<true>(is_spectral)) {
-                    auto [tr, free_flight_pdf] = medium->eval_tr_and_pdf(mi, si, is_spectral);
-                    Float tr_pdf = index_spectrum(free_flight_pdf, channel);
-                    masked(throughput, is_spectral) *= select(tr_pdf > 0.f, tr / tr_pdf, 0.f);
+            Mask is_spectral = false, not_spectral = false;
+
+            /* Boundaries with a purely null BSDF (e.g. the interface between
+               two index-matched media) don't scatter: they are crossed right
+               away, and medium sampling resumes on the other side. Each
+               iteration of the path loop thus ends at a real scattering event
+               and does not spend Russian roulette and BSDF sampling on the
+               traversed medium segments. */
+            Mask traverse = active;
+            while (true) {
+                Mask pass_medium  = traverse && neq(medium, nullptr);
+                Mask pass_surface = traverse && !pass_medium;
+
+                if (any_or<true>(pass_medium)) {
+                    Mask pass_spectral = pass_medium && medium->has_spectral_extinction();
+                    masked(is_spectral, pass_medium)  = pass_spectral;
+                    masked(not_spectral, pass_medium) = !pass_spectral;
+
+                    masked(mi, pass_medium) = medium->sample_interaction(
+                        ray, sampler->next_1d(pass_medium), channel, pass_medium);
+                    masked(ray.maxt, pass_medium && medium->is_homogeneous() && mi.is_valid()) = mi.t;
+                    Mask intersect = needs_intersection && pass_medium;
+                    if (any_or<true>(intersect))
+                        masked(si, intersect) = scene->ray_intersect(ray, scene->hit_compute_flags(), intersect);
+                    needs_intersection &= !pass_medium;
+
+                    masked(mi.t, pass_medium && (si.t < mi.t)) = math::Infinity<Float>;
+                    if (any_or<true>(pass_spectral)) {
+                        auto [tr, free_flight_pdf] = medium->eval_tr_and_pdf(mi, si, pass_spectral);
+                        Float tr_pdf = index_spectrum(free_flight_pdf, channel);
+                        masked(throughput, pass_spectral) *= select(tr_pdf > 0.f, tr / tr_pdf, 0.f);
+                    }
+
+                    pass_surface |= pass_medium && !mi.is_valid();
+                    pass_medium &= mi.is_valid();
+
+                    // Handle null and real scatter events
+                    Mask null_scatter = sampler->next_1d(pass_medium) >= index_spectrum(mi.sigma_t, channel) / index_spectrum(mi.combined_extinction, channel);
+                    Mask pass_null_scatter   = null_scatter && pass_medium,
+                         pass_medium_scatter = !null_scatter && pass_medium;
+                    act_null_scatter   |= pass_null_scatter;
+                    act_medium_scatter |= pass_medium_scatter;
+
+                    if (any_or<true>(pass_spectral && pass_null_scatter))
+                        masked(throughput, pass_spectral && pass_null_scatter) *=
+                            mi.sigma_n * index_spectrum(mi.combined_extinction, channel) /
+                            index_spectrum(mi.sigma_n, channel);
+
+                    masked(depth, pass_medium_scatter) += 1;
+                    masked(path_length, pass_medium) += mi.t;
+                    active_medium |= pass_medium;
                 }
 
-                escaped_medium = active_medium && !mi.is_valid();
-                active_medium &= mi.is_valid();
+                // --------------------- Surface Interactions ---------------------
+                Mask intersect = pass_surface && needs_intersection;
+                if (any_or<true>(intersect))
+                    masked(si, intersect) = scene->ray_intersect(ray, scene->hit_compute_flags(), intersect);
 
-                // Handle null and real scatter events
-                Mask null_scatter = sampler->next_1d(active_medium) >= index_spectrum(mi.sigma_t, channel) / index_spectrum(mi.combined_extinction, channel);
+                if (none_or<false>(pass_surface))
+                    break;
 
-                act_null_scatter |= null_scatter && active_medium;
-                act_medium_scatter |= !act_null_scatter && active_medium;
+                // ---------------- Intersection with emitters ----------------
+                EmitterPtr emitter = si.emitter(scene);
+                Mask use_emitter_contribution =
+                    pass_surface && specular_chain && neq(emitter, nullptr);
+                if (any_or<true>(use_emitter_contribution)) {
+                    Spectrum contrib = throughput * emitter->eval(si, use_emitter_contribution);
+                    masked(result, use_emitter_contribution) += contrib;
+                    add_guiding_radiance(guiding_vertices, guiding_vertex_count, contrib,
+                                         use_emitter_contribution);
+                    record_range(range_aovs, path_length + select(si.is_valid(), si.t, 0.f),
+                                 contrib, ray_.wavelengths, use_emitter_contribution);
+                    accumulate_order(order_aovs, m_order_aovs, depth, contrib,
+                                     ray_.wavelengths, use_emitter_contribution);
+                }
 
-                if (any_or<true>(is_spectral && act_null_scatter))
-                    masked(throughput, is_spectral && act_null_scatter) *=
-                        mi.sigma_n * index_spectrum(mi.combined_extinction, channel) /
-                        index_spectrum(mi.sigma_n, channel);
+                // ---------------- Crossing of null interfaces ---------------
+                Mask cross = pass_surface && si.is_valid();
+                if (any_or<true>(cross)) {
+                    BSDFPtr bsdf = si.bsdf(ray);
+                    cross &= eq(bsdf->flags() & (uint32_t) BSDFFlags::All,
+                                (uint32_t) BSDFFlags::Null);
+
+                    if (any_or<true>(cross)) {
+                        Spectrum bsdf_val = bsdf->eval_null_transmission(si, cross);
+                        bsdf_val = si.to_world_mueller(bsdf_val, si.wi, si.wi);
+                        masked(throughput, cross) *= bsdf_val;
+                        masked(path_length, cross) += si.t;
+
+                        Mask has_medium_trans            = cross && si.is_medium_transition();
+                        masked(medium, has_medium_trans) = si.target_medium(ray.d);
+
+                        masked(ray, cross) = si.spawn_ray(ray.d);
+                        needs_intersection |= cross;
+                    }
+                }
 
-                masked(depth, act_medium_scatter) += 1;
+                active_surface |= pass_surface && !cross;
+                traverse = cross && any(neq(depolarize(throughput), 0.f));
+                if (none_or<false>(traverse))
+                    break;
             }
 
             // Dont estimate lighting if we exceeded number of bounces
@@ -152,6 +519,7 @@ public:
 
                 PhaseFunctionContext phase_ctx(sampler);
                 auto phase = mi.medium->phase_function();
+                auto [dtree, guiding_fraction] = guiding_lookup(mi.p);
 
                 // --------------------- Emitter sampling ---------------------
                 Mask sample_emitters = mi.medium->use_emitter_sampling();
@@ -163,40 +531,50 @@ public:
                 if (any_or<true>(active_e)) {
                     auto [emitted, ds] = sample_emitter(mi, true, scene, sampler, medium, channel, active_e);
                     Float phase_val = phase->eval(phase_ctx, mi, ds.d, active_e);
-                    masked(result, active_e) += throughput * phase_val * emitted;
+                    Spectrum contrib = throughput * phase_val * emitted;
+                    masked(result, active_e) += contrib;
+                    add_guiding_radiance(guiding_vertices, guiding_vertex_count, contrib, active_e);
+                    if constexpr (!is_array_v<Float>) {
+                        if (m_recording && dtree && !ds.delta)
+                            dtree->record(ds.d, hmean(depolarize(emitted)));
+                    }
+                    record_range(range_aovs, path_length + emitter_distance(ds, active_e),
+                                 contrib, ray_.wavelengths, active_e);
+                    accumulate_order(order_aovs, m_order_aovs, depth, contrib,
+                                     ray_.wavelengths, active_e);
                 }
 
                 // ------------------ Phase function sampling -----------------
                 masked(phase, !act_medium_scatter) = nullptr;
-                auto [wo, phase_pdf] = phase->sample(phase_ctx, mi, sampler->next_2d(act_medium_scatter), act_medium_scatter);
+                auto [wo, phase_weight, phase_pdf] =
+                    sample_phase(phase_ctx, mi, phase, dtree, guiding_fraction, sampler,
+                                 act_medium_scatter);
+                masked(throughput, act_medium_scatter) *= phase_weight;
+                if constexpr (!is_array_v<Float>) {
+                    if (m_recording && dtree && guiding_vertex_count < MaxGuidingVertices)
+                        guiding_vertices[guiding_vertex_count++] = {
+                            dtree, wo, depolarize(throughput), 0.f, phase_pdf
+                        };
+                }
                 Ray3f new_ray  = mi.spawn_ray(wo);
                 new_ray.mint = 0.0f;
                 masked(ray, act_medium_scatter) = new_ray;
                 needs_intersection |= act_medium_scatter;
             }
 
-            // --------------------- Surface Interactions ---------------------
-            active_surface |= escaped_medium;
-            Mask intersect = active_surface && needs_intersection;
-            if (any_or<true>(intersect))
-                masked(si, intersect) = scene->ray_intersect(ray, intersect);
-
-            if (any_or<true>(active_surface)) {
-                // ---------------- Intersection with emitters ----------------
-                EmitterPtr emitter = si.emitter(scene);
-                Mask use_emitter_contribution =
-                    active_surface && specular_chain && neq(emitter, nullptr);
-                if (any_or<true>(use_emitter_contribution))
-                    masked(result, use_emitter_contribution) +=
-                        throughput * emitter->eval(si, use_emitter_contribution);
-            }
             active_surface &= si.is_valid();
+            masked(path_length, active_surface) += si.t;
             if (any_or<true>(active_surface)) {
                 // --------------------- Emitter sampling ---------------------
                 BSDFContext ctx;
                 BSDFPtr bsdf  = si.bsdf(ray);
                 Mask active_e = active_surface && has_flag(bsdf->flags(), BSDFFlags::Smooth) && (depth + 1 < (uint32_t) m_max_depth);
 
+                DirectionalTree *dtree = nullptr;
+                ScalarFloat guiding_fraction = 0.f;
+                if (any_or<false>(active_surface && has_flag(bsdf->flags(), BSDFFlags::Smooth)))
+                    std::tie(dtree, guiding_fraction) = guiding_lookup(si.p);
+
                 if (likely(any_or<true>(active_e))) {
                     auto [emitted, ds] = sample_emitter(si, false, scene, sampler, medium, channel, active_e);
 
@@ -208,17 +586,42 @@ public:
                     // Determine probability of having sampled that same
                     // direction using BSDF sampling.
                     Float bsdf_pdf = bsdf->pdf(ctx, si, wo, active_e);
-                    result[active_e] += throughput * bsdf_val * mis_weight(ds.pdf, select(ds.delta, 0.f, bsdf_pdf)) * emitted;
+                    if constexpr (!is_array_v<Float>) {
+                        // Density of the mixture with the SD-tree
+                        if (guiding_fraction > 0.f)
+                            bsdf_pdf = (1.f - guiding_fraction) * bsdf_pdf +
+                                       guiding_fraction * dtree->pdf(ds.d);
+                    }
+                    Float weight = mis_weight(ds.pdf, select(ds.delta, 0.f, bsdf_pdf));
+                    Spectrum contrib = throughput * bsdf_val * weight * emitted;
+                    result[active_e] += contrib;
+                    add_guiding_radiance(guiding_vertices, guiding_vertex_count, contrib, active_e);
+                    if constexpr (!is_array_v<Float>) {
+                        if (m_recording && dtree && active_e && !ds.delta)
+                            dtree->record(ds.d, hmean(depolarize(emitted)) * weight);
+                    }
+                    record_range(range_aovs, path_length + emitter_distance(ds, active_e),
+                                 contrib, ray_.wavelengths, active_e);
+                    accumulate_order(order_aovs, m_order_aovs, depth + 1, contrib,
+                                     ray_.wavelengths, active_e);
                 }
 
                 // ----------------------- BSDF sampling ----------------------
-                auto [bs, bsdf_val] = bsdf->sample(ctx, si, sampler->next_1d(active_surface),
-                                                   sampler->next_2d(active_surface), active_surface);
+                auto [bs, bsdf_val] = sample_bsdf(ctx, si, bsdf, dtree, guiding_fraction,
+                                                  sampler, active_surface);
                 bsdf_val = si.to_world_mueller(bsdf_val, -bs.wo, si.wi);
 
                 masked(throughput, active_surface) *= bsdf_val;
                 masked(eta, active_surface) *= bs.eta;
 
+                if constexpr (!is_array_v<Float>) {
+                    if (m_recording && dtree && !has_flag(bs.sampled_type, BSDFFlags::Delta) &&
+                        guiding_vertex_count < MaxGuidingVertices)
+                        guiding_vertices[guiding_vertex_count++] = {
+                            dtree, si.to_world(bs.wo), depolarize(throughput), 0.f, bs.pdf
+                        };
+                }
+
                 Ray bsdf_ray                = si.spawn_ray(si.to_world(bs.wo));
                 masked(ray, active_surface) = bsdf_ray;
                 needs_intersection |= active_surface;
@@ -238,13 +641,20 @@ public:
                 Mask intersect2 = active_surface && needs_intersection && add_emitter;
                 SurfaceInteraction3f si_new = si;
                 if (any_or<true>(intersect2))
-                    masked(si_new, intersect2) = scene->ray_intersect(ray, intersect2);
+                    masked(si_new, intersect2) = scene->ray_intersect(ray, scene->hit_compute_flags(), intersect2);
                 needs_intersection &= !intersect2;
 
-                auto [emitted, emitter_pdf] = evaluate_direct_light(si, scene, sampler,
-                                                                    medium, ray, si_new, channel, add_emitter);
-                result += select(add_emitter && neq(emitter_pdf, 0),
-                                mis_weight(bs.pdf, emitter_pdf) * throughput * emitted, 0.0f);
+                auto [emitted, emitter_pdf, emitter_dist] = evaluate_direct_light(
+                    si, scene, sampler, medium, ray, si_new, channel, add_emitter);
+                Mask add_contrib = add_emitter && neq(emitter_pdf, 0);
+                Spectrum contrib = select(add_contrib,
+                                          mis_weight(bs.pdf, emitter_pdf) * throughput * emitted, 0.0f);
+                result += contrib;
+                add_guiding_radiance(guiding_vertices, guiding_vertex_count, contrib, add_contrib);
+                record_range(range_aovs, path_length + emitter_dist, contrib,
+                             ray_.wavelengths, add_contrib);
+                accumulate_order(order_aovs, m_order_aovs, depth, contrib,
+                                 ray_.wavelengths, add_contrib);
 
                 Mask has_medium_trans            = active_surface && si.is_medium_transition();
                 masked(medium, has_medium_trans) = si.target_medium(ray.d);
@@ -253,9 +663,178 @@ public:
             }
             active &= (active_surface | active_medium);
         }
+
+        // Train the weight window with the outgoing radiance estimates of the path
+        if (m_window_recording) {
+            Float total = hmean(depolarize(result));
+            for (size_t i = 0; i < pilot_vertex_count; ++i) {
+                const PilotVertex &v = pilot_vertices[i];
+                Mask valid = v.active && v.throughput > 0.f;
+                record_window(v.cell, select(valid, (total - v.result) / v.throughput, 0.f),
+                              valid);
+            }
+            record_window(UInt32(m_window_pilot->cell_count), total, primary);
+        }
+
+        // Train the SD-tree with the incident radiance estimates of the path
+        if constexpr (!is_array_v<Float>) {
+            for (size_t i = 0; i < guiding_vertex_count; ++i) {
+                const GuidingVertex &v = guiding_vertices[i];
+                if (v.pdf > 0.f)
+                    v.dtree->record(v.d, hmean(v.radiance) / v.pdf);
+                v.dtree->add_sample();
+            }
+        }
+
         return { result, valid_ray };
     }
 
+    /// Index of the weight window grid cell that contains \c p
+    UInt32 window_cell(const Point3f &p) const {
+        Point3i idx = floor2int<Point3i>((p - m_window_origin) * m_window_scale);
+        idx = clamp(idx, 0, (int32_t) m_window_resolution - 1);
+        return UInt32(idx.x() + (int32_t) m_window_resolution *
+                                    (idx.y() + (int32_t) m_window_resolution * idx.z()));
+    }
+
+    /**
+     * Add an outgoing radiance estimate to a cell of the weight window pilot.
+     * The index one past the last cell accumulates the pixel estimates.
+     */
+    void record_window(const UInt32 &cell, const Float &value, const Mask &active) const {
+        WindowPilot &pilot = *m_window_pilot;
+        auto record = [&](uint32_t cell_, ScalarFloat value_) {
+            if (cell_ == pilot.cell_count) {
+                pilot.pixel_sum += value_;
+                pilot.path_count++;
+            } else {
+                pilot.sums[cell_] += value_;
+                pilot.counts[cell_] += 1.f;
+            }
+        };
+
+        if constexpr (is_cuda_array_v<Float>) {
+            ENOKI_MARK_USED(cell);
+            ENOKI_MARK_USED(value);
+            ENOKI_MARK_USED(active);
+            ENOKI_MARK_USED(record);
+        } else if constexpr (is_array_v<Float>) {
+            for (size_t i = 0; i < array_size_v<Float>; ++i)
+                if (active.coeff(i))
+                    record(cell.coeff(i), value.coeff(i));
+        } else {
+            if (active)
+                record(cell, value);
+        }
+    }
+
+    /// Look up the SD-tree region of \c p and the probability of sampling its distribution
+    std::pair<DirectionalTree *, ScalarFloat> guiding_lookup(const Point3f &p) const {
+        if constexpr (!is_array_v<Float>) {
+            if (m_sdtree) {
+                DirectionalTree *dtree = m_sdtree->lookup(p);
+                return { dtree, dtree->is_trained() ? 1.f - m_bsdf_sampling_fraction : 0.f };
+            }
+        } else {
+            ENOKI_MARK_USED(p);
+        }
+        return { nullptr, 0.f };
+    }
+
+    /// Add a contribution to the radiance estimates of the guiding vertices
+    void add_guiding_radiance(GuidingVertex *vertices, size_t count,
+                              const Spectrum &contrib, Mask active) const {
+        for (size_t i = 0; i < count; ++i) {
+            UnpolarizedSpectrum throughput = vertices[i].throughput;
+            masked(vertices[i].radiance, active) +=
+                select(neq(throughput, 0.f), depolarize(contrib) / throughput, 0.f);
+        }
+    }
+
+    /**
+     * Sample the BSDF or, with probability \c guiding_fraction, the SD-tree,
+     * and return the weight with respect to the density of the mixture
+     */
+    std::pair<BSDFSample3f, Spectrum>
+    sample_bsdf(const BSDFContext &ctx, const SurfaceInteraction3f &si,
+                const BSDFPtr &bsdf, const DirectionalTree *dtree,
+                ScalarFloat guiding_fraction, Sampler *sampler, Mask active) const {
+        if constexpr (!is_array_v<Float>) {
+            if (guiding_fraction > 0.f) {
+                ScalarFloat bsdf_fraction = 1.f - guiding_fraction;
+                if (sampler->next_1d() < guiding_fraction) {
+                    auto [d, guide_pdf] = dtree->sample(sampler->next_2d());
+                    BSDFSample3f bs = zero<BSDFSample3f>();
+                    bs.wo  = si.to_local(d);
+                    bs.pdf = guiding_fraction * guide_pdf +
+                             bsdf_fraction * bsdf->pdf(ctx, si, bs.wo);
+                    /* Report the smooth lobe of the BSDF on the side of the
+                       guided direction. The relative index of refraction of
+                       a transmitted direction is not exposed by the BSDF
+                       interface and is left at 1: it only enters the Russian
+                       roulette heuristic, which stays unbiased. */
+                    bool reflection =
+                        Frame3f::cos_theta(bs.wo) * Frame3f::cos_theta(si.wi) > 0.f;
+                    BSDFFlags diffuse = reflection ? BSDFFlags::DiffuseReflection
+                                                   : BSDFFlags::DiffuseTransmission,
+                              glossy  = reflection ? BSDFFlags::GlossyReflection
+                                                   : BSDFFlags::GlossyTransmission;
+                    bs.eta = 1.f;
+                    bs.sampled_type = has_flag(bsdf->flags(), glossy) ? +glossy : +diffuse;
+                    Spectrum value = bsdf->eval(ctx, si, bs.wo);
+                    return { bs, bs.pdf > 0.f ? value / bs.pdf : zero<Spectrum>() };
+                }
+
+                auto [bs, value] = bsdf->sample(ctx, si, sampler->next_1d(),
+                                                sampler->next_2d());
+                if (has_flag(bs.sampled_type, BSDFFlags::Delta)) {
+                    // The SD-tree can't sample specular directions
+                    value /= bsdf_fraction;
+                } else {
+                    Float bsdf_pdf = bs.pdf;
+                    bs.pdf = bsdf_fraction * bsdf_pdf +
+                             guiding_fraction * dtree->pdf(si.to_world(bs.wo));
+                    value *= bs.pdf > 0.f ? bsdf_pdf / bs.pdf : 0.f;
+                }
+                return { bs, value };
+            }
+        } else {
+            ENOKI_MARK_USED(dtree);
+            ENOKI_MARK_USED(guiding_fraction);
+        }
+        return bsdf->sample(ctx, si, sampler->next_1d(active), sampler->next_2d(active), active);
+    }
+
+    /**
+     * Sample the phase function or, with probability \c guiding_fraction, the
+     * SD-tree. Returns the direction, its weight and the density of the mixture.
+     */
+    std::tuple<Vector3f, Float, Float>
+    sample_phase(const PhaseFunctionContext &ctx, const MediumInteraction3f &mi,
+                 const PhaseFunctionPtr &phase, const DirectionalTree *dtree,
+                 ScalarFloat guiding_fraction, Sampler *sampler, Mask active) const {
+        if constexpr (!is_array_v<Float>) {
+            if (guiding_fraction > 0.f) {
+                Vector3f wo;
+                if (sampler->next_1d() < guiding_fraction)
+                    wo = dtree->sample(sampler->next_2d()).first;
+                else
+                    wo = phase->sample(ctx, mi, sampler->next_2d()).first;
+
+                // Phase functions are sampled exactly: their value is their density
+                Float phase_pdf = phase->eval(ctx, mi, wo),
+                      pdf = guiding_fraction * dtree->pdf(wo) +
+                            (1.f - guiding_fraction) * phase_pdf;
+                return { wo, pdf > 0.f ? phase_pdf / pdf : 0.f, pdf };
+            }
+        } else {
+            ENOKI_MARK_USED(dtree);
+            ENOKI_MARK_USED(guiding_fraction);
+        }
+        auto [wo, pdf] = phase->sample(ctx, mi, sampler->next_2d(active), active);
+        return { wo, 1.f, pdf };
+    }
+
 
     /// Samples an emitter in the scene and evaluates it's attenuated contribution
     std::tuple<Spectrum, DirectionSample3f>
@@ -295,7 +874,7 @@ public:
                 masked(ray.maxt, active_medium && medium->is_homogeneous() && mi.is_valid()) = min(mi.t, remaining_dist);
                 Mask intersect = needs_intersection && active_medium;
                 if (any_or<true>(intersect))
-                    masked(si, intersect) = scene->ray_intersect(ray, intersect);
+                    masked(si, intersect) = scene->ray_intersect(ray, scene->hit_compute_flags(), intersect);
 
                 masked(mi.t, active_medium && (si.t < mi.t)) = math::Infinity<Float>;
                 needs_intersection &= !active_medium;
@@ -303,7 +882,7 @@ public:
                 Mask is_spectral = medium->has_spectral_extinction() && active_medium;
                 Mask not_spectral = !is_spectral && active_medium;
                 if (any_or<true>(is_spectral)) {
-                    Float t      = min(remaining_dist, min(mi.t, si.t)) - mi.mint;
+                    Float t      = mi.active_distance(min(remaining_dist, min(mi.t, si.t)));
                     UnpolarizedSpectrum tr  = exp(-t * mi.combined_extinction);
                     UnpolarizedSpectrum free_flight_pdf = select(si.t < mi.t || mi.t > remaining_dist, tr, tr * mi.combined_extinction);
                     Float tr_pdf = index_spectrum(free_flight_pdf, channel);
@@ -336,7 +915,7 @@ public:
             // Handle interactions with surfaces
             Mask intersect = active_surface && needs_intersection;
             if (any_or<true>(intersect))
-                masked(si, intersect)    = scene->ray_intersect(ray, intersect);
+                masked(si, intersect)    = scene->ray_intersect(ray, scene->hit_compute_flags(), intersect);
             needs_intersection &= !intersect;
             active_surface |= escaped_medium;
             masked(total_dist, active_surface) += si.t;
@@ -367,7 +946,7 @@ public:
     }
 
 
-    std::pair<Spectrum, Float>
+    std::tuple<Spectrum, Float, Float>
     evaluate_direct_light(const Interaction3f &ref_interaction, const Scene *scene,
                           Sampler *sampler, MediumPtr medium, Ray3f ray,
                           const SurfaceInteraction3f &si_ray,
@@ -380,7 +959,7 @@ public:
         Mask needs_intersection = false;
 
         Spectrum transmittance(1.0f);
-        Float emitter_pdf(0.0f);
+        Float emitter_pdf(0.0f), emitter_dist(0.0f);
         SurfaceInteraction3f si = si_ray;
         while (any(active)) {
             Mask escaped_medium = false;
@@ -392,7 +971,7 @@ public:
                 masked(ray.maxt, active_medium && medium->is_homogeneous() && mi.is_valid()) = mi.t;
                 Mask intersect = needs_intersection && active_medium;
                 if (any_or<true>(intersect))
-                    masked(si, intersect) = scene->ray_intersect(ray, intersect);
+                    masked(si, intersect) = scene->ray_intersect(ray, scene->hit_compute_flags(), intersect);
 
                 masked(mi.t, active_medium && (si.t < mi.t)) = math::Infinity<Float>;
 
@@ -422,7 +1001,7 @@ public:
 
             // Handle interactions with surfaces
             Mask intersect = active_surface && needs_intersection;
-            masked(si, intersect)    = scene->ray_intersect(ray, intersect);
+            masked(si, intersect)    = scene->ray_intersect(ray, scene->hit_compute_flags(), intersect);
             needs_intersection &= !intersect;
             active_surface |= escaped_medium;
 
@@ -434,6 +1013,7 @@ public:
                 ds.object                        = emitter;
                 masked(emitter_val, emitter_hit) = emitter->eval(si, emitter_hit);
                 masked(emitter_pdf, emitter_hit) = scene->pdf_emitter_direction(ref_interaction, ds, emitter_hit);
+                masked(emitter_dist, emitter_hit && si.is_valid()) = ds.dist;
                 active &= !emitter_hit; // disable lanes which found an emitter
                 active_surface &= active;
                 active_medium &= active;
@@ -461,7 +1041,47 @@ public:
                 masked(medium, has_medium_trans) = si.target_medium(ray.d);
             }
         }
-        return { transmittance * emitter_val, emitter_pdf };
+        return { transmittance * emitter_val, emitter_pdf, emitter_dist };
+    }
+
+    /// Distance to an emitter sampled by \ref sample_emitter() (zero if at infinity)
+    Float emitter_distance(const DirectionSample3f &ds, Mask active) const {
+        if (m_range_bins.empty())
+            return 0.f;
+        EmitterPtr emitter = reinterpret_array<EmitterPtr>(ds.object);
+        active &= neq(emitter, nullptr);
+        if (none_or<false>(active))
+            return 0.f;
+        Mask infinite = active && has_flag(emitter->flags(active), EmitterFlags::Infinite);
+        return select(active && !infinite, ds.dist, 0.f);
+    }
+
+    /// Accumulate a contribution into the path length histogram AOVs
+    void record_range(Float *range_aovs, const Float &length, const Spectrum &value,
+                      const Wavelength &wavelengths, Mask active) const {
+        if (!range_aovs || none_or<false>(active))
+            return;
+
+        size_t edge_count = m_range_bins.size();
+        active &= length >= m_range_bins.front() && length < m_range_bins.back();
+
+        UInt32 index = math::find_interval(
+            (uint32_t) edge_count,
+            [&](UInt32 idx, Mask active_) {
+                return gather<Float>(m_range_bins_buf, idx, active && active_) <= length;
+            });
+
+        Float y = aov_xyz(value, wavelengths, active).y();
+        accumulate_aov(range_aovs, edge_count - 1, index, y, active);
+    }
+
+    std::vector<std::string> aov_names() const override {
+        std::vector<std::string> names;
+        for (size_t i = 0; i + 1 < m_range_bins.size(); ++i)
+            names.push_back("range_" + std::to_string(i));
+        for (auto &name : order_aov_names(m_order_aovs))
+            names.push_back(name);
+        return names;
     }
 
 
@@ -471,9 +1091,15 @@ public:
     std::string to_string() const override {
         return tfm::format("VolumetricSimplePathIntegrator[\n"
                            "  max_depth = %i,\n"
-                           "  rr_depth = %i\n"
+                           "  rr_depth = %i,\n"
+                           "  range_bins = %i,\n"
+                           "  order_aovs = %i,\n"
+                           "  guiding = %s,\n"
+                           "  weight_window = %s\n"
                            "]",
-                           m_max_depth, m_rr_depth);
+                           m_max_depth, m_rr_depth,
+                           m_range_bins.empty() ? 0 : m_range_bins.size() - 1,
+                           m_order_aovs, m_guiding, m_weight_window);
     }
 
     Float mis_weight(Float pdf_a, Float pdf_b) const {
@@ -483,6 +1109,47 @@ public:
     };
 
     MTS_DECLARE_CLASS()
+private:
+    std::vector<ScalarFloat> m_range_bins;
+    FloatStorage m_range_bins_buf;
+    size_t m_order_aovs;
+
+    /// Fraction of the energy of a region of the SD-tree above which it is subdivided
+    static constexpr ScalarFloat GuidingSubdivisionThreshold = .01f;
+    /// Maximum depth of the directional quadtrees
+    static constexpr uint32_t GuidingMaxDepth = 20;
+
+    bool m_guiding;
+    size_t m_training_passes;
+    ScalarFloat m_bsdf_sampling_fraction;
+    size_t m_spatial_threshold;
+    std::unique_ptr<SDTree> m_sdtree;
+    bool m_recording = false;
+
+    /// Sums recorded by the pilot pass of the weight window
+    struct WindowPilot {
+        size_t cell_count;
+        std::unique_ptr<AtomicFloat<ScalarFloat>[]> sums, counts;
+        AtomicFloat<ScalarFloat> pixel_sum;
+        std::atomic<size_t> path_count { 0 };
+
+        WindowPilot(size_t cell_count)
+            : cell_count(cell_count), sums(new AtomicFloat<ScalarFloat>[cell_count]),
+              counts(new AtomicFloat<ScalarFloat>[cell_count]) { }
+    };
+
+    /// Minimum survival probability of the weight window roulette
+    static constexpr ScalarFloat WindowMinSurvival = .05f;
+
+    bool m_weight_window;
+    uint32_t m_window_resolution;
+    uint32_t m_max_split;
+    ScalarFloat m_window_lower, m_window_upper;
+    ScalarPoint3f m_window_origin;
+    ScalarVector3f m_window_scale;
+    std::unique_ptr<WindowPilot> m_window_pilot;
+    FloatStorage m_window_estimate;
+    bool m_window_recording = false;
 };
 
 MTS_IMPLEMENT_CLASS_VARIANT(VolumetricPathIntegrator, MonteCarloIntegrator);
@@ -167,7 +167,7 @@ public:
                 masked(ray.maxt, active_medium && medium->is_homogeneous() && mi.is_valid()) = mi.t;
                 Mask intersect = needs_intersection && active_medium;
                 if (any_or<true>(intersect))
-                    masked(si, intersect) = scene->ray_intersect(ray, intersect);
+                    masked(si, intersect) = scene->ray_intersect(ray, scene->hit_compute_flags(), intersect);
                 needs_intersection &= !active_medium;
                 masked(mi.t, active_medium && (si.t < mi.t)) = math::Infinity<Float>;
 
@@ -253,7 +253,7 @@ public:
             active_surface |= escaped_medium;
             Mask intersect = active_surface && needs_intersection;
             if (any_or<true>(intersect))
-                masked(si, intersect) = scene->ray_intersect(ray, intersect);
+                masked(si, intersect) = scene->ray_intersect(ray, scene->hit_compute_flags(), intersect);
 
 
             if (any_or<true>(active_surface)) {
@@ -366,14 +366,14 @@ public:
                 masked(ray.maxt, active_medium && medium->is_homogeneous() && mi.is_valid()) = min(mi.t, remaining_dist);
                 Mask intersect = needs_intersection && active_medium;
                 if (any_or<true>(intersect))
-                    masked(si, intersect) = scene->ray_intersect(ray, intersect);
+                    masked(si, intersect) = scene->ray_intersect(ray, scene->hit_compute_flags(), intersect);
                 masked(mi.t, active_medium && (si.t < mi.t)) = math::Infinity<Float>;
                 needs_intersection &= !active_medium;
 
                 Mask is_spectral = medium->has_spectral_extinction() && active_medium;
                 Mask not_spectral = !is_spectral && active_medium;
                 if (any_or<true>(is_spectral)) {
-                    Float t      = min(remaining_dist, min(mi.t, si.t)) - mi.mint;
+                    Float t      = mi.active_distance(min(remaining_dist, min(mi.t, si.t)));
                     UnpolarizedSpectrum tr  = exp(-t * mi.combined_extinction);
                     UnpolarizedSpectrum free_flight_pdf = select(si.t < mi.t || mi.t > remaining_dist, tr, tr * mi.combined_extinction);
                     update_weights(p_over_f_nee, free_flight_pdf, tr, channel, is_spectral);
@@ -409,7 +409,7 @@ public:
             // Handle interactions with surfaces
             Mask intersect = active_surface && needs_intersection;
             if (any_or<true>(intersect))
-                masked(si, intersect)    = scene->ray_intersect(ray, intersect);
+                masked(si, intersect)    = scene->ray_intersect(ray, scene->hit_compute_flags(), intersect);
             active_surface |= escaped_medium;
             masked(total_dist, active_surface) += si.t;
 
@@ -10,6 +10,7 @@
 
 #include <mitsuba/core/logger.h>
 #include <mitsuba/core/properties.h>
+#include <mitsuba/core/string.h>
 #include <mitsuba/core/transform.h>
 #include <mitsuba/core/variant.h>
 
@@ -29,6 +30,7 @@ using VariantType = variant<
     Transform4f,
     Color3f,
     NamedReference,
+    FloatArray,
     ref<Object>,
     const void *
 >;
@@ -139,6 +141,7 @@ namespace {
         Type operator()(const Transform4f &) { return Type::Transform; }
         Type operator()(const Color3f &) { return Type::Color; }
         Type operator()(const NamedReference &) { return Type::NamedReference; }
+        Type operator()(const FloatArray &) { return Type::FloatArray; }
         Type operator()(const ref<Object> &) { return Type::Object; }
         Type operator()(const void *&) { return Type::Pointer; }
     };
@@ -155,6 +158,14 @@ namespace {
         void operator()(const Transform4f &t) { os << t; }
         void operator()(const Color3f &t) { os << t; }
         void operator()(const NamedReference &nr) { os << "\"" << (const std::string &) nr << "\""; }
+        void operator()(const FloatArray &a) {
+            os << "[";
+            for (size_t i = 0; i < std::min(a.size(), (size_t) 8); ++i)
+                os << (i > 0 ? ", " : "") << a[i];
+            if (a.size() > 8)
+                os << ", .. " << (a.size() - 8) << " more";
+            os << "]";
+        }
         void operator()(const ref<Object> &o) { os << o->to_string(); }
         void operator()(const void *&p) { os << p; }
     };
@@ -514,4 +525,58 @@ ref<Object> Properties::find_object(const std::string &name) const {
     return it->second.data;
 }
 
+/// Float array setter
+void Properties::set_float_array(const std::string &name, const FloatArray &value,
+                                 bool error_duplicates) {
+    if (has_property(name) && error_duplicates)
+        Log(Error, "Property \"%s\" was specified multiple times!", name);
+    d->entries[name].data = value;
+    d->entries[name].queried = false;
+}
+
+/// Float array getter (without default)
+FloatArray Properties::float_array(const std::string &name) const {
+    const auto it = d->entries.find(name);
+    if (it == d->entries.end())
+        Throw("Property \"%s\" has not been specified!", name);
+
+    const VariantType &data = it->second.data;
+    FloatArray result;
+    if (data.is<FloatArray>()) {
+        result = (const FloatArray &) data;
+    } else if (data.is<std::string>()) {
+        std::vector<std::string> tokens =
+            string::tokenize((const std::string &) data, " ,");
+        std::vector<double> values;
+        values.reserve(tokens.size());
+        for (const std::string &token : tokens) {
+            try {
+                values.push_back(std::stod(token));
+            } catch (...) {
+                Throw("Could not parse floating point value '%s'", token);
+            }
+        }
+        result = FloatArray(std::move(values));
+    } else if (data.is<Float>()) {
+        result = FloatArray(std::vector<double>{ (const Float &) data });
+    } else if (data.is<int64_t>()) {
+        result = FloatArray(std::vector<double>{ (double) (const int64_t &) data });
+    } else if (data.is<Array3f>()) {
+        const Array3f &a = (const Array3f &) data;
+        result = FloatArray(std::vector<double>{ a.x(), a.y(), a.z() });
+    } else {
+        Throw("The property \"%s\" has the wrong type (expected <floats>).", name);
+    }
+
+    it->second.queried = true;
+    return result;
+}
+
+/// Float array getter (with default)
+FloatArray Properties::float_array(const std::string &name, const FloatArray &def_val) const {
+    if (!has_property(name))
+        return def_val;
+    return float_array(name);
+}
+
 NAMESPACE_END(mitsuba)
@@ -1,6 +1,7 @@
 #include <mitsuba/core/properties.h>
 #include <mitsuba/core/transform.h>
 #include <mitsuba/python/python.h>
+#include <pybind11/numpy.h>
 
 using Caster = py::object(*)(mitsuba::Object *);
 extern Caster cast_object;
@@ -9,6 +10,20 @@ extern Caster cast_object;
 #  pragma clang diagnostic ignored "-Wduplicate-decl-specifier" // warning: duplicate 'const' declaration specifier
 #endif
 
+/**
+ * Wrap a NumPy array into a FloatArray. Double precision C-contiguous arrays
+ * are referenced without copying and kept alive until the last copy of the
+ * FloatArray is released. Other arrays are converted first.
+ */
+FloatArray float_array_from_numpy(const py::array &array) {
+    using NumPyArray = py::array_t<double, py::array::c_style | py::array::forcecast>;
+    NumPyArray values = py::cast<NumPyArray>(array);
+    std::shared_ptr<const void> owner(
+        new py::object(values),
+        [](py::object *o) { py::gil_scoped_acquire acquire; delete o; });
+    return FloatArray(values.data(), (size_t) values.size(), std::move(owner));
+}
+
 #define SET_ITEM_BINDING(Name, Type)                                   \
     def("__setitem__", [](Properties& p,                               \
                           const std::string &key, const Type &value) { \
@@ -44,6 +59,9 @@ MTS_PY_EXPORT(Properties) {
             .SET_ITEM_BINDING(transform, typename Properties::Transform4f)
             .SET_ITEM_BINDING(animated_transform, ref<AnimatedTransform>)
             .SET_ITEM_BINDING(object, ref<Object>)
+            .def("__setitem__", [](Properties& p, const std::string &key, const py::array &value) {
+                p.set_float_array(key, float_array_from_numpy(value), false);
+            }, D(Properties, set_float_array))
             .def("__getitem__", [](const Properties& p, const std::string &key) {
                     // We need to ask for type information to return the right cast
                     auto type = p.type(key);
@@ -63,6 +81,9 @@ MTS_PY_EXPORT(Properties) {
                         return py::cast(p.animated_transform(key));
                     else if (type == Properties::Type::Object) {
                         return cast_object((ref<Object>)p.object(key));
+                    } else if (type == Properties::Type::FloatArray) {
+                        FloatArray array = p.float_array(key);
+                        return (py::object) py::array_t<double>(array.size(), array.data());
                     } else if (type == Properties::Type::Pointer)
                         return py::cast(p.pointer(key));
                     else {
@@ -5,14 +5,29 @@
 #include <mitsuba/core/spectrum.h>
 #include <mitsuba/core/transform.h>
 #include <mitsuba/python/python.h>
+#include <pybind11/numpy.h>
 #include <map>
 
 using Caster = py::object(*)(mitsuba::Object *);
 extern Caster cast_object;
 
-// Forward declaration
+// Defined in properties_v.cpp
+extern FloatArray float_array_from_numpy(const py::array &array);
+
+/// State of the first phase of load_dict(): conversion to a graph of Properties
+struct DictParseContext {
+    std::vector<xml::detail::PropertiesNode> nodes;
+    /// Scene-level objects that can be referenced, mapped to their node identifier
+    std::map<std::string, std::string> instances;
+    /// References to resolve once the whole dictionary is parsed: (node index, property name, id)
+    std::vector<std::tuple<size_t, std::string, std::string>> references;
+};
+
+// Forward declarations
+std::string get_type(const py::dict &dict);
 template <typename Float, typename Spectrum>
-ref<Object> load_dict(const py::dict& dict, std::map<std::string, ref<Object>> &instances);
+size_t parse_dict(const py::dict &dict, DictParseContext &ctx,
+                  const std::string &location);
 
 /// Shorthand notation for accessing the MTS_VARIANT string
 #define GET_VARIANT() mitsuba::detail::get_variant<Float, Spectrum>()
@@ -55,12 +70,33 @@ MTS_PY_EXPORT(xml) {
     m.def(
         "load_dict",
         [](const py::dict dict) {
-            std::map<std::string, ref<Object>> instances;
-            return cast_object(load_dict<Float, Spectrum>(dict, instances));
+            // Phase 1: convert the dictionary into a graph of Properties
+            DictParseContext ctx;
+            size_t root = parse_dict<Float, Spectrum>(dict, ctx, get_type(dict));
+            std::string root_id = ctx.nodes[root].id;
+
+            for (auto &[index, key, id] : ctx.references) {
+                auto it = ctx.instances.find(id);
+                if (it == ctx.instances.end())
+                    Throw("Referenced id \"%s\" not found: %s", id, key);
+                ctx.nodes[index].props.set_named_reference(key, it->second);
+            }
+
+            // Phase 2: instantiate independent subtrees in parallel
+            ref<Object> obj;
+            {
+                py::gil_scoped_release release;
+                obj = xml::detail::instantiate_graph(ctx.nodes, root_id, "dictionary",
+                                                     GET_VARIANT());
+            }
+            return cast_object(obj);
         },
         "dict"_a,
 R"doc(Load a Mitsuba scene or object from an Python dictionary
 
+The dictionary is first converted into a graph of properties. The objects
+are then instantiated in parallel without holding the GIL.
+
 Parameter ``dict``:
     Python dictionary containing the object description
 
@@ -76,12 +112,6 @@ std::string get_type(const py::dict &dict) {
     Throw("Missing key 'type' in dictionary: %s", dict);
 }
 
-#define SET_PROPS(PyType, Type, Setter)         \
-    if (py::isinstance<PyType>(value)) {        \
-        props.Setter(key, value.template cast<Type>());  \
-        continue;                               \
-    }
-
 /// Helper function to give the object a chance to recursively expand into sub-objects
 void expand_and_set_object(Properties &props, const std::string &name, const ref<Object> &obj) {
     std::vector<ref<Object>> children = obj->expand();
@@ -96,8 +126,14 @@ void expand_and_set_object(Properties &props, const std::string &name, const ref
     }
 }
 
+/**
+ * Convert a (possibly nested) dictionary into nodes of a Properties graph
+ * and return the index of the node associated with \c dict. Nested
+ * dictionaries are stored as named references to their own node.
+ */
 template <typename Float, typename Spectrum>
-ref<Object> load_dict(const py::dict &dict, std::map<std::string, ref<Object>> &instances) {
+size_t parse_dict(const py::dict &dict, DictParseContext &ctx,
+                  const std::string &location) {
 
     MTS_IMPORT_CORE_TYPES()
     using ScalarArray3f = Array<ScalarFloat, 3>;
@@ -112,6 +148,10 @@ ref<Object> load_dict(const py::dict &dict, std::map<std::string, ref<Object>> &
         class_ = PluginManager::instance()->get_plugin_class(type, GET_VARIANT());
 
     bool within_emitter = (!is_scene && class_->parent()->alias() == "emitter");
+
+    // Reserve the node now so that parents precede their children
+    size_t index = ctx.nodes.size();
+    ctx.nodes.push_back({ "_dict_" + std::to_string(index), class_, Properties(), location });
     Properties props(type);
 
     for (auto& [k, value] : dict) {
@@ -125,15 +165,34 @@ ref<Object> load_dict(const py::dict &dict, std::map<std::string, ref<Object>> &
             continue;
         }
 
-        SET_PROPS(py::bool_, bool, set_bool);
-        SET_PROPS(py::int_, int64_t, set_long);
-        SET_PROPS(py::float_, Properties::Float, set_float);
-        SET_PROPS(py::str, std::string, set_string);
-        SET_PROPS(ScalarArray3f, ScalarArray3f, set_array3f);
-        SET_PROPS(ScalarTransform4f, ScalarTransform4f, set_transform);
+        // Fast dispatch for the most common built-in Python types
+        PyObject *ptr = value.ptr();
+        if (PyBool_Check(ptr)) {
+            props.set_bool(key, ptr == Py_True);
+            continue;
+        } else if (PyFloat_Check(ptr)) {
+            props.set_float(key, (Properties::Float) PyFloat_AS_DOUBLE(ptr));
+            continue;
+        } else if (PyLong_Check(ptr)) {
+            props.set_long(key, value.template cast<int64_t>());
+            continue;
+        } else if (PyUnicode_Check(ptr)) {
+            props.set_string(key, value.template cast<std::string>());
+            continue;
+        }
+
+        if (py::isinstance<ScalarArray3f>(value)) {
+            props.set_array3f(key, value.template cast<ScalarArray3f>());
+            continue;
+        }
+
+        if (py::isinstance<ScalarTransform4f>(value)) {
+            props.set_transform(key, value.template cast<ScalarTransform4f>());
+            continue;
+        }
 
         // Load nested dictionary
-        if (py::isinstance<py::dict>(value)) {
+        if (PyDict_Check(ptr)) {
             py::dict dict2 = value.template cast<py::dict>();
             std::string type2 = get_type(dict2);
 
@@ -202,49 +261,57 @@ ref<Object> load_dict(const py::dict &dict, std::map<std::string, ref<Object>> &
             }
 
             // Nested dict with type == "ref" specify a reference to another
-            // object previously instanciated
+            // object of the scene. It is resolved once the whole dictionary
+            // has been parsed.
             if (type2 == "ref") {
                 if (is_scene)
                     Throw("Reference found at the scene level: %s", key);
 
-                for (auto& [k2, value2] : value.template cast<py::dict>()) {
+                for (auto& [k2, value2] : dict2) {
                     std::string key2 = k2.template cast<std::string>();
-                    if (key2 == "id") {
-                        std::string id = value2.template cast<std::string>();
-                        if (instances.count(id) == 1)
-                            expand_and_set_object(props, key, instances[id]);
-                        else
-                            Throw("Referenced id \"%s\" not found: %s", id, key);
-                    }  else if (key2 != "type") {
+                    if (key2 == "id")
+                        ctx.references.emplace_back(
+                            index, key, value2.template cast<std::string>());
+                    else if (key2 != "type")
                         Throw("Unexpected key in ref dictionary: %s", key2);
-                    }
                 }
                 continue;
             }
 
-            // Load the dictionary recursively
-            ref<Object> obj = load_dict<Float, Spectrum>(dict2, instances);
-            expand_and_set_object(props, key, obj);
+            // Parse the dictionary recursively
+            size_t child = parse_dict<Float, Spectrum>(dict2, ctx, location + "." + key);
+            std::string child_id = ctx.nodes[child].id;
+            props.set_named_reference(key, child_id);
 
-            // Add instanced object to the instance map for later references
+            // Add object to the instance map for later references
             if (is_scene) {
                 // An object can be referenced using its key
-                if (instances.count(key) != 0)
+                if (ctx.instances.count(key) != 0)
                     Throw("%s has duplicate id: %s", key, key);
-                instances[key] = obj;
+                ctx.instances[key] = child_id;
 
                 // An object can also be referenced using its "id" if it has one
-                std::string id = obj->id();
+                std::string id = ctx.nodes[child].props.id();
                 if (!id.empty() && id != key) {
-                    if (instances.count(id) != 0)
+                    if (ctx.instances.count(id) != 0)
                         Throw("%s has duplicate id: %s", key, id);
-                    instances[id] = obj;
+                    ctx.instances[id] = child_id;
                 }
             }
 
             continue;
         }
 
+        // One-dimensional NumPy arrays (except those with 3 entries, which
+        // are interpreted as points/vectors below) are passed as float arrays
+        if (py::isinstance<py::array>(value)) {
+            py::array array = value.template cast<py::array>();
+            if (array.ndim() == 1 && array.size() != 3) {
+                props.set_float_array(key, float_array_from_numpy(array));
+                continue;
+            }
+        }
+
         // Try to cast to Array3f (list, tuple, numpy.array, ...)
         try {
             props.set_array3f(key, value.template cast<Properties::Array3f>());
@@ -262,13 +329,6 @@ ref<Object> load_dict(const py::dict &dict, std::map<std::string, ref<Object>> &
         Throw("Unkown value type: %s", value.get_type());
     }
 
-    // Construct the object with the parsed Properties
-    auto obj = PluginManager::instance()->create_object(props, class_);
-
-    if (!props.unqueried().empty())
-        Throw("Unreferenced attribute %s in %s", props.unqueried()[0], type);
-
-    return obj;
+    ctx.nodes[index].props = props;
+    return index;
 }
-
-#undef SET_PROPS
@@ -340,7 +340,7 @@ def test8_dict_unreferenced_attribute_error(variants_all_rgb):
             "type" : "point",
             "foo": 0.44
         })
-    e.match("Unreferenced attribute")
+    e.match('unreferenced property "foo"')
 
 
 
@@ -493,4 +493,68 @@ def test10_dict_expand_nested_object(variant_scalar_rgb):
             }
         },
     })
-    assert str(b0) == str(scene.shapes()[0].bsdf())
\ No newline at end of file
+    assert str(b0) == str(scene.shapes()[0].bsdf())
+
+def test11_dict_shared_and_forward_reference(variant_scalar_rgb):
+    from mitsuba.core import xml
+
+    shapes = {
+        "shape_%i" % i : {
+            "type" : "sphere",
+            "center" : [2.5 * i, 0, 0],
+            "bsdf" : { "type" : "ref", "id" : "shared_bsdf" }
+        } for i in range(16)
+    }
+
+    # References may appear before the referenced object
+    scene = xml.load_dict({
+        "type" : "scene",
+        **shapes,
+        "shared_bsdf" : { "type" : "roughconductor", "alpha" : 0.25 },
+    })
+
+    assert len(scene.shapes()) == 16
+    ptrs = set(shape.bsdf().ptr for shape in scene.shapes())
+    assert len(ptrs) == 1
+
+    # Errors report the location of the faulty object
+    with pytest.raises(Exception) as e:
+        xml.load_dict({
+            "type" : "scene",
+            "shape" : {
+                "type" : "sphere",
+                "bsdf" : { "type" : "diffuse", "foo" : 1.0 }
+            }
+        })
+    e.match(r'scene\.shape\.bsdf')
+
+
+def test12_dict_python_plugin(variant_scalar_rgb):
+    from mitsuba.core import xml
+    from mitsuba.render import BSDF, BSDFFlags, register_bsdf
+
+    class MyBSDF(BSDF):
+        def __init__(self, props):
+            BSDF.__init__(self, props)
+            self.m_flags = BSDFFlags.DiffuseReflection | BSDFFlags.FrontSide
+            self.m_components = [self.m_flags]
+            self.index = props["index"]
+
+        def to_string(self):
+            return "MyBSDF[index=%i]" % self.index
+
+    register_bsdf("mybsdf_dict", lambda props: MyBSDF(props))
+
+    # Siblings are instantiated in parallel, outside of the GIL
+    shapes = {
+        "shape_%i" % i : {
+            "type" : "sphere",
+            "center" : [2.5 * i, 0, 0],
+            "bsdf" : { "type" : "mybsdf_dict", "index" : i }
+        } for i in range(16)
+    }
+    scene = xml.load_dict({ "type" : "scene", **shapes })
+
+    assert len(scene.shapes()) == 16
+    names = sorted(str(shape.bsdf()) for shape in scene.shapes())
+    assert names == sorted("MyBSDF[index=%i]" % i for i in range(16))
@@ -162,3 +162,35 @@ def test08_animated_transforms(variant_scalar_rgb):
     assert type(p["trafo"]) is Transform4f
     assert type(p["atrafo"]) is AnimatedTransform
 
+
+
+def test09_float_arrays(variant_scalar_rgb):
+    import numpy as np
+    from mitsuba.core import Properties as Prop
+
+    p = Prop()
+    p['array_f32'] = np.array([1, 2, 3, 4], dtype=np.float32)
+    p['array_f64'] = np.linspace(0, 1, 11)
+
+    # Arrays are stored in double precision
+    assert p['array_f32'].dtype == np.float64
+    assert np.all(p['array_f32'] == [1, 2, 3, 4])
+    assert np.all(p['array_f64'] == np.linspace(0, 1, 11))
+
+    # Arrays are compared by value
+    p2 = Prop()
+    p2['array_f32'] = np.array([1, 2, 3, 4], dtype=np.float64)
+    p2['array_f64'] = np.linspace(0, 1, 11)
+    assert p == p2
+    # .. without rounding double precision inputs to single precision
+    p2['array_f64'] = np.linspace(0, 1, 11, dtype=np.float32)
+    assert p != p2
+    p2['array_f32'] = np.array([1, 2, 3, 5], dtype=np.float32)
+    assert p != p2
+
+    # The NumPy array is referenced and stays alive with the Properties object
+    a = np.array([1, 2, 3, 4, 5], dtype=np.float64)
+    p3 = Prop()
+    p3['array'] = a
+    del a
+    assert np.all(Prop(p3)['array'] == [1, 2, 3, 4, 5])
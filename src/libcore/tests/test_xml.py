@@ -359,4 +359,25 @@ def test24_properties_duplicated(variant_scalar_rgb):
                                 <rgb name="reflectance" value="0.44"/>
                             </bsdf>
                         </scene>""")
-    e.match(err_str)
\ No newline at end of file
+    e.match(err_str)
+
+def test25_floats_invalid(variant_scalar_rgb):
+    from mitsuba.core import xml
+
+    with pytest.raises(Exception) as e:
+        xml.load_string("""<spectrum version="2.0.0" type="regular">
+                               <floats name="values" value="1, 2" base64="AACAPw=="/>
+                           </spectrum>""")
+    e.match('exactly one of the attributes')
+
+    with pytest.raises(Exception) as e:
+        xml.load_string("""<spectrum version="2.0.0" type="regular">
+                               <floats name="values" base64="AACAPw=" dtype="float64"/>
+                           </spectrum>""")
+    e.match('not a multiple')
+
+    with pytest.raises(Exception) as e:
+        xml.load_string("""<spectrum version="2.0.0" type="regular">
+                               <floats name="values" filename="does_not_exist.bin"/>
+                           </spectrum>""")
+    e.match('not found')
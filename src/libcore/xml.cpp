@@ -1,4 +1,5 @@
 #include <cctype>
+#include <cstring>
 #include <fstream>
 #include <set>
 #include <unordered_map>
@@ -9,6 +10,7 @@
 #include <mitsuba/core/fresolver.h>
 #include <mitsuba/core/logger.h>
 #include <mitsuba/core/math.h>
+#include <mitsuba/core/mmap.h>
 #include <mitsuba/core/object.h>
 #include <mitsuba/core/plugin.h>
 #include <mitsuba/core/profiler.h>
@@ -35,7 +37,7 @@ NAMESPACE_BEGIN(xml)
 
 // Set of supported XML tags
 enum class Tag {
-    Boolean, Integer, Float, String, Point, Vector, Spectrum, RGB,
+    Boolean, Integer, Float, Floats, String, Point, Vector, Spectrum, RGB,
     Transform, Translate, Matrix, Rotate, Scale, LookAt, Object,
     NamedReference, Include, Alias, Default, Resource, Invalid
 };
@@ -104,6 +106,13 @@ static Float stof(const std::string &s) {
     return result;
 }
 
+static double stod(const std::string &s) {
+    size_t offset = 0;
+    double result = std::stod(s, &offset);
+    check_whitespace_only(s, offset);
+    return result;
+}
+
 static int64_t stoll(const std::string &s) {
     size_t offset = 0;
     int64_t result = std::stoll(s, &offset);
@@ -112,6 +121,74 @@ static int64_t stoll(const std::string &s) {
 }
 
 
+/// Decode a base64-encoded string (whitespace is ignored)
+static std::vector<uint8_t> base64_decode(const std::string &s) {
+    auto decode_char = [](char c) -> int {
+        if (c >= 'A' && c <= 'Z') return c - 'A';
+        if (c >= 'a' && c <= 'z') return c - 'a' + 26;
+        if (c >= '0' && c <= '9') return c - '0' + 52;
+        if (c == '+' || c == '-') return 62;
+        if (c == '/' || c == '_') return 63;
+        return -1;
+    };
+
+    std::vector<uint8_t> result;
+    result.reserve(s.size() * 3 / 4);
+    uint32_t accum = 0;
+    int bits = 0;
+    for (char c : s) {
+        if (std::isspace(c))
+            continue;
+        if (c == '=')
+            break;
+        int value = decode_char(c);
+        if (value < 0)
+            Throw("Invalid character '%c' in base64-encoded data", c);
+        accum = (accum << 6) | (uint32_t) value;
+        bits += 6;
+        if (bits >= 8) {
+            bits -= 8;
+            result.push_back((uint8_t) ((accum >> bits) & 0xFF));
+        }
+    }
+    return result;
+}
+
+/**
+ * \brief Convert raw little-endian binary data into an array of floating
+ * point values
+ *
+ * \param dtype
+ *     Either \c "float32" or \c "float64"
+ */
+static FloatArray float_array_from_binary(const void *ptr, size_t size,
+                                          const std::string &dtype,
+                                          std::shared_ptr<const void> owner) {
+    size_t elem_size = dtype == "float64" ? sizeof(double) : sizeof(float);
+    if (dtype != "float32" && dtype != "float64")
+        Throw("Unsupported data type \"%s\" (expected \"float32\" or \"float64\")", dtype);
+    if (size % elem_size != 0)
+        Throw("Binary data size (%i bytes) is not a multiple of the size of "
+              "type \"%s\"", size, dtype);
+    size_t count = size / elem_size;
+
+    // Reference double precision data in place if it is suitably aligned
+    if (dtype == "float64" && owner && (uintptr_t) ptr % alignof(double) == 0)
+        return FloatArray((const double *) ptr, count, std::move(owner));
+
+    std::vector<double> values(count);
+    if (dtype == "float64") {
+        memcpy(values.data(), ptr, size);
+    } else {
+        for (size_t i = 0; i < count; ++i) {
+            float value;
+            memcpy(&value, (const uint8_t *) ptr + i * sizeof(float), sizeof(float));
+            values[i] = (double) value;
+        }
+    }
+    return FloatArray(std::move(values));
+}
+
 static std::unordered_map<std::string, Tag> *tags = nullptr;
 static std::unordered_map<std::string, // e.g. bsdf.scalar_rgb
                           const Class *> *tag_class = nullptr;
@@ -132,6 +209,7 @@ void register_class(const Class *class_) {
         (*tags)["boolean"]       = Tag::Boolean;
         (*tags)["integer"]       = Tag::Integer;
         (*tags)["float"]         = Tag::Float;
+        (*tags)["floats"]        = Tag::Floats;
         (*tags)["string"]        = Tag::String;
         (*tags)["point"]         = Tag::Point;
         (*tags)["vector"]        = Tag::Vector;
@@ -261,7 +339,6 @@ bool check_cuda() {
         return false;
 }
 
-
 struct XMLParseContext {
     std::unordered_map<std::string, XMLObject> instances;
     Transform4f transform;
@@ -726,6 +803,63 @@ static std::pair<std::string, std::string> parse_xml(XMLSource &src, XMLParseCon
                 }
                 break;
 
+            case Tag::Floats: {
+                    check_attributes(src, node, { "name", "value", "base64",
+                                                  "filename", "dtype" }, false);
+                    if (!node.attribute("name"))
+                        src.throw_error(node, "missing attribute \"name\" in element \"floats\"");
+                    int sources = (int) (bool) node.attribute("value") +
+                                  (int) (bool) node.attribute("base64") +
+                                  (int) (bool) node.attribute("filename");
+                    if (sources != 1)
+                        src.throw_error(node, "<floats>: exactly one of the attributes \"value\", "
+                                              "\"base64\" and \"filename\" must be specified");
+                    if (node.attribute("value") && node.attribute("dtype"))
+                        src.throw_error(node, "<floats>: the \"dtype\" attribute only applies "
+                                              "to binary data");
+                    std::string dtype = node.attribute("dtype") ?
+                                        node.attribute("dtype").value() : "float32";
+
+                    FloatArray array;
+                    try {
+                        if (node.attribute("value")) {
+                            std::vector<std::string> tokens =
+                                string::tokenize(node.attribute("value").value(), " ,");
+                            std::vector<double> values;
+                            values.reserve(tokens.size());
+                            for (const std::string &token : tokens)
+                                values.push_back(detail::stod(token));
+                            array = FloatArray(std::move(values));
+                        } else if (node.attribute("base64")) {
+                            std::vector<uint8_t> data =
+                                base64_decode(node.attribute("base64").value());
+                            array = float_array_from_binary(data.data(), data.size(),
+                                                            dtype, nullptr);
+                        } else {
+                            ref<FileResolver> fs = Thread::thread()->file_resolver();
+                            fs::path filename(node.attribute("filename").value());
+                            if (!filename.is_absolute()) {
+                                // First try to resolve it starting in the XML file directory
+                                filename = fs::path(src.id).parent_path() / filename;
+                                // Otherwise try to resolve it with the FileResolver
+                                if (!fs::exists(filename))
+                                    filename = fs->resolve(node.attribute("filename").value());
+                            }
+                            if (!fs::exists(filename))
+                                Throw("file \"%s\" not found", filename);
+                            ref<MemoryMappedFile> mmap = new MemoryMappedFile(filename);
+                            // The array references the mapped memory without copying it
+                            auto owner = std::make_shared<ref<MemoryMappedFile>>(mmap);
+                            array = float_array_from_binary(mmap->data(), mmap->size(),
+                                                            dtype, owner);
+                        }
+                    } catch (const std::exception &e) {
+                        src.throw_error(node, "<floats>: %s", e.what());
+                    }
+                    props.set_float_array(node.attribute("name").value(), array);
+                }
+                break;
+
             case Tag::Integer: {
                     check_attributes(src, node, { "name", "value" });
                     std::string value = node.attribute("value").value();
@@ -973,6 +1107,166 @@ static std::pair<std::string, std::string> parse_xml(XMLSource &src, XMLParseCon
     return std::make_pair("", "");
 }
 
+/// Check whether two parsed objects would instantiate identical objects (ignoring their IDs)
+static bool equivalent_objects(XMLParseContext &ctx, const std::string &id_1,
+                               const std::string &id_2,
+                               const std::string &ignore = "") {
+    if (id_1 == id_2)
+        return true;
+
+    auto it_1 = ctx.instances.find(id_1), it_2 = ctx.instances.find(id_2);
+    if (it_1 == ctx.instances.end() || it_2 == ctx.instances.end())
+        return false;
+
+    const XMLObject &obj_1 = it_1->second, &obj_2 = it_2->second;
+    if (obj_1.class_ != obj_2.class_ || !obj_1.alias.empty() || !obj_2.alias.empty())
+        return false;
+
+    Properties props_1(obj_1.props), props_2(obj_2.props);
+    props_1.set_id("");
+    props_2.set_id("");
+    if (!ignore.empty()) {
+        props_1.remove_property(ignore);
+        props_2.remove_property(ignore);
+    }
+
+    // Nested objects are compared recursively since their IDs differ
+    auto refs_1 = props_1.named_references(), refs_2 = props_2.named_references();
+    if (refs_1.size() != refs_2.size())
+        return false;
+    for (size_t i = 0; i < refs_1.size(); ++i) {
+        if (refs_1[i].first != refs_2[i].first ||
+            !equivalent_objects(ctx, refs_1[i].second, refs_2[i].second))
+            return false;
+        props_1.remove_property(refs_1[i].first);
+        props_2.remove_property(refs_2[i].first);
+    }
+
+    return props_1 == props_2;
+}
+
+/**
+ * \brief Replace shapes loading the same file by instances of a shape group
+ *
+ * Shapes of the scene that load their geometry from a file (\c ply, \c obj,
+ * \c serialized) and only differ by their \c to_world transformation are
+ * rewritten into a single \c shapegroup holding an object-space copy of the
+ * shape, referenced by one \c instance per original shape. The file is then
+ * loaded once and its geometry stored once. Shapes with an attached emitter,
+ * sensor or medium are left untouched since they cannot be instanced.
+ *
+ * This is opt-in through the scene's \c deduplicate_shapes boolean property,
+ * since the rewritten shapes no longer expose their own mesh parameters to
+ * \c traverse(). The property is consumed here and never reaches the scene.
+ */
+static void deduplicate_shapes(XMLParseContext &ctx, const std::string &scene_id) {
+    auto it_scene = ctx.instances.find(scene_id);
+    if (it_scene == ctx.instances.end() ||
+        it_scene->second.props.plugin_name() != "scene" ||
+        !it_scene->second.props.has_property("deduplicate_shapes"))
+        return;
+
+    bool enabled = it_scene->second.props.bool_("deduplicate_shapes");
+    it_scene->second.props.remove_property("deduplicate_shapes");
+    if (!enabled)
+        return;
+
+    // Candidate shapes, bucketed by filename
+    std::unordered_map<std::string, std::vector<std::vector<std::string>>> groups;
+    std::set<std::string> visited;
+
+    for (auto &kv : it_scene->second.props.named_references()) {
+        const std::string &id = kv.second;
+        auto it = ctx.instances.find(id);
+        if (it == ctx.instances.end() || !visited.insert(id).second)
+            continue;
+
+        const XMLObject &inst = it->second;
+        const std::string &plugin_name = inst.props.plugin_name();
+        if (!inst.alias.empty() || inst.class_ == nullptr ||
+            inst.class_->name() != "Shape" ||
+            (plugin_name != "ply" && plugin_name != "obj" && plugin_name != "serialized") ||
+            !inst.props.has_property("filename") ||
+            inst.props.type("filename") != Properties::Type::String)
+            continue;
+
+        bool instanceable = true;
+        for (auto &kv2 : inst.props.named_references()) {
+            auto it2 = ctx.instances.find(kv2.second);
+            if (it2 == ctx.instances.end() || it2->second.class_ == nullptr) {
+                instanceable = false;
+                break;
+            }
+            const std::string &class_name = it2->second.class_->name();
+            if (class_name == "Emitter" || class_name == "Sensor" || class_name == "Medium")
+                instanceable = false;
+        }
+        if (!instanceable)
+            continue;
+
+        auto &bucket = groups[inst.props.string("filename")];
+        bool found = false;
+        for (auto &group : bucket) {
+            if (equivalent_objects(ctx, group[0], id, "to_world")) {
+                group.push_back(id);
+                found = true;
+                break;
+            }
+        }
+        if (!found)
+            bucket.push_back({ id });
+    }
+
+    size_t shape_count = 0, group_count = 0;
+    for (auto &kv : groups) {
+        for (auto &group : kv.second) {
+            if (group.size() < 2)
+                continue;
+
+            std::string group_id = tfm::format("_unnamed_%i", ctx.id_counter++),
+                        shape_id = tfm::format("_unnamed_%i", ctx.id_counter++);
+
+            // Object-space shape, loaded once
+            XMLObject &first = ctx.instances[group[0]];
+            XMLObject &shape = ctx.instances[shape_id];
+            shape.props = first.props;
+            shape.props.set_id(shape_id);
+            shape.props.remove_property("to_world");
+            shape.class_ = first.class_;
+            shape.offset = first.offset;
+            shape.src_id = first.src_id;
+            shape.location = first.location;
+
+            XMLObject &shapegroup = ctx.instances[group_id];
+            shapegroup.props = Properties("shapegroup");
+            shapegroup.props.set_id(group_id);
+            shapegroup.props.set_named_reference("shape", shape_id);
+            shapegroup.class_ = first.class_;
+            shapegroup.offset = first.offset;
+            shapegroup.src_id = first.src_id;
+            shapegroup.location = first.location;
+
+            // Each original shape becomes an instance of the group
+            for (const std::string &id : group) {
+                XMLObject &inst = ctx.instances[id];
+                Properties props("instance");
+                props.set_id(id);
+                if (inst.props.has_property("to_world"))
+                    props.set_transform("to_world", inst.props.transform("to_world"));
+                props.set_named_reference("shapegroup", group_id);
+                inst.props = props;
+            }
+
+            shape_count += group.size();
+            group_count++;
+        }
+    }
+
+    if (group_count > 0)
+        Log(Info, "Instanced %i shapes referring to %i distinct geometries.",
+            shape_count, group_count);
+}
+
 static ref<Object> instantiate_node(XMLParseContext &ctx, const std::string &id) {
     auto it = ctx.instances.find(id);
     if (it == ctx.instances.end())
@@ -1070,6 +1364,25 @@ static ref<Object> instantiate_node(XMLParseContext &ctx, const std::string &id)
     return inst.object;
 }
 
+ref<Object> instantiate_graph(std::vector<PropertiesNode> &nodes,
+                              const std::string &root,
+                              const std::string &source,
+                              const std::string &variant) {
+    XMLParseContext ctx(variant);
+
+    for (auto &node : nodes) {
+        XMLObject &inst = ctx.instances[node.id];
+        inst.props  = node.props;
+        inst.class_ = node.class_;
+        inst.src_id = source;
+        inst.offset = [location = node.location](ptrdiff_t) { return location; };
+        node.props = Properties();
+    }
+    nodes.clear();
+
+    return instantiate_node(ctx, root);
+}
+
 ref<Object> create_texture_from_rgb(const std::string &name,
                                     Color<float, 3> color,
                                     const std::string &variant,
@@ -1202,6 +1515,7 @@ ref<Object> load_string(const std::string &string, const std::string &variant,
         size_t arg_counter; // Unused
         auto scene_id = detail::parse_xml(src, ctx, root, Tag::Invalid, prop,
                                           param, arg_counter, 0).second;
+        detail::deduplicate_shapes(ctx, scene_id);
         ref<Object> obj = detail::instantiate_node(ctx, scene_id);
         Thread::thread()->set_file_resolver(fs_backup.get());
         return obj;
@@ -1271,6 +1585,7 @@ ref<Object> load_file(const fs::path &filename_, const std::string &variant,
             filename = backup;
         }
 
+        detail::deduplicate_shapes(ctx, scene_id);
         ref<Object> obj = detail::instantiate_node(ctx, scene_id);
         Thread::thread()->set_file_resolver(fs_backup.get());
         return obj;
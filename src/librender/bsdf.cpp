@@ -1,4 +1,5 @@
 #include <mitsuba/render/bsdf.h>
+#include <mitsuba/render/texture.h>
 #include <mitsuba/core/properties.h>
 
 NAMESPACE_BEGIN(mitsuba)
@@ -8,6 +9,22 @@ MTS_VARIANT BSDF<Float, Spectrum>::BSDF(const Properties &props)
 
 MTS_VARIANT BSDF<Float, Spectrum>::~BSDF() { }
 
+MTS_VARIANT void BSDF<Float, Spectrum>::mark_spatially_varying() {
+    for (uint32_t &flags : m_components)
+        flags |= +BSDFFlags::SpatiallyVarying;
+    m_flags |= +BSDFFlags::SpatiallyVarying;
+}
+
+MTS_VARIANT void BSDF<Float, Spectrum>::mark_spatially_varying(
+    std::initializer_list<const Texture *> textures) {
+    for (const Texture *texture : textures) {
+        if (texture && texture->is_spatially_varying()) {
+            mark_spatially_varying();
+            break;
+        }
+    }
+}
+
 MTS_VARIANT Spectrum BSDF<Float, Spectrum>::eval_null_transmission(
     const SurfaceInteraction3f & /* si */, Mask /* active */) const {
     return 0.f;
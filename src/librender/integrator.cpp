@@ -15,6 +15,7 @@
 #include <mitsuba/render/spiral.h>
 #include <tbb/blocked_range.h>
 #include <tbb/parallel_for.h>
+#include <tbb/task_arena.h>
 #include <mutex>
 
 NAMESPACE_BEGIN(mitsuba)
@@ -49,6 +50,12 @@ MTS_VARIANT std::vector<std::string> SamplingIntegrator<Float, Spectrum>::aov_na
     return { };
 }
 
+MTS_VARIANT size_t SamplingIntegrator<Float, Spectrum>::synchronized_passes() const {
+    return 0;
+}
+
+MTS_VARIANT void SamplingIntegrator<Float, Spectrum>::pass_completed(size_t /* pass */) { }
+
 MTS_VARIANT bool SamplingIntegrator<Float, Spectrum>::render(Scene *scene, Sensor *sensor) {
     ScopedPhase sp(ProfilerPhase::Render);
     m_stop = false;
@@ -76,7 +83,8 @@ MTS_VARIANT bool SamplingIntegrator<Float, Spectrum>::render(Scene *scene, Senso
     m_render_timer.reset();
     if constexpr (!is_cuda_array_v<Float>) {
         /// Render on the CPU using a spiral pattern
-        size_t n_threads = __global_thread_count;
+        size_t n_threads = std::min(__global_thread_count,
+                                    (size_t) tbb::this_task_arena::max_concurrency());
         Log(Info, "Starting kernel job (%ix%i, %i sample%s,%s %i thread%s)",
             film_size.x(), film_size.y(),
             total_spp, total_spp == 1 ? "" : "s",
@@ -107,37 +115,48 @@ MTS_VARIANT bool SamplingIntegrator<Float, Spectrum>::render(Scene *scene, Senso
         size_t total_blocks = spiral.block_count() * n_passes,
                blocks_done = 0;
 
-        tbb::parallel_for(
-            tbb::blocked_range<size_t>(0, total_blocks, 1),
-            [&](const tbb::blocked_range<size_t> &range) {
-                ScopedSetThreadEnvironment set_env(env);
-                ref<Sampler> sampler = sensor->sampler()->clone();
-                ref<ImageBlock> block = new ImageBlock(m_block_size, channels.size(),
-                                                       film->reconstruction_filter(),
-                                                       !has_aovs);
-                scoped_flush_denormals flush_denormals(true);
-                std::unique_ptr<Float[]> aovs(new Float[channels.size()]);
-
-                // For each block
-                for (auto i = range.begin(); i != range.end() && !should_stop(); ++i) {
-                    auto [offset, size, block_id] = spiral.next_block();
-                    Assert(hprod(size) != 0);
-                    block->set_size(size);
-                    block->set_offset(offset);
-
-                    render_block(scene, sensor, sampler, block,
-                                 aovs.get(), samples_per_pass, block_id);
-
-                    film->put(block);
-
-                    /* Critical section: update progress bar */ {
-                        std::lock_guard<std::mutex> lock(mutex);
-                        blocks_done++;
-                        progress->update(blocks_done / (ScalarFloat) total_blocks);
+        /* Synchronized passes are rendered one at a time, and the remaining
+           passes at once */
+        size_t sync_passes = std::min(synchronized_passes(), n_passes);
+        for (size_t pass = 0; pass < n_passes && !should_stop();) {
+            size_t pass_count = pass < sync_passes ? 1 : n_passes - pass;
+
+            tbb::parallel_for(
+                tbb::blocked_range<size_t>(0, spiral.block_count() * pass_count, 1),
+                [&](const tbb::blocked_range<size_t> &range) {
+                    ScopedSetThreadEnvironment set_env(env);
+                    ref<Sampler> sampler = sensor->sampler()->clone();
+                    ref<ImageBlock> block = new ImageBlock(m_block_size, channels.size(),
+                                                           film->reconstruction_filter(),
+                                                           !has_aovs);
+                    scoped_flush_denormals flush_denormals(true);
+                    std::unique_ptr<Float[]> aovs(new Float[channels.size()]);
+
+                    // For each block
+                    for (auto i = range.begin(); i != range.end() && !should_stop(); ++i) {
+                        auto [offset, size, block_id] = spiral.next_block();
+                        Assert(hprod(size) != 0);
+                        block->set_size(size);
+                        block->set_offset(offset);
+
+                        render_block(scene, sensor, sampler, block,
+                                     aovs.get(), samples_per_pass, block_id);
+
+                        film->put(block);
+
+                        /* Critical section: update progress bar */ {
+                            std::lock_guard<std::mutex> lock(mutex);
+                            blocks_done++;
+                            progress->update(blocks_done / (ScalarFloat) total_blocks);
+                        }
                     }
                 }
-            }
-        );
+            );
+
+            pass += pass_count;
+            if (pass <= sync_passes && !should_stop())
+                pass_completed(pass - 1);
+        }
     } else {
         Log(Info, "Start rendering...");
 
@@ -165,9 +184,13 @@ MTS_VARIANT bool SamplingIntegrator<Float, Spectrum>::render(Scene *scene, Senso
 
         std::vector<Float> aovs(channels.size());
 
-        for (size_t i = 0; i < n_passes; i++)
+        size_t sync_passes = std::min(synchronized_passes(), n_passes);
+        for (size_t i = 0; i < n_passes; i++) {
             render_sample(scene, sensor, sampler, block, aovs.data(),
                           pos, diff_scale_factor);
+            if (i < sync_passes)
+                pass_completed(i);
+        }
 
         film->put(block);
     }
@@ -263,6 +286,9 @@ SamplingIntegrator<Float, Spectrum>::render_sample(const Scene *scene,
 
     const Medium *medium = sensor->medium();
     std::pair<Spectrum, Mask> result = sample(scene, sampler, ray, medium, aovs + 5, active);
+    if (sensor->has_direct_estimate())
+        result.first += sensor->eval_direct(scene, time, ray.wavelengths, adjusted_position,
+                                            aperture_sample, active);
     result.first = ray_weight * result.first;
 
     UnpolarizedSpectrum spec_u = depolarize(result.first);
@@ -298,6 +324,77 @@ SamplingIntegrator<Float, Spectrum>::sample(const Scene * /* scene */,
     NotImplementedError("sample");
 }
 
+MTS_VARIANT typename SamplingIntegrator<Float, Spectrum>::Color3f
+SamplingIntegrator<Float, Spectrum>::aov_xyz(const Spectrum &value,
+                                             const Wavelength &wavelengths,
+                                             Mask active) const {
+    UnpolarizedSpectrum spec_u = depolarize(value);
+
+    if constexpr (is_monochromatic_v<Spectrum>) {
+        ENOKI_MARK_USED(wavelengths);
+        ENOKI_MARK_USED(active);
+        return spec_u.x();
+    } else if constexpr (is_rgb_v<Spectrum>) {
+        ENOKI_MARK_USED(wavelengths);
+        return srgb_to_xyz(spec_u, active);
+    } else {
+        static_assert(is_spectral_v<Spectrum>);
+        auto pdf = pdf_rgb_spectrum(wavelengths);
+        spec_u *= select(neq(pdf, 0.f), rcp(pdf), 0.f);
+        return spectrum_to_xyz(spec_u, wavelengths, active);
+    }
+}
+
+// -----------------------------------------------------------------------------
+
+MTS_VARIANT AccumulatorIntegrator<Float, Spectrum>::AccumulatorIntegrator(const Properties &props)
+    : Base(props) {
+    for (auto &kv : props.objects()) {
+        Base *integrator = dynamic_cast<Base *>(kv.second.get());
+        if (!integrator)
+            Throw("Child objects must be of type 'SamplingIntegrator'!");
+        if (m_integrator)
+            Throw("More than one sub-integrator specified!");
+        m_integrator = integrator;
+    }
+
+    if (!m_integrator)
+        Throw("Must specify a sub-integrator!");
+
+    m_nested_aov_count = m_integrator->aov_names().size();
+}
+
+MTS_VARIANT AccumulatorIntegrator<Float, Spectrum>::~AccumulatorIntegrator() { }
+
+MTS_VARIANT std::pair<Spectrum, typename AccumulatorIntegrator<Float, Spectrum>::Mask>
+AccumulatorIntegrator<Float, Spectrum>::sample(const Scene *scene,
+                                               Sampler *sampler,
+                                               const RayDifferential3f &ray,
+                                               const Medium *medium,
+                                               Float *aovs,
+                                               Mask active) const {
+    MTS_MASKED_FUNCTION(ProfilerPhase::SamplingIntegratorSample, active);
+
+    Float *nested_aovs = aovs ? aovs + m_accumulator_aov_names.size() : nullptr;
+    auto result = m_integrator->sample(scene, sampler, ray, medium, nested_aovs, active);
+
+    if (aovs)
+        accumulate(result.first, ray.wavelengths, nested_aovs, aovs, active);
+
+    return result;
+}
+
+MTS_VARIANT std::vector<std::string> AccumulatorIntegrator<Float, Spectrum>::aov_names() const {
+    std::vector<std::string> names = m_accumulator_aov_names;
+    std::vector<std::string> nested = m_integrator->aov_names();
+    names.insert(names.end(), nested.begin(), nested.end());
+    return names;
+}
+
+MTS_VARIANT void AccumulatorIntegrator<Float, Spectrum>::traverse(TraversalCallback *callback) {
+    callback->put_object("integrator", m_integrator.get());
+}
+
 // -----------------------------------------------------------------------------
 
 MTS_VARIANT MonteCarloIntegrator<Float, Spectrum>::MonteCarloIntegrator(const Properties &props)
@@ -317,11 +414,58 @@ MTS_VARIANT MonteCarloIntegrator<Float, Spectrum>::MonteCarloIntegrator(const Pr
 
 MTS_VARIANT MonteCarloIntegrator<Float, Spectrum>::~MonteCarloIntegrator() { }
 
+MTS_VARIANT void
+MonteCarloIntegrator<Float, Spectrum>::accumulate_aov(Float *aovs, size_t size,
+                                                      const UInt32 &index,
+                                                      const Float &value,
+                                                      Mask active) const {
+    active &= index < (uint32_t) size;
+
+    if constexpr (!is_array_v<Float>) {
+        if (active)
+            aovs[index] += value;
+    } else if constexpr (is_cuda_array_v<Float>) {
+        for (size_t i = 0; i < size; ++i)
+            masked(aovs[i], active && eq(index, (uint32_t) i)) += value;
+    } else {
+        // The lanes of consecutive AOV packets are stored contiguously
+        UInt32 offset = index * (uint32_t) array_size_v<Float> + arange<UInt32>();
+        scatter_add((ScalarFloat *) aovs, value, offset, active);
+    }
+}
+
+MTS_VARIANT void
+MonteCarloIntegrator<Float, Spectrum>::accumulate_order(Float *aovs, size_t order_count,
+                                                        const UInt32 &order,
+                                                        const Spectrum &value,
+                                                        const Wavelength &wavelengths,
+                                                        Mask active) const {
+    active &= order > 0u && order <= (uint32_t) order_count;
+    if (!aovs || none_or<false>(active))
+        return;
+
+    Color3f xyz = aov_xyz(value, wavelengths, active);
+    UInt32 index = (order - 1u) * 3u;
+    for (uint32_t i = 0; i < 3; ++i)
+        accumulate_aov(aovs, 3 * order_count, index + i, xyz[i], active);
+}
+
+MTS_VARIANT std::vector<std::string>
+MonteCarloIntegrator<Float, Spectrum>::order_aov_names(size_t order_count) const {
+    std::vector<std::string> names;
+    for (size_t i = 1; i <= order_count; ++i)
+        for (const char *c : { ".X", ".Y", ".Z" })
+            names.push_back("order_" + std::to_string(i) + c);
+    return names;
+}
+
 MTS_IMPLEMENT_CLASS_VARIANT(Integrator, Object, "integrator")
 MTS_IMPLEMENT_CLASS_VARIANT(SamplingIntegrator, Integrator)
+MTS_IMPLEMENT_CLASS_VARIANT(AccumulatorIntegrator, SamplingIntegrator)
 MTS_IMPLEMENT_CLASS_VARIANT(MonteCarloIntegrator, SamplingIntegrator)
 
 MTS_INSTANTIATE_CLASS(Integrator)
 MTS_INSTANTIATE_CLASS(SamplingIntegrator)
+MTS_INSTANTIATE_CLASS(AccumulatorIntegrator)
 MTS_INSTANTIATE_CLASS(MonteCarloIntegrator)
 NAMESPACE_END(mitsuba)
@@ -44,6 +44,7 @@ MTS_VARIANT ShapeKDTree<Float, Spectrum>::ShapeKDTree(const Properties &props)
     if (props.has_property("kd_exact_primitive_threshold"))
         set_exact_primitive_threshold(props.int_("kd_exact_primitive_threshold"));
 
+    m_max_depth_param = Base::max_depth();
     m_primitive_map.push_back(0);
 }
 
@@ -69,6 +70,20 @@ MTS_VARIANT void ShapeKDTree<Float, Spectrum>::add_shape(Shape *shape) {
     m_bbox.expand(shape->bbox());
 }
 
+MTS_VARIANT void ShapeKDTree<Float, Spectrum>::clear() {
+    m_shapes.clear();
+    m_primitive_map.clear();
+    m_primitive_map.push_back(0);
+    m_bbox.reset();
+
+    m_nodes.reset();
+    m_indices.reset();
+    m_node_count = m_index_count = 0;
+
+    // The maximum depth is derived from the primitive count unless specified
+    set_max_depth(m_max_depth_param);
+}
+
 MTS_VARIANT std::string ShapeKDTree<Float, Spectrum>::to_string() const {
     std::ostringstream oss;
     oss << "ShapeKDTreeKDTree[" << std::endl
@@ -7,7 +7,9 @@
 
 NAMESPACE_BEGIN(mitsuba)
 
-MTS_VARIANT Medium<Float, Spectrum>::Medium() : m_is_homogeneous(false), m_has_spectral_extinction(true) {}
+MTS_VARIANT Medium<Float, Spectrum>::Medium()
+    : m_is_homogeneous(false), m_has_spectral_extinction(true),
+      m_has_bounding_shell(false) {}
 
 MTS_VARIANT Medium<Float, Spectrum>::Medium(const Properties &props) : m_id(props.id()) {
 
@@ -27,10 +29,58 @@ MTS_VARIANT Medium<Float, Spectrum>::Medium(const Properties &props) : m_id(prop
     }
 
     m_sample_emitters = props.bool_("sample_emitters", true);
+
+    // Optional spherical shell enclosing the nonzero-extinction region
+    m_has_bounding_shell = props.has_property("bounding_shell_outer_radius");
+    m_shell_center       = props.point3f("bounding_shell_center", 0.f);
+    m_shell_inner_radius = props.float_("bounding_shell_inner_radius", 0.f);
+    m_shell_outer_radius = props.float_("bounding_shell_outer_radius", 0.f);
+    if (m_has_bounding_shell &&
+        !(m_shell_inner_radius >= 0.f && m_shell_inner_radius < m_shell_outer_radius))
+        Throw("The bounding shell radii must satisfy 0 <= inner radius < outer radius!");
 }
 
 MTS_VARIANT Medium<Float, Spectrum>::~Medium() {}
 
+MTS_VARIANT
+std::tuple<typename Medium<Float, Spectrum>::Mask, Float, Float, Float, Float>
+Medium<Float, Spectrum>::intersect_bounds(const Ray3f &ray) const {
+    auto [valid, mint, maxt] = intersect_aabb(ray);
+    valid &= (enoki::isfinite(mint) || enoki::isfinite(maxt));
+
+    Float hole_mint = math::Infinity<Float>,
+          hole_maxt = math::Infinity<Float>;
+
+    if (m_has_bounding_shell) {
+        using Double  = std::conditional_t<is_cuda_array_v<Float>, Float, Float64>;
+        using Double3 = Vector<Double, 3>;
+
+        Double3 o = Double3(ray.o) - Double3(m_shell_center);
+        Double3 d(ray.d);
+
+        Double A = squared_norm(d);
+        Double B = scalar_t<Double>(2.f) * dot(o, d);
+        Double C = squared_norm(o);
+
+        // The outer sphere restricts the active segment
+        auto [found_outer, near_outer, far_outer] = math::solve_quadratic(
+            A, B, C - sqr((scalar_t<Double>) m_shell_outer_radius));
+        valid &= found_outer;
+        mint = max(mint, Float(near_outer));
+        maxt = min(maxt, Float(far_outer));
+
+        // The inner sphere carves an empty interval out of it
+        if (m_shell_inner_radius > 0.f) {
+            auto [found_inner, near_inner, far_inner] = math::solve_quadratic(
+                A, B, C - sqr((scalar_t<Double>) m_shell_inner_radius));
+            masked(hole_mint, found_inner) = Float(near_inner);
+            masked(hole_maxt, found_inner) = Float(far_inner);
+        }
+    }
+
+    return { valid, mint, maxt, hole_mint, hole_maxt };
+}
+
 MTS_VARIANT
 typename Medium<Float, Spectrum>::MediumInteraction3f
 Medium<Float, Spectrum>::sample_interaction(const Ray3f &ray, Float sample,
@@ -44,15 +94,27 @@ Medium<Float, Spectrum>::sample_interaction(const Ray3f &ray, Float sample,
     mi.time        = ray.time;
     mi.wavelengths = ray.wavelengths;
 
-    auto [aabb_its, mint, maxt] = intersect_aabb(ray);
-    aabb_its &= (enoki::isfinite(mint) || enoki::isfinite(maxt));
-    active &= aabb_its;
+    auto [bounds_its, mint, maxt, hole_mint, hole_maxt] = intersect_bounds(ray);
+    active &= bounds_its;
     masked(mint, !active) = 0.f;
     masked(maxt, !active) = math::Infinity<Float>;
 
     mint = max(ray.mint, mint);
     maxt = min(ray.maxt, maxt);
 
+    /* Clip the empty interval against the active segment. A hole touching
+       either end of the segment simply shortens it. */
+    hole_mint = max(hole_mint, mint);
+    hole_maxt = min(hole_maxt, maxt);
+    Mask no_hole = !active || !(hole_mint < hole_maxt);
+    Mask hole_at_start = !no_hole && hole_mint <= mint,
+         hole_at_end   = !no_hole && hole_maxt >= maxt;
+    masked(mint, hole_at_start) = hole_maxt;
+    masked(maxt, hole_at_end)   = hole_mint;
+    no_hole |= hole_at_start || hole_at_end;
+    masked(hole_mint, no_hole) = math::Infinity<Float>;
+    masked(hole_maxt, no_hole) = math::Infinity<Float>;
+
     auto combined_extinction = get_combined_extinction(mi, active);
     Float m                  = combined_extinction[0];
     if constexpr (is_rgb_v<Spectrum>) { // Handle RGB rendering
@@ -63,11 +125,15 @@ Medium<Float, Spectrum>::sample_interaction(const Ray3f &ray, Float sample,
     }
 
     Float sampled_t = mint + (-enoki::log(1 - sample) / m);
+    // Free-flight distances are only accumulated inside the active region
+    masked(sampled_t, sampled_t > hole_mint) += hole_maxt - hole_mint;
     Mask valid_mi   = active && (sampled_t <= maxt);
     mi.t            = select(valid_mi, sampled_t, math::Infinity<Float>);
     mi.p            = ray(sampled_t);
     mi.medium       = this;
     mi.mint         = mint;
+    mi.hole_mint    = hole_mint;
+    mi.hole_maxt    = hole_maxt;
     std::tie(mi.sigma_s, mi.sigma_n, mi.sigma_t) =
         get_scattering_coefficients(mi, valid_mi);
     mi.combined_extinction = combined_extinction;
@@ -82,7 +148,7 @@ Medium<Float, Spectrum>::eval_tr_and_pdf(const MediumInteraction3f &mi,
                                          Mask active) const {
     MTS_MASKED_FUNCTION(ProfilerPhase::MediumEvaluate, active);
 
-    Float t      = min(mi.t, si.t) - mi.mint;
+    Float t      = mi.active_distance(min(mi.t, si.t));
     UnpolarizedSpectrum tr  = exp(-t * mi.combined_extinction);
     UnpolarizedSpectrum pdf = select(si.t < mi.t, tr, tr * mi.combined_extinction);
     return { tr, pdf };
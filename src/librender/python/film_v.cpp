@@ -13,13 +13,16 @@ MTS_PY_EXPORT(Film) {
         .def_method(Film, prepare, "channels"_a)
         .def_method(Film, put, "block"_a)
         .def_method(Film, set_destination_file, "filename"_a)
-        .def("develop", py::overload_cast<>(&Film::develop))
+        .def("develop", py::overload_cast<>(&Film::develop),
+            py::call_guard<py::gil_scoped_release>())
         .def("develop", py::overload_cast<const ScalarPoint2i &, const ScalarVector2i &,
                                             const ScalarPoint2i &, Bitmap *>(
                 &Film::develop, py::const_),
-            "offset"_a, "size"_a, "target_offset"_a, "target"_a)
+            "offset"_a, "size"_a, "target_offset"_a, "target"_a,
+            py::call_guard<py::gil_scoped_release>())
         .def_method(Film, destination_exists, "basename"_a)
-        .def_method(Film, bitmap, "raw"_a = false)
+        .def_method(Film, bitmap, "raw"_a = false,
+                    py::call_guard<py::gil_scoped_release>())
         .def_method(Film, has_high_quality_edges)
         .def_method(Film, size)
         .def_method(Film, crop_size)
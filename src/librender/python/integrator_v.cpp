@@ -3,6 +3,9 @@
 #include <mitsuba/core/thread.h>
 #include <mitsuba/core/tls.h>
 #include <mitsuba/python/python.h>
+#include <tbb/task_arena.h>
+#include <map>
+#include <mutex>
 
 #if defined(__APPLE__) || defined(__linux__)
 #  define MTS_HANDLE_SIGINT 1
@@ -13,11 +16,45 @@
 #if MTS_HANDLE_SIGINT
 #include <signal.h>
 
-/// Current signal handler
-static std::function<void()> sigint_handler;
+/// Callbacks cancelling the renders in progress (several may run concurrently)
+static std::map<size_t, std::function<void()>> sigint_handlers;
+static size_t sigint_handler_ctr = 0;
+static std::mutex sigint_mutex;
 
 /// Previously installed signal handler
 static void (*sigint_handler_prev)(int) = nullptr;
+
+static void sigint_handler(int) {
+    Log(Warn, "Received interrupt signal, winding down..");
+    std::unique_lock<std::mutex> lock(sigint_mutex, std::try_to_lock);
+    if (lock.owns_lock()) {
+        for (auto &kv : sigint_handlers)
+            kv.second();
+        sigint_handlers.clear();
+    }
+    signal(SIGINT, sigint_handler_prev);
+    raise(SIGINT);
+}
+
+/// Installs the SIGINT handler for the lifetime of a render
+struct ScopedSigintHandler {
+    ScopedSigintHandler(const std::function<void()> &cancel) {
+        std::lock_guard<std::mutex> lock(sigint_mutex);
+        if (sigint_handlers.empty())
+            sigint_handler_prev = signal(SIGINT, sigint_handler);
+        id = sigint_handler_ctr++;
+        sigint_handlers[id] = cancel;
+    }
+
+    ~ScopedSigintHandler() {
+        // Restore the previous signal handler once all renders are done
+        std::lock_guard<std::mutex> lock(sigint_mutex);
+        if (sigint_handlers.erase(id) && sigint_handlers.empty())
+            signal(SIGINT, sigint_handler_prev);
+    }
+
+    size_t id;
+};
 #endif
 
 /// Trampoline for derived types implemented in Python
@@ -123,36 +160,28 @@ MTS_PY_EXPORT(Integrator) {
 
     MTS_PY_CLASS(Integrator, Object)
         .def("render",
-            [&](Integrator *integrator, Scene *scene, Sensor *sensor) {
+            [&](Integrator *integrator, Scene *scene, Sensor *sensor, size_t thread_count) {
                 py::gil_scoped_release release;
 
 #if MTS_HANDLE_SIGINT
-                // Install new signal handler
-                sigint_handler = [integrator]() {
+                // Install new signal handler (shared by concurrent renders)
+                ScopedSigintHandler sigint_guard([integrator]() {
                     integrator->cancel();
-                };
-
-                sigint_handler_prev = signal(SIGINT, [](int) {
-                    Log(Warn, "Received interrupt signal, winding down..");
-                    if (sigint_handler) {
-                        sigint_handler();
-                        sigint_handler = std::function<void()>();
-                        signal(SIGINT, sigint_handler_prev);
-                        raise(SIGINT);
-                    }
                 });
 #endif
 
-                bool res = integrator->render(scene, sensor);
-
-#if MTS_HANDLE_SIGINT
-                // Restore previous signal handler
-                signal(SIGINT, sigint_handler_prev);
-#endif
+                bool res;
+                if (thread_count > 0) {
+                    // Render within a separate arena limited to 'thread_count' threads
+                    tbb::task_arena arena((int) thread_count);
+                    arena.execute([&]() { res = integrator->render(scene, sensor); });
+                } else {
+                    res = integrator->render(scene, sensor);
+                }
 
                 return res;
             },
-            D(Integrator, render), "scene"_a, "sensor"_a)
+            D(Integrator, render), "scene"_a, "sensor"_a, "thread_count"_a = 0)
         .def_method(Integrator, cancel);
 
     auto integrator =
@@ -160,11 +189,15 @@ MTS_PY_EXPORT(Integrator) {
                     ref<SamplingIntegrator>>(m, "SamplingIntegrator", D(SamplingIntegrator))
             .def(py::init<const Properties&>())
             .def_method(SamplingIntegrator, aov_names)
-            .def_method(SamplingIntegrator, should_stop);
+            .def_method(SamplingIntegrator, should_stop)
+            .def_method(SamplingIntegrator, synchronized_passes);
 
     bind_integrator_sample<Float, Spectrum>(integrator);
 
     MTS_PY_REGISTER_OBJECT("register_integrator", Integrator)
 
+    MTS_PY_CLASS(AccumulatorIntegrator, SamplingIntegrator)
+        .def_method(AccumulatorIntegrator, integrator);
+
     MTS_PY_CLASS(MonteCarloIntegrator, SamplingIntegrator);
 }
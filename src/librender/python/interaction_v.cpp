@@ -169,6 +169,8 @@ void bind_slicing_operator_mediuminteraction(PyClass &cl) {
             res.sh_frame    = slice(mi.sh_frame, i);
             res.wi          = slice(mi.wi, i);
             res.mint        = slice(mi.mint, i);
+            res.hole_mint   = slice(mi.hole_mint, i);
+            res.hole_maxt   = slice(mi.hole_maxt, i);
             return res;
         })
         .def("__setitem__", [](Class &r, size_t i,
@@ -187,6 +189,8 @@ void bind_slicing_operator_mediuminteraction(PyClass &cl) {
             slice(r.sh_frame, i)    = slice(r2.sh_frame, 0);
             slice(r.wi, i)          = slice(r2.wi, 0);
             slice(r.mint, i)        = slice(r2.mint, 0);
+            slice(r.hole_mint, i)   = slice(r2.hole_mint, 0);
+            slice(r.hole_maxt, i)   = slice(r2.hole_maxt, 0);
         })
         .def("__len__", [](const Class &r) {
             return slices(r);
@@ -211,11 +215,21 @@ MTS_PY_EXPORT(MediumInteraction) {
         .def_field(MediumInteraction3f, medium,     D(MediumInteraction, medium))
         .def_field(MediumInteraction3f, sh_frame,   D(MediumInteraction, sh_frame))
         .def_field(MediumInteraction3f, wi,         D(MediumInteraction, wi))
+        .def_field(MediumInteraction3f, sigma_s,    D(MediumInteraction, sigma_s))
+        .def_field(MediumInteraction3f, sigma_n,    D(MediumInteraction, sigma_n))
+        .def_field(MediumInteraction3f, sigma_t,    D(MediumInteraction, sigma_t))
+        .def_field(MediumInteraction3f, combined_extinction,
+                   D(MediumInteraction, combined_extinction))
+        .def_field(MediumInteraction3f, mint,       D(MediumInteraction, mint))
+        .def_field(MediumInteraction3f, hole_mint,  D(MediumInteraction, hole_mint))
+        .def_field(MediumInteraction3f, hole_maxt,  D(MediumInteraction, hole_maxt))
 
         // Methods
         .def(py::init<>(), D(MediumInteraction, MediumInteraction))
         .def("to_world", &MediumInteraction3f::to_world, "v"_a, D(MediumInteraction, to_world))
         .def("to_local", &MediumInteraction3f::to_local, "v"_a, D(MediumInteraction, to_local))
+        .def("active_distance", &MediumInteraction3f::active_distance, "t_end"_a,
+             D(MediumInteraction, active_distance))
         .def_repr(MediumInteraction3f);
 
     // Manually bind the slicing operators to handle ShapePtr properly
@@ -249,6 +263,7 @@ MTS_PY_EXPORT(PreliminaryIntersection) {
         .def_field(PreliminaryIntersection3f, shape_index, D(PreliminaryIntersection, shape_index))
         .def_field(PreliminaryIntersection3f, shape,       D(PreliminaryIntersection, shape))
         .def_field(PreliminaryIntersection3f, instance,    D(PreliminaryIntersection, instance))
+        .def_field(PreliminaryIntersection3f, offset,      D(PreliminaryIntersection, offset))
 
         // Methods
         .def(py::init<>(), D(PreliminaryIntersection, PreliminaryIntersection))
@@ -41,6 +41,7 @@ static py::object caster(Object *o) {
     PY_TRY_CAST(Film);
 
     PY_TRY_CAST(MonteCarloIntegrator);
+    PY_TRY_CAST(AccumulatorIntegrator);
     PY_TRY_CAST(SamplingIntegrator);
     PY_TRY_CAST(Integrator);
 
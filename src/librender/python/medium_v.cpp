@@ -16,6 +16,11 @@ public:
         PYBIND11_OVERLOAD_PURE(Return, Medium, intersect_aabb, ray);
     }
 
+    std::tuple<Mask, Float, Float, Float, Float> intersect_bounds(const Ray3f &ray) const override {
+        using Return = std::tuple<Mask, Float, Float, Float, Float>;
+        PYBIND11_OVERLOAD(Return, Medium, intersect_bounds, ray);
+    }
+
     UnpolarizedSpectrum get_combined_extinction(const MediumInteraction3f &mi, Mask active = true) const override {
         PYBIND11_OVERLOAD_PURE(UnpolarizedSpectrum, Medium, get_combined_extinction, mi, active);
     }
@@ -38,12 +43,14 @@ MTS_PY_EXPORT(Medium) {
     auto medium = py::class_<Medium, PyMedium, Object, ref<Medium>>(m, "Medium", D(Medium))
             .def(py::init<const Properties &>())
             .def("intersect_aabb", vectorize(&Medium::intersect_aabb), "ray"_a)
+            .def("intersect_bounds", vectorize(&Medium::intersect_bounds), "ray"_a)
             .def("get_combined_extinction", vectorize(&Medium::get_combined_extinction), "mi"_a, "active"_a=true)
             .def("get_scattering_coefficients", vectorize(&Medium::get_scattering_coefficients), "mi"_a, "active"_a=true)
             .def("sample_interaction", vectorize(&Medium::sample_interaction), "ray"_a, "sample"_a, "channel"_a, "active"_a=true)
             .def("eval_tr_and_pdf", vectorize(&Medium::eval_tr_and_pdf), "mi"_a, "si"_a, "active"_a=true)
             .def_method(Medium, phase_function)
             .def_method(Medium, use_emitter_sampling)
+            .def_method(Medium, has_bounding_shell)
             // .def_method(Medium, is_homogeneous)
             // .def_method(Medium, has_spectral_extinction)
             .def_method(Medium, id)
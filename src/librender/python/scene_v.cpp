@@ -26,8 +26,7 @@ MTS_PY_EXPORT(ShapeKDTree) {
         })
         .def("__len__", &ShapeKDTree::primitive_count)
         .def("bbox", [] (ShapeKDTree &s) { return s.bbox(); })
-        .def_method(ShapeKDTree, build)
-        .def_method(ShapeKDTree, build);
+        .def_method(ShapeKDTree, build, py::call_guard<py::gil_scoped_release>());
 #else
     ENOKI_MARK_USED(m);
 #endif
@@ -36,7 +35,7 @@ MTS_PY_EXPORT(ShapeKDTree) {
 MTS_PY_EXPORT(Scene) {
     MTS_PY_IMPORT_TYPES(Scene, Integrator, SamplingIntegrator, MonteCarloIntegrator, Sensor)
     MTS_PY_CLASS(Scene, Object)
-        .def(py::init<const Properties>())
+        .def(py::init<const Properties>(), py::call_guard<py::gil_scoped_release>())
         .def("ray_intersect_preliminary",
              vectorize(&Scene::ray_intersect_preliminary),
              "ray"_a, "active"_a = true, D(Scene, ray_intersect_preliminary))
@@ -62,6 +61,8 @@ MTS_PY_EXPORT(Scene) {
             "ref"_a, "ds"_a, "active"_a = true)
         // Accessors
         .def_method(Scene, bbox)
+        .def("is_periodic", &Scene::is_periodic, D(Scene, is_periodic))
+        .def("periodic_bbox", &Scene::periodic_bbox, D(Scene, periodic_bbox))
         .def("sensors", py::overload_cast<>(&Scene::sensors), D(Scene, sensors))
         .def("emitters", py::overload_cast<>(&Scene::emitters), D(Scene, emitters))
         .def_method(Scene, environment)
@@ -86,6 +87,7 @@ MTS_PY_EXPORT(Scene) {
                 return py::cast(o);
             },
             D(Scene, integrator))
+        .def_method(Scene, hit_compute_flags)
         .def_method(Scene, shapes_grad_enabled)
         .def("__repr__", &Scene::to_string);
 }
\ No newline at end of file
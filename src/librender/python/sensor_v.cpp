@@ -60,9 +60,16 @@ MTS_PY_EXPORT(Sensor) {
         .def(py::init<const Properties&>())
         .def("sample_ray_differential", vectorize(&Sensor::sample_ray_differential),
             "time"_a, "sample1"_a, "sample2"_a, "sample3"_a, "active"_a = true)
+        .def("eval_direct", vectorize(&Sensor::eval_direct),
+            "scene"_a, "time"_a, "wavelengths"_a, "sample2"_a, "sample3"_a, "active"_a = true,
+            D(Sensor, eval_direct))
         .def_method(Sensor, shutter_open)
         .def_method(Sensor, shutter_open_time)
         .def_method(Sensor, needs_aperture_sample)
+        .def_method(Sensor, has_direct_estimate)
+        .def_method(Sensor, has_direction_sampling)
+        .def_method(Sensor, has_volume_tally)
+        .def_method(Sensor, tally_channels)
         .def("film", py::overload_cast<>(&Sensor::film, py::const_), D(Sensor, film))
         .def("sampler", py::overload_cast<>(&Sensor::sampler, py::const_), D(Sensor, sampler));
 
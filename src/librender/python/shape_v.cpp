@@ -40,6 +40,7 @@ MTS_PY_EXPORT(Shape) {
         .def_method(Shape, id)
         .def_method(Shape, is_mesh)
         .def_method(Shape, is_medium_transition)
+        .def_method(Shape, hit_compute_flags)
         .def_method(Shape, interior_medium)
         .def_method(Shape, exterior_medium)
         .def_method(Shape, is_emitter)
@@ -50,6 +50,15 @@ MTS_PY_EXPORT(Volume) {
         .def("eval_gradient",
             vectorize(&Volume::eval_gradient),
             "it"_a, "active"_a = true, D(Volume, eval_gradient))
+        .def("eval_fields",
+            [](const Volume *volume, const Interaction3f &it, Mask active) {
+                std::vector<UnpolarizedSpectrum> fields(volume->field_count());
+                volume->eval_fields(it, fields.data(), active);
+                return fields;
+            }, "it"_a, "active"_a = true, D(Volume, eval_fields))
+        .def("field_count",
+            &Volume::field_count,
+            D(Volume, field_count))
         .def("max",
             &Volume::max,
             D(Volume, max))
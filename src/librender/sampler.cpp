@@ -98,9 +98,65 @@ MTS_VARIANT void PCG32Sampler<Float, Spectrum>::seed(uint64_t seed_offset,
 //! @}
 // =======================================================================
 
+// =======================================================================
+//! @{ \name RadicalInverseSampler implementations
+// =======================================================================
+
+MTS_VARIANT RadicalInverseSampler<Float, Spectrum>::RadicalInverseSampler(const Properties &props)
+    : Base(props) {
+    m_inverse = new RadicalInverse(8161, props.int_("scramble", -1));
+}
+
+MTS_VARIANT RadicalInverseSampler<Float, Spectrum>::RadicalInverseSampler(
+    const RadicalInverseSampler &sampler)
+    : Base(Properties()), m_inverse(sampler.m_inverse) {
+    m_sample_count          = sampler.m_sample_count;
+    m_samples_per_wavefront = sampler.m_samples_per_wavefront;
+    m_base_seed             = sampler.m_base_seed;
+}
+
+MTS_VARIANT void RadicalInverseSampler<Float, Spectrum>::seed(uint64_t seed_offset,
+                                                              size_t wavefront_size) {
+    Base::seed(seed_offset, wavefront_size);
+    m_scramble_seed = compute_per_sequence_seed((uint32_t) seed_offset);
+}
+
+MTS_VARIANT Float RadicalInverseSampler<Float, Spectrum>::next_1d(Mask) {
+    Assert(seeded());
+    uint32_t dim = m_dimension_index++;
+    Float value = sample(current_sample_index(), dim);
+
+    // Per-sequence Cranley-Patterson rotation
+    value += Float(sample_tea_float(m_scramble_seed, UInt32(dim)));
+    masked(value, value >= 1.f) -= 1.f;
+    return min(value, math::OneMinusEpsilon<Float>);
+}
+
+MTS_VARIANT typename RadicalInverseSampler<Float, Spectrum>::Point2f
+RadicalInverseSampler<Float, Spectrum>::next_2d(Mask active) {
+    Float x = next_1d(active),
+          y = next_1d(active);
+    return Point2f(x, y);
+}
+
+MTS_VARIANT Float
+RadicalInverseSampler<Float, Spectrum>::radical_inverse(const UInt32 &index,
+                                                        uint32_t base_index) const {
+    size_t base = base_index % m_inverse->bases();
+    if constexpr (is_cuda_array_v<Float>)
+        return m_inverse->template eval<Float>(base, UInt64(index));
+    else
+        return m_inverse->template eval_scrambled<Float>(base, UInt64(index));
+}
+
+//! @}
+// =======================================================================
+
 MTS_IMPLEMENT_CLASS_VARIANT(Sampler, Object, "sampler")
 MTS_IMPLEMENT_CLASS_VARIANT(PCG32Sampler, Sampler, "PCG32 sampler")
+MTS_IMPLEMENT_CLASS_VARIANT(RadicalInverseSampler, Sampler, "radical inverse sampler")
 
 MTS_INSTANTIATE_CLASS(Sampler)
 MTS_INSTANTIATE_CLASS(PCG32Sampler)
+MTS_INSTANTIATE_CLASS(RadicalInverseSampler)
 NAMESPACE_END(mitsuba)
@@ -104,6 +104,24 @@ MTS_VARIANT Scene<Float, Spectrum>::Scene(const Properties &props) {
     for (Sensor *sensor: m_sensors)
         sensor->set_scene(this);
 
+    update_hit_compute_flags();
+
+    // Periodic lateral boundary conditions
+    m_periodic = props.has_property("periodic_bbox_min") ||
+                 props.has_property("periodic_bbox_max");
+    m_periodic_max_wraps = (uint32_t) props.size_("periodic_max_wraps", 1000);
+    if (m_periodic) {
+        m_periodic_bbox = ScalarBoundingBox3f(props.point3f("periodic_bbox_min"),
+                                              props.point3f("periodic_bbox_max"));
+        if (!all(m_periodic_bbox.max > m_periodic_bbox.min))
+            Throw("The periodic bounding box must have a positive extent "
+                  "along all axes!");
+        if (m_bbox.valid() && !m_periodic_bbox.contains(m_bbox))
+            Log(Warn, "The scene geometry %s extends beyond the periodic "
+                "bounding box %s. The parts that lie outside are not "
+                "repeated and may be missed.", m_bbox, m_periodic_bbox);
+    }
+
     m_shapes_grad_enabled = false;
 }
 
@@ -118,6 +136,9 @@ MTS_VARIANT typename Scene<Float, Spectrum>::SurfaceInteraction3f
 Scene<Float, Spectrum>::ray_intersect(const Ray3f &ray, Mask active) const {
     MTS_MASKED_FUNCTION(ProfilerPhase::RayIntersect, active);
 
+    if (unlikely(m_periodic))
+        return ray_intersect_periodic(ray, HitComputeFlags::All, active);
+
     if constexpr (is_cuda_array_v<Float>)
         return ray_intersect_gpu(ray, HitComputeFlags::All, active);
     else
@@ -128,6 +149,9 @@ MTS_VARIANT typename Scene<Float, Spectrum>::SurfaceInteraction3f
 Scene<Float, Spectrum>::ray_intersect(const Ray3f &ray, HitComputeFlags flags, Mask active) const {
     MTS_MASKED_FUNCTION(ProfilerPhase::RayIntersect, active);
 
+    if (unlikely(m_periodic))
+        return ray_intersect_periodic(ray, flags, active);
+
     if constexpr (is_cuda_array_v<Float>)
         return ray_intersect_gpu(ray, flags, active);
     else
@@ -136,6 +160,9 @@ Scene<Float, Spectrum>::ray_intersect(const Ray3f &ray, HitComputeFlags flags, M
 
 MTS_VARIANT typename Scene<Float, Spectrum>::PreliminaryIntersection3f
 Scene<Float, Spectrum>::ray_intersect_preliminary(const Ray3f &ray, Mask active) const {
+    if (unlikely(m_periodic))
+        return ray_intersect_preliminary_periodic(ray, active);
+
     if constexpr (is_cuda_array_v<Float>)
         return ray_intersect_preliminary_gpu(ray, active);
     else
@@ -159,12 +186,189 @@ MTS_VARIANT typename Scene<Float, Spectrum>::Mask
 Scene<Float, Spectrum>::ray_test(const Ray3f &ray, Mask active) const {
     MTS_MASKED_FUNCTION(ProfilerPhase::RayTest, active);
 
+    if (unlikely(m_periodic))
+        return ray_test_periodic(ray, active);
+
     if constexpr (is_cuda_array_v<Float>)
         return ray_test_gpu(ray, active);
     else
         return ray_test_cpu(ray, active);
 }
 
+MTS_VARIANT typename Scene<Float, Spectrum>::SurfaceInteraction3f
+Scene<Float, Spectrum>::ray_intersect_periodic(const Ray3f &ray, HitComputeFlags flags,
+                                               Mask active) const {
+    PreliminaryIntersection3f pi = ray_intersect_preliminary_periodic(ray, active);
+    active &= pi.is_valid();
+
+    SurfaceInteraction3f si;
+    if (likely(any(active))) {
+        ScopedPhase sp(ProfilerPhase::CreateSurfaceInteraction);
+        si = pi.compute_surface_interaction(ray, flags, active);
+    } else {
+        si.wavelengths = ray.wavelengths;
+        si.wi = -ray.d;
+        si.t = math::Infinity<Float>;
+    }
+
+    return si;
+}
+
+MTS_VARIANT typename Scene<Float, Spectrum>::PreliminaryIntersection3f
+Scene<Float, Spectrum>::ray_intersect_preliminary_periodic(const Ray3f &ray_, Mask active) const {
+    const ScalarPoint3f &lo = m_periodic_bbox.min, &hi = m_periodic_bbox.max;
+    ScalarVector3f extents = m_periodic_bbox.extents();
+    ScalarFloat eps = math::RayEpsilon<ScalarFloat> * (1.f + hmax(max(abs(lo), abs(hi))));
+
+    Ray3f ray(ray_);
+    Float t_offset = periodic_enter(ray, active);
+
+    PreliminaryIntersection3f pi = zero<PreliminaryIntersection3f>();
+    pi.t = math::Infinity<Float>;
+
+    for (uint32_t i = 0;; ++i) {
+        // Only trace the part of the ray that lies within the cell
+        Float t_exit = periodic_exit(ray);
+        Ray3f segment(ray);
+        segment.maxt = min(ray.maxt, t_exit);
+
+        PreliminaryIntersection3f pi_segment = zero<PreliminaryIntersection3f>();
+        pi_segment.t = math::Infinity<Float>;
+
+        Mask active_segment = active;
+        while (true) {
+            PreliminaryIntersection3f pi_trace;
+            if constexpr (is_cuda_array_v<Float>)
+                pi_trace = ray_intersect_preliminary_gpu(segment, active_segment);
+            else
+                pi_trace = ray_intersect_preliminary_cpu(segment, active_segment);
+            masked(pi_segment, active_segment) = pi_trace;
+
+            /* Medium boundaries lying on a lateral face of the cell are an
+               artifact of the tiling, since the medium continues in the
+               neighboring copy of the cell: skip them */
+            Mask on_face = active_segment && pi_trace.is_valid();
+            if (any_or<true>(on_face))
+                on_face &= pi_trace.shape->is_medium_transition();
+            if (any_or<true>(on_face)) {
+                Point3f p = segment(pi_trace.t);
+                Mask lateral = false;
+                for (size_t k = 0; k < 2; ++k)
+                    lateral |= abs(p[k] - lo[k]) < eps || abs(p[k] - hi[k]) < eps;
+                on_face &= lateral;
+            }
+            if (none_or<false>(on_face))
+                break;
+
+            masked(pi_segment.t, on_face) = math::Infinity<Float>;
+            masked(segment.mint, on_face) = pi_trace.t + eps;
+            active_segment = on_face;
+        }
+
+        Mask hit = active && pi_segment.is_valid();
+        if (any_or<true>(hit)) {
+            // Translation of the copy of the cell that the segment lies in
+            Vector3f offset = ray_(t_offset) - ray.o;
+            for (size_t k = 0; k < 2; ++k)
+                offset[k] = round(offset[k] / extents[k]) * extents[k];
+            offset.z() = 0.f;
+
+            pi_segment.t += t_offset;
+            pi_segment.offset = offset;
+            masked(pi, hit) = pi_segment;
+        }
+
+        active &= !pi_segment.is_valid() && t_exit < ray.maxt;
+        if (none_or<false>(active) || i + 1 >= m_periodic_max_wraps)
+            break;
+
+        masked(t_offset, active) += t_exit;
+        periodic_advance(ray, t_exit, active);
+    }
+
+    return pi;
+}
+
+MTS_VARIANT typename Scene<Float, Spectrum>::Mask
+Scene<Float, Spectrum>::ray_test_periodic(const Ray3f &ray_, Mask active) const {
+    Ray3f ray(ray_);
+    periodic_enter(ray, active);
+
+    Mask hit = false;
+    for (uint32_t i = 0;; ++i) {
+        Float t_exit = periodic_exit(ray);
+        Ray3f segment(ray);
+        segment.maxt = min(ray.maxt, t_exit);
+
+        Mask hit_segment;
+        if constexpr (is_cuda_array_v<Float>)
+            hit_segment = ray_test_gpu(segment, active);
+        else
+            hit_segment = ray_test_cpu(segment, active);
+        hit |= active && hit_segment;
+
+        active &= !hit_segment && t_exit < ray.maxt;
+        if (none_or<false>(active) || i + 1 >= m_periodic_max_wraps)
+            break;
+
+        periodic_advance(ray, t_exit, active);
+    }
+
+    return hit;
+}
+
+MTS_VARIANT Float Scene<Float, Spectrum>::periodic_enter(Ray3f &ray, Mask active) const {
+    const ScalarPoint3f &lo = m_periodic_bbox.min, &hi = m_periodic_bbox.max;
+    ScalarVector3f extents = m_periodic_bbox.extents();
+
+    // Skip the empty space above or below the cell
+    Float t_enter = (select(ray.d.z() > 0.f, lo.z(), hi.z()) - ray.o.z()) / ray.d.z();
+    Mask outside = active && (ray.o.z() < lo.z() || ray.o.z() > hi.z()) &&
+                   t_enter > 0.f && t_enter < ray.maxt;
+    t_enter = select(outside, t_enter, 0.f);
+
+    Point3f o = ray(t_enter);
+    masked(o.z(), outside) = select(ray.d.z() > 0.f, lo.z(), hi.z());
+    for (size_t i = 0; i < 2; ++i) {
+        Float rel = o[i] - lo[i];
+        o[i] = lo[i] + (rel - floor(rel / extents[i]) * extents[i]);
+    }
+
+    masked(ray.o, active) = o;
+    masked(ray.maxt, outside) = ray.maxt - t_enter;
+    masked(ray.mint, outside) = 0.f;
+    return t_enter;
+}
+
+MTS_VARIANT Float Scene<Float, Spectrum>::periodic_exit(const Ray3f &ray) const {
+    const ScalarPoint3f &lo = m_periodic_bbox.min, &hi = m_periodic_bbox.max;
+
+    Vector3f t_face = (select(ray.d > 0.f, Vector3f(hi), Vector3f(lo)) - ray.o) / ray.d;
+    masked(t_face, eq(ray.d, 0.f)) = math::Infinity<Float>;
+
+    Float t_lateral = max(min(t_face.x(), t_face.y()), 0.f);
+    Mask inside = ray.o.z() >= lo.z() && ray.o.z() <= hi.z();
+    return select(inside && t_lateral < t_face.z(), t_lateral, math::Infinity<Float>);
+}
+
+MTS_VARIANT void Scene<Float, Spectrum>::periodic_advance(Ray3f &ray, const Float &t,
+                                                          Mask active) const {
+    const ScalarPoint3f &lo = m_periodic_bbox.min, &hi = m_periodic_bbox.max;
+
+    Vector3f t_face = (select(ray.d > 0.f, Vector3f(hi), Vector3f(lo)) - ray.o) / ray.d;
+    Point3f o = ray(t);
+    for (size_t i = 0; i < 2; ++i) {
+        // Re-enter through the opposite face, or stay within the cell
+        Mask exits = neq(ray.d[i], 0.f) && t_face[i] <= t;
+        o[i] = select(exits, select(ray.d[i] > 0.f, lo[i], hi[i]),
+                      clamp(o[i], lo[i], hi[i]));
+    }
+
+    masked(ray.o, active) = o;
+    masked(ray.maxt, active) = ray.maxt - t;
+    masked(ray.mint, active) = 0.f;
+}
+
 MTS_VARIANT std::pair<typename Scene<Float, Spectrum>::DirectionSample3f, Spectrum>
 Scene<Float, Spectrum>::sample_emitter_direction(const Interaction3f &ref, const Point2f &sample_,
                                                  bool test_visibility, Mask active) const {
@@ -244,23 +448,29 @@ MTS_VARIANT void Scene<Float, Spectrum>::traverse(TraversalCallback *callback) {
 }
 
 MTS_VARIANT void Scene<Float, Spectrum>::parameters_changed(const std::vector<std::string> &keys) {
+    std::vector<Shape *> changed_shapes;
+    for (auto &s : m_shapes) {
+        if (string::contains(keys, s->id()) || string::contains(keys, s->class_()->name()))
+            changed_shapes.push_back(s.get());
+    }
+
+    if (!changed_shapes.empty()) {
+        m_bbox.reset();
+        for (auto &s : m_shapes)
+            m_bbox.expand(s->bbox());
+    }
+
     if (m_environment)
         m_environment->set_scene(this); // TODO use parameters_changed({"scene"})
 
-    bool update_accel = false;
-    for (auto &s : m_shapes) {
-        if (string::contains(keys, s->id()) || string::contains(keys, s->class_()->name())) {
-            update_accel = true;
-            break;
-        }
-    }
+    // A BSDF or emitter may have become spatially varying
+    update_hit_compute_flags();
 
-    if (update_accel) {
+    if (!changed_shapes.empty()) {
         if constexpr (is_cuda_array_v<Float>)
             accel_parameters_changed_gpu();
-        else {
-            // TODO update Embree BVH or Mitsuba kdtree if necessary
-        }
+        else
+            accel_parameters_changed_cpu(changed_shapes);
     }
 
     // Checks whether any of the shape's parameters require gradient
@@ -273,6 +483,12 @@ MTS_VARIANT void Scene<Float, Spectrum>::parameters_changed(const std::vector<st
     }
 }
 
+MTS_VARIANT void Scene<Float, Spectrum>::update_hit_compute_flags() {
+    m_hit_compute_flags = HitComputeFlags::Minimal | HitComputeFlags::ShadingFrame;
+    for (Shape *shape : m_shapes)
+        m_hit_compute_flags = m_hit_compute_flags | shape->hit_compute_flags();
+}
+
 MTS_VARIANT std::string Scene<Float, Spectrum>::to_string() const {
     std::ostringstream oss;
     oss << "Scene[" << std::endl
@@ -38,6 +38,49 @@ MTS_VARIANT void Scene<Float, Spectrum>::accel_init_cpu(const Properties &/*prop
     Log(Info, "Embree ready. (took %s)", util::time_string(timer.value()));
 }
 
+MTS_VARIANT void Scene<Float, Spectrum>::accel_parameters_changed_cpu(const std::vector<Shape *> &shapes) {
+    if constexpr (!is_cuda_array_v<Float>) {
+        using Mesh = mitsuba::Mesh<Float, Spectrum>;
+        Timer timer;
+        RTCScene embree_scene = (RTCScene) m_accel;
+
+        /* Only the geometries of the updated shapes are touched. Since the
+           scene is dynamic, Embree keeps the BVHs of the other geometries and
+           only rebuilds the top-level hierarchy. */
+        for (size_t i = 0; i < m_shapes.size(); ++i) {
+            Shape *shape = m_shapes[i];
+            if (std::find(shapes.begin(), shapes.end(), shape) == shapes.end())
+                continue;
+
+            RTCGeometry geom = rtcGetGeometry(embree_scene, (unsigned int) i);
+
+            /* Meshes whose index buffer was left untouched have the same
+               topology: their BVH only needs to be refitted */
+            if (shape->is_mesh()) {
+                Mesh *mesh = (Mesh *) shape;
+                if (rtcGetGeometryBufferData(geom, RTC_BUFFER_TYPE_INDEX, 0) ==
+                    (void *) mesh->faces_buffer().data()) {
+                    rtcSetSharedGeometryBuffer(geom, RTC_BUFFER_TYPE_VERTEX, 0, RTC_FORMAT_FLOAT3,
+                                               mesh->vertex_positions_buffer().data(), 0,
+                                               3 * sizeof(float), mesh->vertex_count());
+                    rtcSetGeometryBuildQuality(geom, RTC_BUILD_QUALITY_REFIT);
+                    rtcCommitGeometry(geom);
+                    continue;
+                }
+            }
+
+            // Otherwise, replace the geometry altogether
+            rtcDetachGeometry(embree_scene, (unsigned int) i);
+            geom = shape->embree_geometry(__embree_device);
+            rtcAttachGeometryByID(embree_scene, geom, (unsigned int) i);
+            rtcReleaseGeometry(geom);
+        }
+
+        rtcCommitScene(embree_scene);
+        Log(Debug, "Embree updated. (took %s)", util::time_string(timer.value()));
+    }
+}
+
 MTS_VARIANT void Scene<Float, Spectrum>::accel_release_cpu() {
     rtcReleaseScene((RTCScene) m_accel);
 }
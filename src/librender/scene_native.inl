@@ -1,6 +1,11 @@
 NAMESPACE_BEGIN(mitsuba)
 
 MTS_VARIANT void Scene<Float, Spectrum>::accel_init_cpu(const Properties &props) {
+    for (const std::string &name : props.property_names()) {
+        if (string::starts_with(name, "kd_"))
+            m_accel_props.copy_attribute(props, name, name);
+    }
+
     ShapeKDTree *kdtree = new ShapeKDTree(props);
     kdtree->inc_ref();
     for (Shape *shape : m_shapes)
@@ -9,22 +14,101 @@ MTS_VARIANT void Scene<Float, Spectrum>::accel_init_cpu(const Properties &props)
     m_accel = kdtree;
 }
 
+MTS_VARIANT void Scene<Float, Spectrum>::accel_parameters_changed_cpu(const std::vector<Shape *> &shapes) {
+    /* The kd-tree cannot be refitted: its split planes are fixed and each
+       primitive is referenced by the leaves that it overlaps. Instead, the
+       shapes that change are moved to a secondary kd-tree, which is the only
+       one that needs to be rebuilt when the same shapes are updated again
+       (e.g. animated geometry). */
+    ShapeKDTree *kdtree = (ShapeKDTree *) m_accel;
+    if (m_shapes_dynamic.empty())
+        m_shapes_dynamic.resize(m_shapes.size(), false);
+
+    bool rebuild_static = false;
+    for (size_t i = 0; i < m_shapes.size(); ++i) {
+        if (!m_shapes_dynamic[i] &&
+            std::find(shapes.begin(), shapes.end(), m_shapes[i].get()) != shapes.end()) {
+            m_shapes_dynamic[i] = true;
+            rebuild_static = true;
+        }
+    }
+
+    size_t prim_count = 0, dynamic_prim_count = 0;
+    for (size_t i = 0; i < m_shapes.size(); ++i) {
+        size_t count = m_shapes[i]->primitive_count();
+        prim_count += count;
+        if (m_shapes_dynamic[i])
+            dynamic_prim_count += count;
+    }
+
+    // Two trees only pay off if the changing geometry is a small part of the scene
+    if (2 * dynamic_prim_count > prim_count) {
+        std::fill(m_shapes_dynamic.begin(), m_shapes_dynamic.end(), false);
+        dynamic_prim_count = 0;
+        rebuild_static = true;
+    }
+
+    if (rebuild_static) {
+        kdtree->clear();
+        for (size_t i = 0; i < m_shapes.size(); ++i) {
+            if (!m_shapes_dynamic[i])
+                kdtree->add_shape(m_shapes[i]);
+        }
+        kdtree->build();
+    }
+
+    ShapeKDTree *kdtree_dynamic = (ShapeKDTree *) m_accel_dynamic;
+    if (dynamic_prim_count > 0) {
+        if (!kdtree_dynamic) {
+            kdtree_dynamic = new ShapeKDTree(m_accel_props);
+            kdtree_dynamic->inc_ref();
+            m_accel_dynamic = kdtree_dynamic;
+        } else {
+            kdtree_dynamic->clear();
+        }
+        for (size_t i = 0; i < m_shapes.size(); ++i) {
+            if (m_shapes_dynamic[i])
+                kdtree_dynamic->add_shape(m_shapes[i]);
+        }
+        kdtree_dynamic->build();
+    } else if (kdtree_dynamic) {
+        kdtree_dynamic->dec_ref();
+        m_accel_dynamic = nullptr;
+    }
+}
+
 MTS_VARIANT void Scene<Float, Spectrum>::accel_release_cpu() {
     ((ShapeKDTree *) m_accel)->dec_ref();
     m_accel = nullptr;
+    if (m_accel_dynamic) {
+        ((ShapeKDTree *) m_accel_dynamic)->dec_ref();
+        m_accel_dynamic = nullptr;
+    }
 }
 
 MTS_VARIANT typename Scene<Float, Spectrum>::PreliminaryIntersection3f
 Scene<Float, Spectrum>::ray_intersect_preliminary_cpu(const Ray3f &ray, Mask active) const {
     const ShapeKDTree *kdtree = (const ShapeKDTree *) m_accel;
-    return kdtree->template ray_intersect_preliminary<false>(ray, active);
+    PreliminaryIntersection3f pi = kdtree->template ray_intersect_preliminary<false>(ray, active);
+
+    if (unlikely(m_accel_dynamic)) {
+        const ShapeKDTree *kdtree_dynamic = (const ShapeKDTree *) m_accel_dynamic;
+
+        // Only look for intersections closer than the one found so far
+        Ray3f ray_dynamic(ray);
+        masked(ray_dynamic.maxt, pi.is_valid()) = pi.t;
+
+        PreliminaryIntersection3f pi_dynamic =
+            kdtree_dynamic->template ray_intersect_preliminary<false>(ray_dynamic, active);
+        masked(pi, pi_dynamic.is_valid()) = pi_dynamic;
+    }
+
+    return pi;
 }
 
 MTS_VARIANT typename Scene<Float, Spectrum>::SurfaceInteraction3f
 Scene<Float, Spectrum>::ray_intersect_cpu(const Ray3f &ray, HitComputeFlags flags, Mask active) const {
-    const ShapeKDTree *kdtree = (const ShapeKDTree *) m_accel;
-
-    PreliminaryIntersection3f pi = kdtree->template ray_intersect_preliminary<false>(ray, active);
+    PreliminaryIntersection3f pi = ray_intersect_preliminary_cpu(ray, active);
     active &= pi.is_valid();
 
     SurfaceInteraction3f si;
@@ -45,6 +129,17 @@ Scene<Float, Spectrum>::ray_intersect_naive_cpu(const Ray3f &ray, Mask active) c
     const ShapeKDTree *kdtree = (const ShapeKDTree *) m_accel;
 
     auto pi = kdtree->template ray_intersect_naive<false>(ray, active);
+
+    if (unlikely(m_accel_dynamic)) {
+        const ShapeKDTree *kdtree_dynamic = (const ShapeKDTree *) m_accel_dynamic;
+
+        Ray3f ray_dynamic(ray);
+        masked(ray_dynamic.maxt, pi.is_valid()) = pi.t;
+
+        auto pi_dynamic = kdtree_dynamic->template ray_intersect_naive<false>(ray_dynamic, active);
+        masked(pi, pi_dynamic.is_valid()) = pi_dynamic;
+    }
+
     active &= pi.is_valid();
 
     SurfaceInteraction3f si;
@@ -63,7 +158,16 @@ Scene<Float, Spectrum>::ray_intersect_naive_cpu(const Ray3f &ray, Mask active) c
 MTS_VARIANT typename Scene<Float, Spectrum>::Mask
 Scene<Float, Spectrum>::ray_test_cpu(const Ray3f &ray, Mask active) const {
     const ShapeKDTree *kdtree = (ShapeKDTree *) m_accel;
-    return kdtree->template ray_intersect_preliminary<true>(ray, active).is_valid();
+    Mask hit = kdtree->template ray_intersect_preliminary<true>(ray, active).is_valid();
+
+    if (unlikely(m_accel_dynamic)) {
+        const ShapeKDTree *kdtree_dynamic = (const ShapeKDTree *) m_accel_dynamic;
+        active &= !hit;
+        if (any(active))
+            hit |= kdtree_dynamic->template ray_intersect_preliminary<true>(ray, active).is_valid();
+    }
+
+    return hit;
 }
 
 NAMESPACE_END(mitsuba)
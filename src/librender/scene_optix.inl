@@ -414,6 +414,7 @@ Scene<Float, Spectrum>::ray_intersect_preliminary_gpu(const Ray3f &ray_, Mask ac
         pi.instance =
             gather<ShapePtr>(reinterpret_array<ShapePtr>(s.shapes_ptr),
                              instance_index, active & valid_instances);
+        pi.offset = zero<Vector3f>(ray_count);
 
         return pi;
     } else {
@@ -530,8 +531,13 @@ Scene<Float, Spectrum>::ray_intersect_gpu(const Ray3f &ray_, HitComputeFlags fla
         si.wavelengths = ray.wavelengths;
         si.duv_dx = si.duv_dy = zero<Point2f>();
 
-        if (has_flag(flags, HitComputeFlags::ShadingFrame))
-            si.initialize_sh_frame();
+        if (has_flag(flags, HitComputeFlags::ShadingFrame)) {
+            // Without position partials, any frame around the normal will do
+            if (has_flag(flags, HitComputeFlags::dPdUV))
+                si.initialize_sh_frame();
+            else
+                si.sh_frame = Frame3f(si.sh_frame.n);
+        }
 
         // Only gather instance pointers for valid instance indices
         Mask valid_instances = instance_index < m_shapes.size();
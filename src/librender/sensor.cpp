@@ -84,6 +84,28 @@ Sensor<Float, Spectrum>::sample_ray_differential(Float time, Float sample1, cons
     return { result_ray, result_spec };
 }
 
+MTS_VARIANT Spectrum
+Sensor<Float, Spectrum>::eval_direct(const Scene * /* scene */, Float /* time */,
+                                     const Wavelength & /* wavelengths */,
+                                     const Point2f & /* sample2 */,
+                                     const Point2f & /* sample3 */,
+                                     Mask /* active */) const {
+    return zero<Spectrum>();
+}
+
+MTS_VARIANT void
+Sensor<Float, Spectrum>::tally(ImageBlock * /* block */, const Point3f & /* p */,
+                               const UnpolarizedSpectrum & /* absorbed */,
+                               const UnpolarizedSpectrum & /* scattered */,
+                               const Wavelength & /* wavelengths */,
+                               Mask /* active */) const {
+    NotImplementedError("tally");
+}
+
+MTS_VARIANT std::vector<std::string> Sensor<Float, Spectrum>::tally_channels() const {
+    return { };
+}
+
 // =============================================================================
 // ProjectiveCamera interface
 // =============================================================================
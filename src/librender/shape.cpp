@@ -88,6 +88,22 @@ MTS_VARIANT Shape<Float, Spectrum>::~Shape() {
 #endif
 }
 
+MTS_VARIANT HitComputeFlags Shape<Float, Spectrum>::hit_compute_flags() const {
+    HitComputeFlags flags = HitComputeFlags::Minimal | HitComputeFlags::ShadingFrame;
+
+    if (m_bsdf) {
+        uint32_t bsdf_flags = m_bsdf->flags();
+        if (has_flag(bsdf_flags, BSDFFlags::SpatiallyVarying) ||
+            has_flag(bsdf_flags, BSDFFlags::Anisotropic))
+            flags = flags | HitComputeFlags::UV | HitComputeFlags::dPdUV;
+    }
+
+    if (m_emitter && has_flag(m_emitter->flags(), EmitterFlags::SpatiallyVarying))
+        flags = flags | HitComputeFlags::UV;
+
+    return flags;
+}
+
 MTS_VARIANT std::string Shape<Float, Spectrum>::id() const {
     return m_id;
 }
@@ -107,7 +123,7 @@ template <typename Float, typename Spectrum>
 void embree_bbox(const struct RTCBoundsFunctionArguments* args) {
     MTS_IMPORT_TYPES(Shape)
     const Shape* shape = (const Shape*) args->geometryUserPtr;
-    ScalarBoundingBox3f bbox = shape->bbox();
+    ScalarBoundingBox3f bbox = shape->bbox(args->primID);
     RTCBounds* bounds_o = args->bounds_o;
     bounds_o->lower_x = bbox.min.x();
     bounds_o->lower_y = bbox.min.y();
@@ -121,6 +137,7 @@ template <typename Float, typename Spectrum>
 void embree_intersect_scalar(int* valid,
                              void* geometryUserPtr,
                              unsigned int geomID,
+                             unsigned int primID,
                              unsigned int instID,
                              RTCRay* rtc_ray,
                              RTCHit* rtc_hit) {
@@ -146,17 +163,17 @@ void embree_intersect_scalar(int* valid,
 
     // Check whether this is a shadow ray or not
     if (rtc_hit) {
-        auto pi = shape->ray_intersect_preliminary(ray);
+        auto pi = shape->ray_intersect_primitive(primID, ray);
         if (pi.is_valid()) {
             rtc_ray->tfar = pi.t;
             rtc_hit->u = pi.prim_uv.x();
             rtc_hit->v = pi.prim_uv.y();
             rtc_hit->geomID = geomID;
-            rtc_hit->primID = 0;
+            rtc_hit->primID = pi.prim_index;
             rtc_hit->instID[0] = instID;
         }
     } else {
-        if (shape->ray_test(ray))
+        if (shape->ray_test_primitive(primID, ray))
             rtc_ray->tfar = -math::Infinity<Float>;
     }
 }
@@ -165,6 +182,7 @@ template <typename Float, typename Spectrum>
 void embree_intersect_packet(int* valid,
                              void* geometryUserPtr,
                              unsigned int geomID,
+                             unsigned int primID,
                              unsigned int instID,
                              RTCRayW* rays,
                              RTCHitW* hits) {
@@ -192,16 +210,16 @@ void embree_intersect_packet(int* valid,
 
     // Check whether this is a shadow ray or not
     if (hits) {
-        auto pi = shape->ray_intersect_preliminary(ray, active);
+        auto pi = shape->ray_intersect_primitive(primID, ray, active);
         active &= pi.is_valid();
         store(rays->tfar,   pi.t, active);
         store(hits->u,      pi.prim_uv.x(), active);
         store(hits->v,      pi.prim_uv.y(), active);
         store(hits->geomID, Int(geomID), active);
-        store(hits->primID, Int(0), active);
+        store(hits->primID, Int(pi.prim_index), active);
         store(hits->instID[0], Int(instID), active);
     } else {
-        active &= shape->ray_test(ray);
+        active &= shape->ray_test_primitive(primID, ray, active);
         store(rays->tfar, Float(-math::Infinity<Float>), active);
     }
 }
@@ -212,12 +230,12 @@ void embree_intersect(const RTCIntersectFunctionNArguments* args) {
         RTCRayHit *rh = (RTCRayHit *) args->rayhit;
         embree_intersect_scalar<Float, Spectrum>(
             args->valid, args->geometryUserPtr, args->geomID,
-            args->context->instID[0], (RTCRay *) &rh->ray, (RTCHit *) &rh->hit);
+            args->primID, args->context->instID[0], (RTCRay *) &rh->ray, (RTCHit *) &rh->hit);
     } else {
         RTCRayHitW *rh = (RTCRayHitW *) args->rayhit;
         embree_intersect_packet<Float, Spectrum>(
             args->valid, args->geometryUserPtr, args->geomID,
-            args->context->instID[0], (RTCRayW *) &rh->ray,
+            args->primID, args->context->instID[0], (RTCRayW *) &rh->ray,
             (RTCHitW *) &rh->hit);
     }
 }
@@ -227,18 +245,18 @@ void embree_occluded(const RTCOccludedFunctionNArguments* args) {
     if constexpr (!is_array_v<Float>) {
         embree_intersect_scalar<Float, Spectrum>(
             args->valid, args->geometryUserPtr, args->geomID,
-            args->context->instID[0], (RTCRay *) args->ray, nullptr);
+            args->primID, args->context->instID[0], (RTCRay *) args->ray, nullptr);
     } else {
         embree_intersect_packet<Float, Spectrum>(
             args->valid, args->geometryUserPtr, args->geomID,
-            args->context->instID[0], (RTCRayW *) args->ray, nullptr);
+            args->primID, args->context->instID[0], (RTCRayW *) args->ray, nullptr);
     }
 }
 
 MTS_VARIANT RTCGeometry Shape<Float, Spectrum>::embree_geometry(RTCDevice device) {
     if constexpr (!is_cuda_array_v<Float>) {
         RTCGeometry geom = rtcNewGeometry(device, RTC_GEOMETRY_TYPE_USER);
-        rtcSetGeometryUserPrimitiveCount(geom, 1);
+        rtcSetGeometryUserPrimitiveCount(geom, primitive_count());
         rtcSetGeometryUserData(geom, (void *) this);
         rtcSetGeometryBoundsFunction(geom, embree_bbox<Float, Spectrum>, nullptr);
         rtcSetGeometryIntersectFunction(geom, embree_intersect<Float, Spectrum>);
@@ -333,6 +351,20 @@ Shape<Float, Spectrum>::ray_test(const Ray3f &ray, Mask active) const {
     return ray_intersect_preliminary(ray, active).is_valid();
 }
 
+MTS_VARIANT typename Shape<Float, Spectrum>::PreliminaryIntersection3f
+Shape<Float, Spectrum>::ray_intersect_primitive(ScalarIndex /*prim_index*/,
+                                                const Ray3f &ray, Mask active) const {
+    MTS_MASK_ARGUMENT(active);
+    return ray_intersect_preliminary(ray, active);
+}
+
+MTS_VARIANT typename Shape<Float, Spectrum>::Mask
+Shape<Float, Spectrum>::ray_test_primitive(ScalarIndex /*prim_index*/,
+                                           const Ray3f &ray, Mask active) const {
+    MTS_MASK_ARGUMENT(active);
+    return ray_test(ray, active);
+}
+
 MTS_VARIANT typename Shape<Float, Spectrum>::SurfaceInteraction3f
 Shape<Float, Spectrum>::compute_surface_interaction(const Ray3f & /*ray*/,
                                                     PreliminaryIntersection3f /*pi*/,
@@ -6,6 +6,7 @@ NAMESPACE_BEGIN(mitsuba)
 
 MTS_VARIANT ShapeGroup<Float, Spectrum>::ShapeGroup(const Properties &props) {
     m_id = props.id();
+    m_hit_compute_flags = HitComputeFlags::Minimal | HitComputeFlags::ShadingFrame;
 
 #if !defined(MTS_ENABLE_EMBREE)
     m_kdtree = new ShapeKDTree(props);
@@ -26,8 +27,9 @@ MTS_VARIANT ShapeGroup<Float, Spectrum>::ShapeGroup(const Properties &props) {
             if (shape->is_sensor())
                 Throw("Instancing of sensors is not supported");
             else {
-#if defined(MTS_ENABLE_EMBREE) || defined(MTS_ENABLE_OPTIX)
+                m_hit_compute_flags = m_hit_compute_flags | shape->hit_compute_flags();
                 m_shapes.push_back(shape);
+#if defined(MTS_ENABLE_EMBREE) || defined(MTS_ENABLE_OPTIX)
                 m_bbox.expand(shape->bbox());
 #endif
 #if !defined(MTS_ENABLE_EMBREE)
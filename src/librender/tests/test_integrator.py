@@ -148,6 +148,70 @@ def test06_render_timeout(variants_cpu_rgb, int_name):
     assert ek.allclose(timeout, effective, atol=0.5)
 
 
+def test07_render_concurrent(variants_cpu_rgb):
+    import threading
+    from mitsuba.core import Bitmap, Struct, ThreadEnvironment, ScopedSetThreadEnvironment
+
+    # Independent renders running concurrently from Python threads, each
+    # restricted to a subset of the cores
+    scenes = [SCENES['teapot']['factory']() for i in range(3)]
+    integrators = [make_integrator('path') for i in range(3)]
+    status = [False] * 3
+    env = ThreadEnvironment()
+
+    def render(i):
+        with ScopedSetThreadEnvironment(env):
+            status[i] = integrators[i].render(scenes[i], scenes[i].sensors()[0],
+                                              thread_count=2)
+
+    threads = [threading.Thread(target=render, args=(i,)) for i in range(3)]
+    for t in threads:
+        t.start()
+    for t in threads:
+        t.join()
+
+    assert all(status)
+    for scene in scenes:
+        film = scene.sensors()[0].film()
+        converted = film.bitmap(raw=True).convert(Bitmap.PixelFormat.RGBA, Struct.Type.Float32, False)
+        means = np.mean(np.array(converted, copy=False), axis=(0, 1))
+        assert ek.allclose(means, SCENES['teapot']['full'], rtol=5e-2)
+
+    if mitsuba.core.MTS_ENABLE_EMBREE:
+        return
+
+    # A kd-tree build must let other Python threads run in the meantime
+    import time
+    from mitsuba.core import Properties
+    from mitsuba.render import ShapeKDTree
+    from .mesh_generation import create_stairs
+
+    kdtree = ShapeKDTree(Properties())
+    kdtree.add_shape(create_stairs(20000))
+    build_time = [0, 0]
+    ticks = []
+    done = threading.Event()
+
+    def build():
+        with ScopedSetThreadEnvironment(env):
+            build_time[0] = time.perf_counter()
+            kdtree.build()
+            build_time[1] = time.perf_counter()
+            done.set()
+
+    def tick():
+        while not done.is_set():
+            ticks.append(time.perf_counter())
+
+    threads = [threading.Thread(target=build), threading.Thread(target=tick)]
+    for t in threads:
+        t.start()
+    for t in threads:
+        t.join()
+
+    assert any(build_time[0] < t < build_time[1] for t in ticks)
+
+
 def make_reference_renders():
     mitsuba.set_variant('scalar_rgb')
     from mitsuba.core import Bitmap, Struct
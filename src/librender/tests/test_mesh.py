@@ -648,3 +648,98 @@ def test16_differentiable_surface_interaction_params_backward(variant_gpu_autodi
     assert ek.allclose(ek.gradient(params[vertex_texcoords_key]),
                        [0, 2, 0, 0, 0, 0, 0, -2], atol=1e-5)
 
+
+@fresolver_append_path
+def test17_ply_shared_geometry(variant_scalar_rgb):
+    from mitsuba.core import Ray3f
+    from mitsuba.core.xml import load_string
+
+    """Shapes loading the same file with different transforms are turned into
+    instances of a single shape group when the scene opts in."""
+    scene = load_string("""
+        <scene version="2.0.0">
+            <boolean name="deduplicate_shapes" value="true"/>
+            <bsdf type="diffuse" id="bsdf"/>
+            <shape type="ply">
+                <string name="filename" value="data/triangle.ply"/>
+                <ref id="bsdf"/>
+            </shape>
+            <shape type="ply">
+                <string name="filename" value="data/triangle.ply"/>
+                <transform name="to_world">
+                    <translate x="2"/>
+                </transform>
+                <ref id="bsdf"/>
+            </shape>
+            <shape type="ply">
+                <string name="filename" value="data/triangle.ply"/>
+                <boolean name="face_normals" value="true"/>
+            </shape>
+        </scene>
+    """)
+
+    shapes = scene.shapes()
+    assert len(shapes) == 3
+    assert sum(str(s).startswith('Instance[') for s in shapes) == 2
+
+    for x in [0, 2]:
+        ray = Ray3f([x - 1, 0.2, 0.2], [1, 0, 0], 0, [])
+        si = scene.ray_intersect(ray)
+        assert si.is_valid()
+        assert ek.allclose(si.t, 1)
+        assert ek.allclose(si.p, [x, 0.2, 0.2])
+
+    # Deduplication is off by default
+    scene = load_string("""
+        <scene version="2.0.0">
+            <shape type="ply">
+                <string name="filename" value="data/triangle.ply"/>
+            </shape>
+            <shape type="ply">
+                <string name="filename" value="data/triangle.ply"/>
+                <transform name="to_world">
+                    <translate x="2"/>
+                </transform>
+            </shape>
+        </scene>
+    """)
+    assert not any(str(s).startswith('Instance[') for s in scene.shapes())
+
+
+@fresolver_append_path
+def test18_ply_shared_geometry_parameters(variant_scalar_rgb):
+    from mitsuba.core import Ray3f, ScalarTransform4f
+    from mitsuba.core.xml import load_string
+
+    """A deduplicated shape still exposes its transform, and updating it
+    moves the corresponding instance only."""
+    scene = load_string("""
+        <scene version="2.0.0">
+            <boolean name="deduplicate_shapes" value="true"/>
+            <shape type="ply" id="tri_a">
+                <string name="filename" value="data/triangle.ply"/>
+            </shape>
+            <shape type="ply" id="tri_b">
+                <string name="filename" value="data/triangle.ply"/>
+                <transform name="to_world">
+                    <translate x="2"/>
+                </transform>
+            </shape>
+        </scene>
+    """)
+
+    params = traverse(scene)
+    assert 'tri_a.to_world' in params
+    assert 'tri_b.to_world' in params
+
+    params['tri_a.to_world'] = ScalarTransform4f.translate([4, 0, 0])
+    params.update()
+
+    def hit(x):
+        ray = Ray3f([x - 1, 0.2, 0.2], [1, 0, 0], 0, [])
+        si = scene.ray_intersect(ray)
+        return si.is_valid() and ek.allclose(si.p, [x, 0.2, 0.2])
+
+    assert not hit(0)
+    assert hit(2)
+    assert hit(4)
@@ -102,3 +102,250 @@ def test03_shapes_parameters_grad_enabled(variant_gpu_autodiff_rgb):
     params.set_dirty(shape_param_key)
     params.update()
     assert scene.shapes_grad_enabled() == True
+
+
+@fresolver_append_path
+def test04_parameters_changed_accel_update(variant_scalar_rgb):
+    from mitsuba.core import Ray3f
+    from mitsuba.core.xml import load_string
+    from mitsuba.python.util import traverse
+
+    scene = load_string("""
+        <scene version="2.0.0">
+            <shape type="ply" id="tri">
+                <string name="filename" value="data/triangle.ply"/>
+            </shape>
+            <shape type="sphere">
+                <point name="center" x="0" y="0" z="10"/>
+            </shape>
+        </scene>
+    """)
+
+    ray = Ray3f([-1, 0.2, 0.2], [1, 0, 0], 0, [])
+    assert ek.allclose(scene.ray_intersect(ray).t, 1)
+
+    params = traverse(scene)
+    key = 'tri.vertex_positions_buf'
+
+    # Move the triangle along the x axis several times
+    for offset in [2, 4]:
+        positions = params[key]
+        for i in range(3):
+            positions[3 * i] = positions[3 * i] + 2
+        params.set_dirty(key)
+        params.update()
+
+        si = scene.ray_intersect(ray)
+        assert si.is_valid()
+        assert ek.allclose(si.t, 1 + offset)
+        assert scene.ray_test(ray)
+        assert ek.allclose(scene.bbox().min[0], -1)
+        assert ek.allclose(scene.bbox().max[0], offset)
+
+        # The other shape is still found
+        ray_sphere = Ray3f([0, 0, 0], [0, 0, 1], 0, [])
+        assert ek.allclose(scene.ray_intersect(ray_sphere).t, 9)
+
+
+def test05_hit_compute_flags(variant_scalar_rgb):
+    from mitsuba.core import Frame3f
+    from mitsuba.core.xml import load_dict
+    from mitsuba.render import HitComputeFlags, Ray3f
+
+    minimal = HitComputeFlags.Minimal | HitComputeFlags.ShadingFrame
+
+    # Untextured BSDFs only require the shading frame
+    scene = load_dict({
+        "type": "scene",
+        "sphere": {"type": "sphere", "bsdf": {"type": "diffuse"}},
+        "rect": {"type": "rectangle", "bsdf": {"type": "roughconductor"}},
+    })
+    assert scene.hit_compute_flags() == minimal
+
+    # The shading frame is still orthonormal without position partials
+    ray = Ray3f([0, 0, -10], [0, 0, 1], 0, [])
+    si = scene.ray_intersect(ray, scene.hit_compute_flags())
+    assert ek.allclose(si.sh_frame.n, [0, 0, -1])
+    assert ek.allclose(ek.norm(si.sh_frame.s), 1)
+    assert ek.allclose(ek.dot(si.sh_frame.s, si.sh_frame.n), 0)
+    assert ek.allclose(Frame3f.cos_theta(si.wi), 1)
+
+    # Textures, anisotropic BSDFs and textured emitters request UVs
+    checkerboard = {"type": "checkerboard"}
+    for shape in [
+        {"type": "sphere", "bsdf": {"type": "diffuse", "reflectance": checkerboard}},
+        {"type": "sphere", "bsdf": {"type": "twosided", "bsdf": {
+            "type": "diffuse", "reflectance": checkerboard}}},
+        {"type": "sphere", "bsdf": {"type": "roughconductor",
+                                    "alpha_u": 0.1, "alpha_v": 0.2}},
+        {"type": "sphere", "emitter": {"type": "area", "radiance": checkerboard}},
+    ]:
+        flags = load_dict({"type": "scene", "shape": shape}).hit_compute_flags()
+        assert flags & HitComputeFlags.UV
+        assert flags & HitComputeFlags.ShadingFrame
+
+
+def test06_periodic_boundaries(variant_scalar_rgb):
+    from mitsuba.core import ScalarTransform4f
+    from mitsuba.core.xml import load_dict
+    from mitsuba.render import Ray3f
+
+    def make_scene(periodic):
+        scene_dict = {
+            "type": "scene",
+            "sphere": {
+                "type": "sphere",
+                "to_world": ScalarTransform4f.scale(0.5)
+            }
+        }
+        if periodic:
+            scene_dict["periodic_bbox_min"] = [-1, -1, -1]
+            scene_dict["periodic_bbox_max"] = [1, 1, 1]
+        return load_dict(scene_dict)
+
+    scene = make_scene(True)
+    assert scene.is_periodic()
+    assert not make_scene(False).is_periodic()
+
+    # Leaving through the +X face re-enters through the -X face. The hit is
+    # reported on the neighboring copy of the sphere, consistently with si.t
+    ray = Ray3f([0.9, 0, 0], [1, 0, 0], 0, [])
+    si = scene.ray_intersect(ray)
+    assert si.is_valid()
+    assert ek.allclose(si.t, 0.6)
+    assert ek.allclose(si.p, [1.5, 0, 0])
+    assert ek.allclose(si.n, [-1, 0, 0])
+    assert scene.ray_test(ray)
+
+    pi = scene.ray_intersect_preliminary(ray)
+    assert ek.allclose(pi.t, 0.6)
+    assert ek.allclose(pi.offset, [2, 0, 0])
+    assert ek.allclose(pi.compute_surface_interaction(ray).p, [1.5, 0, 0])
+    assert not make_scene(False).ray_intersect(ray).is_valid()
+
+    # Shadow rays stop at their maximum extent
+    ray.maxt = 0.5
+    assert not scene.ray_test(ray)
+
+    # Rays far from the cell hit a copy of the sphere
+    ray = Ray3f([10.2, 0.1, 5], [0, 0, -1], 0, [])
+    si = scene.ray_intersect(ray)
+    assert si.is_valid()
+    assert ek.allclose(si.p[0], 10.2)
+    assert ek.allclose(si.t, 5 - si.p[2])
+    assert ek.allclose(si.p, ray(si.t))
+
+    # Rays leaving vertically or never hitting anything terminate
+    ray = Ray3f([0.9, 0, 0], [0, 0, 1], 0, [])
+    assert not scene.ray_intersect(ray).is_valid()
+    ray = Ray3f([0, 0.9, 0], [1, 0, 0], 0, [])
+    assert not scene.ray_intersect(ray).is_valid()
+    assert not scene.ray_test(ray)
+
+
+def test07_periodic_medium(variant_scalar_rgb):
+    """A medium filling the periodic cell continues across its lateral faces"""
+    import numpy as np
+    from mitsuba.core import ScalarTransform4f, Bitmap, Struct
+    from mitsuba.core.xml import load_dict
+    from mitsuba.render import Ray3f
+
+    sigma_t = 0.3
+    origin = [0, 0, 0.5]
+    direction = np.array([1, 0.3, 0.2]) / np.linalg.norm([1, 0.3, 0.2])
+
+    scene = load_dict({
+        "type": "scene",
+        "periodic_bbox_min": [-1, -1, 0],
+        "periodic_bbox_max": [1, 1, 1],
+        "medium": {
+            "type": "heterogeneous",
+            "id": "medium",
+            "periodic": True,
+            "sigma_t": {"type": "constvolume", "color": sigma_t},
+            "albedo": {"type": "constvolume", "color": 0.0}
+        },
+        "slab": {
+            "type": "cube",
+            "to_world": ScalarTransform4f.translate([0, 0, 0.5]) *
+                        ScalarTransform4f.scale([1, 1, 0.5]),
+            "bsdf": {"type": "null"},
+            "interior": {"type": "ref", "id": "medium"}
+        },
+        "sensor": {
+            "type": "radiancemeter",
+            "origin": origin,
+            "direction": direction.tolist(),
+            "medium": {"type": "ref", "id": "medium"},
+            "film": {
+                "type": "hdrfilm",
+                "width": 1,
+                "height": 1,
+                "rfilter": {"type": "box"}
+            },
+            "sampler": {"type": "independent", "sample_count": 4096}
+        },
+        "emitter": {"type": "constant", "radiance": {"type": "uniform", "value": 1.0}},
+        "integrator": {"type": "volpath"}
+    })
+
+    # The off-axis ray wraps twice before leaving through the top of the slab
+    distance = 0.5 / direction[2]
+    assert origin[0] + distance * direction[0] > 3
+
+    ray = Ray3f(origin, direction, 0, [])
+    si = scene.ray_intersect(ray)
+    assert si.is_valid()
+    assert ek.allclose(si.t, distance)
+    assert ek.allclose(si.p, ray(si.t))
+    assert ek.allclose(si.p[2], 1)
+
+    sensor = scene.sensors()[0]
+    scene.integrator().render(scene, sensor)
+    img = sensor.film().bitmap(raw=True).convert(Bitmap.PixelFormat.Y,
+                                                 Struct.Type.Float32, srgb_gamma=False)
+    assert ek.allclose(np.array(img), np.exp(-sigma_t * distance), rtol=0.05)
+
+
+def test08_hit_compute_flags_update(variant_scalar_rgb):
+    from mitsuba.core.xml import load_dict
+    from mitsuba.render import BSDF, BSDFFlags, HitComputeFlags, Ray3f, register_bsdf
+
+    class MyBSDF(BSDF):
+        def __init__(self, props):
+            BSDF.__init__(self, props)
+            self.reflectance = load_dict({"type": "uniform", "value": 0.5})
+            self.parameters_changed([])
+
+        def parameters_changed(self, keys):
+            self.m_flags = BSDFFlags.DiffuseReflection | BSDFFlags.FrontSide
+            if self.reflectance.is_spatially_varying():
+                self.m_flags = self.m_flags | BSDFFlags.SpatiallyVarying
+            self.m_components = [self.m_flags]
+
+        def to_string(self):
+            return "MyBSDF[]"
+
+    register_bsdf("mybsdf_flags", lambda props: MyBSDF(props))
+
+    scene = load_dict({
+        "type": "scene",
+        "disk": {"type": "disk", "bsdf": {"type": "mybsdf_flags"}},
+    })
+    assert not (scene.hit_compute_flags() & HitComputeFlags.UV)
+
+    ray = Ray3f([0, 0.5, -10], [0, 0, 1], 0, [])
+    si = scene.ray_intersect(ray, scene.hit_compute_flags())
+    assert si.is_valid()
+    assert ek.allclose(si.uv, [0, 0])
+
+    # Swap the uniform reflectance for a texture, then propagate the update
+    # to the parents as ParameterMap.update() does
+    bsdf = scene.shapes()[0].bsdf()
+    bsdf.reflectance = load_dict({"type": "checkerboard"})
+    bsdf.parameters_changed(["reflectance"])
+    scene.parameters_changed(["bsdf"])
+
+    assert scene.hit_compute_flags() & HitComputeFlags.UV
+    si = scene.ray_intersect(ray, scene.hit_compute_flags())
+    assert ek.allclose(si.uv, [0.5, 0.25])
@@ -111,6 +111,12 @@ Volume<Float, Spectrum>::eval_gradient(const Interaction3f & /*it*/, Mask /*acti
     NotImplementedError("eval_gradient");
 }
 
+MTS_VARIANT void Volume<Float, Spectrum>::eval_fields(const Interaction3f &it,
+                                                      UnpolarizedSpectrum *fields,
+                                                      Mask active) const {
+    fields[0] = eval(it, active);
+}
+
 MTS_VARIANT typename Volume<Float, Spectrum>::ScalarFloat
 Volume<Float, Spectrum>::max() const { NotImplementedError("max"); }
 
@@ -20,14 +20,32 @@ public:
 
     HeterogeneousMedium(const Properties &props) : Base(props) {
         m_is_homogeneous = false;
-        m_albedo = props.volume<Volume>("albedo", 0.75f);
-        m_sigmat = props.volume<Volume>("sigma_t", 1.f);
+        if (props.has_property("fields")) {
+            // Extinction and albedo are stored together in a single volume
+            m_sigmat = props.volume<Volume>("fields");
+            if (m_sigmat->field_count() != 2)
+                Throw("The \"fields\" volume must provide two fields "
+                      "(sigma_t and albedo), got %i!", m_sigmat->field_count());
+            if (props.has_property("sigma_t") || props.has_property("albedo"))
+                Throw("\"fields\" cannot be combined with \"sigma_t\" or \"albedo\"!");
+        } else {
+            m_albedo = props.volume<Volume>("albedo", 0.75f);
+            m_sigmat = props.volume<Volume>("sigma_t", 1.f);
+        }
 
         m_scale = props.float_("scale", 1.0f);
         m_has_spectral_extinction = props.bool_("has_spectral_extinction", true);
 
         m_max_density = m_scale * m_sigmat->max();
         m_aabb        = m_sigmat->bbox();
+
+        /* In scenes with periodic boundaries, the medium repeats laterally.
+           Its volumes should then use wrap_mode="repeat" with a period that
+           matches the scene's periodic cell. */
+        if (props.bool_("periodic", false)) {
+            m_aabb.min.x() = m_aabb.min.y() = -math::Infinity<ScalarFloat>;
+            m_aabb.max.x() = m_aabb.max.y() = math::Infinity<ScalarFloat>;
+        }
     }
 
     UnpolarizedSpectrum
@@ -42,8 +60,16 @@ public:
     get_scattering_coefficients(const MediumInteraction3f &mi,
                                 Mask active) const override {
         MTS_MASKED_FUNCTION(ProfilerPhase::MediumEvaluate, active);
-        auto sigmat = m_scale * m_sigmat->eval(mi, active);
-        auto sigmas = sigmat * m_albedo->eval(mi, active);
+        UnpolarizedSpectrum sigmat, sigmas;
+        if (m_albedo) {
+            sigmat = m_scale * m_sigmat->eval(mi, active);
+            sigmas = sigmat * m_albedo->eval(mi, active);
+        } else {
+            UnpolarizedSpectrum fields[2];
+            m_sigmat->eval_fields(mi, fields, active);
+            sigmat = m_scale * fields[0];
+            sigmas = sigmat * fields[1];
+        }
         auto sigman = get_combined_extinction(mi, active) - sigmat;
         return { sigmas, sigman, sigmat };
     }
@@ -55,23 +81,31 @@ public:
 
     void traverse(TraversalCallback *callback) override {
         callback->put_parameter("scale", m_scale);
-        callback->put_object("albedo", m_albedo.get());
-        callback->put_object("sigma_t", m_sigmat.get());
+        if (m_albedo) {
+            callback->put_object("albedo", m_albedo.get());
+            callback->put_object("sigma_t", m_sigmat.get());
+        } else {
+            callback->put_object("fields", m_sigmat.get());
+        }
         Base::traverse(callback);
     }
 
     std::string to_string() const override {
         std::ostringstream oss;
-        oss << "HeterogeneousMedium[" << std::endl
-            << "  albedo  = " << string::indent(m_albedo) << std::endl
-            << "  sigma_t = " << string::indent(m_sigmat) << std::endl
-            << "  scale   = " << string::indent(m_scale) << std::endl
+        oss << "HeterogeneousMedium[" << std::endl;
+        if (m_albedo)
+            oss << "  albedo  = " << string::indent(m_albedo) << std::endl
+                << "  sigma_t = " << string::indent(m_sigmat) << std::endl;
+        else
+            oss << "  fields  = " << string::indent(m_sigmat) << std::endl;
+        oss << "  scale   = " << string::indent(m_scale) << std::endl
             << "]";
         return oss.str();
     }
 
     MTS_DECLARE_CLASS()
 private:
+    /// Extinction (or all fields when they are fused), and albedo
     ref<Volume> m_sigmat, m_albedo;
     ScalarFloat m_scale;
 
@@ -0,0 +1,341 @@
+#include <enoki/stl.h>
+
+#include <mitsuba/core/bbox.h>
+#include <mitsuba/core/frame.h>
+#include <mitsuba/core/math.h>
+#include <mitsuba/core/properties.h>
+#include <mitsuba/core/spectrum.h>
+#include <mitsuba/render/interaction.h>
+#include <mitsuba/render/medium.h>
+#include <mitsuba/render/sampler.h>
+#include <mitsuba/render/scene.h>
+
+NAMESPACE_BEGIN(mitsuba)
+
+/**!
+
+.. _medium-sphericalshell:
+
+Spherical shell medium (:monosp:`sphericalshell`)
+-------------------------------------------------
+
+.. pluginparameters::
+
+ * - center
+   - |point|
+   - Center of the planet (Default: (0, 0, 0))
+ * - radii
+   - |floats|
+   - A strictly increasing list of the :math:`N + 1` radii
+     delimiting the :math:`N` layers of the shell. The first value is the
+     radius of the (empty) inner sphere, e.g. the planet's surface.
+ * - sigma_t
+   - |floats|
+   - A list of the extinction coefficients of the :math:`N`
+     layers. A single value is used for all layers.
+ * - albedo
+   - |floats|
+   - A list of the single scattering albedos of the :math:`N` layers. A
+     single value is used for all layers. (Default: 0.75)
+ * - scale
+   - |float|
+   - Scale factor applied to the extinction coefficients. (Default: 1)
+
+This medium describes a spherically stratified atmosphere made of concentric
+layers with piecewise-constant radiative properties. Free-flight distances are
+sampled by tracking the ray analytically through the layer boundaries, which
+produces no null collisions and only stores the radial profile, regardless of
+the spatial extent of the medium. Transmittance is evaluated in closed form
+from the chord lengths of the ray inside each layer.
+
+The extinction coefficient of this medium does not vary across the
+wavelengths sampled for a single path. Spectral dependence should be handled
+by setting the profile for each monochromatic simulation.
+
+.. code-block:: xml
+
+    <medium type="sphericalshell" id="atmosphere">
+        <point name="center" x="0" y="0" z="0"/>
+        <floats name="radii" value="6378.1, 6380.1, 6385.1, 6478.1"/>
+        <floats name="sigma_t" value="1e-2, 5e-3, 1e-4"/>
+        <float name="albedo" value="0.9"/>
+        <phase type="rayleigh"/>
+    </medium>
+
+*/
+template <typename Float, typename Spectrum>
+class SphericalShellMedium final : public Medium<Float, Spectrum> {
+public:
+    MTS_IMPORT_BASE(Medium, m_is_homogeneous, m_has_spectral_extinction,
+                    m_has_bounding_shell, m_shell_center, m_shell_inner_radius,
+                    m_shell_outer_radius, intersect_bounds)
+    MTS_IMPORT_TYPES(Scene, Sampler)
+
+    using FloatStorage = DynamicBuffer<Float>;
+
+    SphericalShellMedium(const Properties &props) : Base(props) {
+        m_is_homogeneous = false;
+        m_has_spectral_extinction = false;
+
+        FloatArray radii   = props.float_array("radii"),
+                   sigma_t = props.float_array("sigma_t"),
+                   albedo  = props.float_array("albedo", FloatArray(std::vector<double>{ 0.75 }));
+        m_radii.assign(radii.begin(), radii.end());
+        m_sigma_t.assign(sigma_t.begin(), sigma_t.end());
+        m_albedo.assign(albedo.begin(), albedo.end());
+
+        if (m_radii.size() < 2)
+            Throw("SphericalShellMedium: at least two radii must be specified!");
+        size_t layer_count = m_radii.size() - 1;
+
+        if (m_radii[0] < 0.f)
+            Throw("SphericalShellMedium: radii must be positive!");
+        for (size_t i = 0; i < layer_count; ++i)
+            if (!(m_radii[i] < m_radii[i + 1]))
+                Throw("SphericalShellMedium: radii must be strictly increasing!");
+
+        // If a single value is provided, use it for every layer
+        if (m_sigma_t.size() == 1)
+            m_sigma_t.resize(layer_count, m_sigma_t[0]);
+        if (m_albedo.size() == 1)
+            m_albedo.resize(layer_count, m_albedo[0]);
+
+        if (m_sigma_t.size() != layer_count || m_albedo.size() != layer_count)
+            Throw("SphericalShellMedium: 'sigma_t' and 'albedo' must have one "
+                  "value per layer (%i)!", layer_count);
+
+        m_scale = props.float_("scale", 1.f);
+
+        // The shell also serves as the medium's bounding shape
+        m_has_bounding_shell = true;
+        m_shell_center       = props.point3f("center", 0.f);
+        m_shell_inner_radius = m_radii.front();
+        m_shell_outer_radius = m_radii.back();
+
+        m_radii_buf   = FloatStorage::copy(m_radii.data(), m_radii.size());
+        m_sigma_t_buf = FloatStorage::copy(m_sigma_t.data(), layer_count);
+        m_albedo_buf  = FloatStorage::copy(m_albedo.data(), layer_count);
+    }
+
+    UnpolarizedSpectrum
+    get_combined_extinction(const MediumInteraction3f &mi,
+                            Mask active) const override {
+        MTS_MASKED_FUNCTION(ProfilerPhase::MediumEvaluate, active);
+        // Tracking is exact: the majorant is the local extinction
+        return eval_layer(mi.p, active).first;
+    }
+
+    std::tuple<UnpolarizedSpectrum, UnpolarizedSpectrum, UnpolarizedSpectrum>
+    get_scattering_coefficients(const MediumInteraction3f &mi,
+                                Mask active) const override {
+        MTS_MASKED_FUNCTION(ProfilerPhase::MediumEvaluate, active);
+        auto [sigmat, albedo] = eval_layer(mi.p, active);
+        UnpolarizedSpectrum sigman = 0.f;
+        return { sigmat * albedo, sigman, sigmat };
+    }
+
+    std::tuple<Mask, Float, Float>
+    intersect_aabb(const Ray3f &ray) const override {
+        ScalarBoundingBox3f bbox(m_shell_center - m_shell_outer_radius,
+                                 m_shell_center + m_shell_outer_radius);
+        return bbox.ray_intersect(ray);
+    }
+
+    MediumInteraction3f sample_interaction(const Ray3f &ray, Float sample,
+                                           UInt32 channel,
+                                           Mask active) const override {
+        MTS_MASKED_FUNCTION(ProfilerPhase::MediumSample, active);
+        ENOKI_MARK_USED(channel); // Extinction is not spectrally varying
+
+        MediumInteraction3f mi;
+        mi.sh_frame    = Frame3f(ray.d);
+        mi.wi          = -ray.d;
+        mi.time        = ray.time;
+        mi.wavelengths = ray.wavelengths;
+        mi.medium      = this;
+
+        // The inner sphere is skipped by the layer tracking loop itself
+        auto [valid, mint, maxt, hole_mint, hole_maxt] = intersect_bounds(ray);
+        ENOKI_MARK_USED(hole_mint);
+        ENOKI_MARK_USED(hole_maxt);
+        active &= valid;
+        masked(mint, !active) = 0.f;
+        masked(maxt, !active) = math::Infinity<Float>;
+
+        mint = max(ray.mint, mint);
+        maxt = min(ray.maxt, maxt);
+        active &= mint < maxt;
+
+        auto [found, dist, layer] =
+            sample_distance(ray(mint), ray.d, maxt - mint,
+                            -enoki::log(1.f - sample), active);
+
+        Float sampled_t = mint + dist;
+        mi.t            = select(found, sampled_t, math::Infinity<Float>);
+        mi.p            = ray(sampled_t);
+        mi.mint         = mint;
+        mi.hole_mint    = math::Infinity<Float>;
+        mi.hole_maxt    = math::Infinity<Float>;
+
+        Float sigmat = m_scale * gather<Float>(m_sigma_t_buf, layer, found),
+              albedo = gather<Float>(m_albedo_buf, layer, found);
+        mi.sigma_t             = select(found, sigmat, 0.f);
+        mi.sigma_s             = mi.sigma_t * albedo;
+        mi.sigma_n             = 0.f;
+        mi.combined_extinction = mi.sigma_t;
+        return mi;
+    }
+
+    std::pair<UnpolarizedSpectrum, UnpolarizedSpectrum>
+    eval_tr_and_pdf(const MediumInteraction3f &mi,
+                    const SurfaceInteraction3f &si,
+                    Mask active) const override {
+        MTS_MASKED_FUNCTION(ProfilerPhase::MediumEvaluate, active);
+
+        // Recover the start of the sampled segment from its end point
+        Mask surface  = si.t < mi.t;
+        Float t_end   = min(mi.t, si.t);
+        Vector3f d    = -mi.wi;
+        Point3f p_end = select(surface, si.p, mi.p);
+        Float length  = t_end - mi.mint;
+
+        UnpolarizedSpectrum tr =
+            exp(-optical_depth(p_end - length * d, d, length));
+        UnpolarizedSpectrum pdf = select(surface, tr, tr * mi.combined_extinction);
+        return { tr, pdf };
+    }
+
+    /**
+     * \brief Sample a free-flight distance by tracking the ray through the
+     * layer boundaries until the optical depth \c target is reached.
+     *
+     * Returns whether a collision occurred within \c length, the sampled
+     * distance from \c o and the index of the layer containing it.
+     */
+    std::tuple<Mask, Float, UInt32>
+    sample_distance(const Point3f &o_, const Vector3f &d, const Float &length,
+                    const Float &target, Mask active) const {
+        Vector3f o  = o_ - m_shell_center;
+        Float b     = dot(o, d),
+              rmin2 = squared_norm(cross(o, d)),
+              r0    = sqr(m_radii.front());
+
+        UInt32 layer = layer_index(norm(o), active);
+        Mask inward  = b < 0.f;
+        Float s = 0.f, tau = 0.f;
+
+        // A ray starting inside the inner sphere first crosses it
+        Mask in_hole = active && squared_norm(o) < r0;
+        masked(s, in_hole)      = -b + safe_sqrt(r0 - rmin2);
+        masked(inward, in_hole) = false;
+        active &= s < length;
+
+        Mask found = false;
+        Float dist = math::Infinity<Float>;
+        UInt32 found_layer = 0;
+        uint32_t layer_count = (uint32_t) m_sigma_t.size();
+
+        while (any(active)) {
+            Float r_lo = sqr(gather<Float>(m_radii_buf, layer, active)),
+                  r_hi = sqr(gather<Float>(m_radii_buf, layer + 1, active));
+
+            // Next boundary: inner one if it is reached, outer one otherwise
+            Mask cross_lo = inward && r_lo > rmin2;
+            Float s_next  = max(s, select(cross_lo, -b - safe_sqrt(r_lo - rmin2),
+                                                    -b + safe_sqrt(r_hi - rmin2)));
+
+            Float sigmat  = m_scale * gather<Float>(m_sigma_t_buf, layer, active),
+                  tau_seg = sigmat * (min(s_next, length) - s);
+
+            Mask hit = active && tau_seg > 0.f && tau + tau_seg >= target;
+            masked(dist, hit)        = s + (target - tau) / sigmat;
+            masked(found_layer, hit) = layer;
+            found |= hit;
+
+            masked(tau, active) += tau_seg;
+            active &= !hit && s_next < length;
+
+            // Step into the neighboring layer, jumping across the inner sphere
+            Mask into_hole = active && cross_lo && eq(layer, 0u);
+            masked(s, active)    = s_next;
+            masked(s, into_hole) = -b + safe_sqrt(r_lo - rmin2);
+            masked(layer, active && cross_lo && !into_hole) -= 1u;
+            masked(layer, active && !cross_lo) += 1u;
+            masked(inward, active && (!cross_lo || into_hole)) = false;
+            active &= layer < layer_count && s < length;
+        }
+
+        return { found, dist, found_layer };
+    }
+
+    /// Optical depth along the segment of length \c length starting at \c o
+    Float optical_depth(const Point3f &o_, const Vector3f &d,
+                        const Float &length) const {
+        Vector3f o  = o_ - m_shell_center;
+        Float b     = dot(o, d),
+              rmin2 = squared_norm(cross(o, d));
+
+        // Length of the segment inside the sphere of radius r
+        auto chord = [&](ScalarFloat r) {
+            Float h = safe_sqrt(sqr(r) - rmin2);
+            return select(sqr(r) > rmin2,
+                          max(0.f, min(length, -b + h) - max(0.f, -b - h)),
+                          0.f);
+        };
+
+        Float tau = 0.f, chord_lo = chord(m_radii[0]);
+        for (size_t i = 0; i < m_sigma_t.size(); ++i) {
+            Float chord_hi = chord(m_radii[i + 1]);
+            tau += m_sigma_t[i] * (chord_hi - chord_lo);
+            chord_lo = chord_hi;
+        }
+        return m_scale * tau;
+    }
+
+    void traverse(TraversalCallback *callback) override {
+        callback->put_parameter("scale", m_scale);
+        Base::traverse(callback);
+    }
+
+    std::string to_string() const override {
+        std::ostringstream oss;
+        oss << "SphericalShellMedium[" << std::endl
+            << "  center  = " << m_shell_center << "," << std::endl
+            << "  radii   = " << string::indent(m_radii) << "," << std::endl
+            << "  sigma_t = " << string::indent(m_sigma_t) << "," << std::endl
+            << "  albedo  = " << string::indent(m_albedo) << "," << std::endl
+            << "  scale   = " << m_scale << std::endl
+            << "]";
+        return oss.str();
+    }
+
+    MTS_DECLARE_CLASS()
+private:
+    /// Index of the layer containing the radius \c r (clamped to valid layers)
+    UInt32 layer_index(const Float &r, Mask active) const {
+        return math::find_interval(
+            (uint32_t) m_radii.size(),
+            [&](UInt32 idx, Mask active_) {
+                return gather<Float>(m_radii_buf, idx, active && active_) <= r;
+            });
+    }
+
+    /// Extinction and albedo of the layer containing \c p (zero outside)
+    std::pair<Float, Float> eval_layer(const Point3f &p, Mask active) const {
+        Float r = norm(p - m_shell_center);
+        active &= r >= m_radii.front() && r <= m_radii.back();
+        UInt32 layer = layer_index(r, active);
+        Float sigmat = m_scale * gather<Float>(m_sigma_t_buf, layer, active),
+              albedo = gather<Float>(m_albedo_buf, layer, active);
+        return { select(active, sigmat, 0.f), albedo };
+    }
+
+private:
+    std::vector<ScalarFloat> m_radii, m_sigma_t, m_albedo;
+    FloatStorage m_radii_buf, m_sigma_t_buf, m_albedo_buf;
+    ScalarFloat m_scale;
+};
+
+MTS_IMPLEMENT_CLASS_VARIANT(SphericalShellMedium, Medium)
+MTS_EXPORT_PLUGIN(SphericalShellMedium, "Spherical shell medium")
+NAMESPACE_END(mitsuba)
@@ -0,0 +1,69 @@
+import pytest
+
+import enoki as ek
+import mitsuba
+
+
+def make_medium(inner_radius=1.0, outer_radius=2.0):
+    from mitsuba.core.xml import load_dict
+
+    return load_dict({
+        "type": "homogeneous",
+        "sigma_t": 1.0,
+        "albedo": 0.5,
+        "bounding_shell_center": [0, 0, 0],
+        "bounding_shell_inner_radius": inner_radius,
+        "bounding_shell_outer_radius": outer_radius,
+    })
+
+
+def test_construct(variant_scalar_rgb):
+    medium = make_medium()
+    assert medium is not None
+    assert medium.has_bounding_shell()
+
+    with pytest.raises(RuntimeError):
+        make_medium(inner_radius=3.0, outer_radius=2.0)
+
+
+def test_intersect_bounds(variant_scalar_rgb):
+    from mitsuba.core import Ray3f
+
+    medium = make_medium()
+
+    # Ray crossing the inner sphere: the active segment has a hole
+    ray = Ray3f([-10, 0, 0], [1, 0, 0], 0, [])
+    valid, mint, maxt, hole_mint, hole_maxt = medium.intersect_bounds(ray)
+    assert valid
+    assert ek.allclose([mint, maxt], [8, 12])
+    assert ek.allclose([hole_mint, hole_maxt], [9, 11])
+
+    # Ray grazing the shell: no hole
+    ray = Ray3f([-10, 1.5, 0], [1, 0, 0], 0, [])
+    valid, mint, maxt, hole_mint, hole_maxt = medium.intersect_bounds(ray)
+    assert valid
+    assert ek.isinf(hole_mint)
+
+    # Ray missing the shell
+    ray = Ray3f([-10, 3, 0], [1, 0, 0], 0, [])
+    valid, _, _, _, _ = medium.intersect_bounds(ray)
+    assert not valid
+
+
+def test_sample_interaction(variant_scalar_rgb):
+    from mitsuba.core import Ray3f
+
+    medium = make_medium()
+    ray = Ray3f([-10, 0, 0], [1, 0, 0], 0, [])
+
+    # An optical depth of 1.5 lands halfway through the second segment
+    sample = 1.0 - ek.exp(-1.5)
+    mi = medium.sample_interaction(ray, sample, 0)
+    assert mi.is_valid()
+    assert ek.allclose(mi.t, 11.5)
+    assert ek.allclose(mi.active_distance(mi.t), 1.5)
+
+    # Past the end of the shell, the interaction is invalid
+    sample = 1.0 - ek.exp(-2.5)
+    mi = medium.sample_interaction(ray, sample, 0)
+    assert not mi.is_valid()
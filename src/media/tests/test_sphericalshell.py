@@ -0,0 +1,73 @@
+import pytest
+
+import enoki as ek
+import mitsuba
+
+
+def make_medium():
+    from mitsuba.core.xml import load_dict
+
+    return load_dict({
+        "type": "sphericalshell",
+        "radii": "1, 2, 3",
+        "sigma_t": "1, 2",
+        "albedo": "0.5",
+    })
+
+
+def test_construct(variant_scalar_rgb):
+    from mitsuba.core.xml import load_dict
+
+    medium = make_medium()
+    assert medium is not None
+    assert medium.has_bounding_shell()
+
+    with pytest.raises(RuntimeError):
+        load_dict({"type": "sphericalshell", "radii": "1, 3, 2", "sigma_t": "1"})
+
+    with pytest.raises(RuntimeError):
+        load_dict({"type": "sphericalshell", "radii": "1, 2, 3", "sigma_t": "1, 2, 3"})
+
+
+@pytest.mark.parametrize("optical_depth, t, sigma_t", [
+    (1.5, 7.75, 2.0),  # Outer layer, on the way in
+    (2.5, 8.5, 1.0),   # Inner layer, on the way in
+    (3.5, 11.5, 1.0),  # Inner layer, after skipping the inner sphere
+    (5.0, 12.5, 2.0),  # Outer layer, on the way out
+])
+def test_sample_interaction(variant_scalar_rgb, optical_depth, t, sigma_t):
+    from mitsuba.core import Ray3f
+    from mitsuba.render import SurfaceInteraction3f
+
+    medium = make_medium()
+    ray = Ray3f([-10, 0, 0], [1, 0, 0], 0, [])
+
+    mi = medium.sample_interaction(ray, 1.0 - ek.exp(-optical_depth), 0)
+    assert mi.is_valid()
+    assert ek.allclose(mi.t, t)
+    assert ek.allclose(mi.sigma_t, sigma_t)
+    assert ek.allclose(mi.sigma_s, 0.5 * sigma_t)
+    assert ek.allclose(mi.sigma_n, 0.0)
+
+    # Transmittance is consistent with the sampled optical depth
+    si = SurfaceInteraction3f()
+    si.t = float("inf")
+    tr, pdf = medium.eval_tr_and_pdf(mi, si)
+    assert ek.allclose(tr, ek.exp(-optical_depth))
+    assert ek.allclose(pdf, ek.exp(-optical_depth) * sigma_t)
+
+
+def test_sample_interaction_escape(variant_scalar_rgb):
+    from mitsuba.core import Ray3f
+
+    medium = make_medium()
+
+    # Total optical depth along this ray is 6
+    ray = Ray3f([-10, 0, 0], [1, 0, 0], 0, [])
+    mi = medium.sample_interaction(ray, 1.0 - ek.exp(-6.5), 0)
+    assert not mi.is_valid()
+
+    # Ray missing the shell
+    ray = Ray3f([-10, 4, 0], [1, 0, 0], 0, [])
+    mi = medium.sample_interaction(ray, 0.5, 0)
+    assert not mi.is_valid()
@@ -0,0 +1,82 @@
+import pytest
+
+import enoki as ek
+import mitsuba
+
+
+def make_medium(**kwargs):
+    from mitsuba.core import ScalarTransform4f
+    from mitsuba.core.xml import load_dict
+
+    # Two layers of leaves with an area of 4, one per voxel layer
+    return load_dict({
+        "type": "turbid",
+        "resolution": "2, 2, 2",
+        "sample_count": 200000,
+        "reflectance": 0.4,
+        "transmittance": 0.5,
+        "bottom": {
+            "type": "rectangle",
+            "to_world": ScalarTransform4f.translate([0, 0, -1])
+        },
+        "top": {
+            "type": "rectangle",
+            "to_world": ScalarTransform4f.translate([0, 0, 1])
+        },
+        **kwargs
+    })
+
+
+def test01_create(variant_scalar_rgb):
+    from mitsuba.core.xml import load_dict
+
+    medium = make_medium()
+    assert medium is not None
+    assert not medium.is_homogeneous()
+
+    with pytest.raises(RuntimeError):
+        load_dict({"type": "turbid"})
+
+    with pytest.raises(RuntimeError):
+        make_medium(reflectance=0.6, transmittance=0.6)
+
+
+@pytest.mark.parametrize("p", [[-0.5, -0.5, -0.5], [0.5, -0.5, -0.5],
+                               [-0.5, 0.5, 0.5], [0.5, 0.5, 0.5]])
+def test02_leaf_area_density(variant_scalar_rgb, p):
+    from mitsuba.render import MediumInteraction3f
+
+    medium = make_medium()
+    mi = MediumInteraction3f()
+    mi.p = p
+
+    # Each voxel has a volume of 1 and contains a leaf area of 1 (G = 1/2)
+    sigma_s, sigma_n, sigma_t = medium.get_scattering_coefficients(mi)
+    assert ek.allclose(sigma_t, 0.5, rtol=0.05)
+    assert ek.allclose(sigma_s, 0.9 * sigma_t)
+    assert ek.allclose(sigma_n + sigma_t, medium.get_combined_extinction(mi))
+
+
+def test03_write_volume(variant_scalar_rgb, tmpdir):
+    from mitsuba.core.xml import load_dict
+    from mitsuba.render import MediumInteraction3f
+
+    filename = str(tmpdir.join("canopy.vol"))
+    medium = make_medium(filename=filename)
+    grid = load_dict({
+        "type": "heterogeneous",
+        "fields": {
+            "type": "multigridvolume",
+            "filename": filename,
+            "fields": "1, 1",
+            "filter_type": "nearest",
+            "use_grid_bbox": True
+        }
+    })
+
+    for p in [[-0.5, -0.5, -0.5], [0.5, 0.5, 0.5], [0.5, -0.5, 0.5]]:
+        mi = MediumInteraction3f()
+        mi.p = p
+        for a, b in zip(medium.get_scattering_coefficients(mi)[::2],
+                        grid.get_scattering_coefficients(mi)[::2]):
+            assert ek.allclose(a, b)
@@ -0,0 +1,310 @@
+#include <fstream>
+
+#include <enoki/stl.h>
+
+#include <mitsuba/core/plugin.h>
+#include <mitsuba/core/properties.h>
+#include <mitsuba/core/random.h>
+#include <mitsuba/core/string.h>
+#include <mitsuba/render/interaction.h>
+#include <mitsuba/render/medium.h>
+#include <mitsuba/render/phase.h>
+#include <mitsuba/render/shape.h>
+#include <mitsuba/render/shapegroup.h>
+
+NAMESPACE_BEGIN(mitsuba)
+
+/**!
+
+.. _medium-turbid:
+
+Turbid vegetation medium (:monosp:`turbid`)
+-------------------------------------------
+
+.. pluginparameters::
+
+ * - (Nested shapes)
+   - |shape|
+   - Leaves that are converted into the turbid medium, specified as nested
+     shapes (e.g. :ref:`leafcloud <shape-leafcloud>`) or shape groups.
+ * - resolution
+   - |string|
+   - Number of voxels along the X, Y and Z axes (Default: "16, 16, 16")
+ * - sample_count
+   - |int|
+   - Number of points that are sampled on the leaves to estimate the leaf
+     area within each voxel (Default: 1000000)
+ * - reflectance
+   - |float|
+   - Hemispherical reflectance of the leaves (Default: 0.45)
+ * - transmittance
+   - |float|
+   - Hemispherical transmittance of the leaves (Default: 0.45)
+ * - filename
+   - |string|
+   - If specified, the voxelized medium is additionally written to this
+     volume file (Default: none)
+ * - (Nested plugin)
+   - |phase|
+   - Phase function of the medium (Default: :ref:`leafphase <phase-leafphase>`
+     with the leaf reflectance and transmittance)
+
+This plugin converts explicit leaf geometry into an equivalent turbid medium,
+which is much cheaper to render when the vegetation is seen from a distance.
+The bounding box of the leaves is split into voxels, and the leaf area density
+(LAD, the one-sided leaf area per unit volume) of each voxel is estimated by
+sampling points on the leaf surfaces. Following the turbid medium model of
+vegetation :cite:`Ross1981Radiation`, the leaves are assumed to have a
+spherical (uniform) angle distribution and bi-Lambertian optical properties.
+The extinction coefficient of a voxel is then :math:`\sigma_t = G\,
+\mathrm{LAD}` with :math:`G = 1/2`, the single scattering albedo is the sum of
+the leaf reflectance and transmittance, and light is scattered following the
+:ref:`leafphase <phase-leafphase>` phase function.
+
+The leaves are only used during the voxelization and should not be
+instantiated in the scene themselves. When :monosp:`filename` is specified,
+the extinction coefficient and the albedo are written as a two-field volume
+file, which can later be loaded without the leaf geometry:
+
+.. code-block:: xml
+
+    <medium type="heterogeneous">
+        <volume name="fields" type="multigridvolume">
+            <string name="filename" value="canopy.vol"/>
+            <string name="fields" value="1, 1"/>
+            <string name="filter_type" value="nearest"/>
+            <boolean name="use_grid_bbox" value="true"/>
+        </volume>
+        <phase type="leafphase"/>
+    </medium>
+
+.. note:: The voxelization runs on the CPU, and this plugin is not supported
+   in GPU variants.
+
+*/
+template <typename Float, typename Spectrum>
+class TurbidMedium final : public Medium<Float, Spectrum> {
+public:
+    MTS_IMPORT_BASE(Medium, m_is_homogeneous, m_has_spectral_extinction,
+                    m_phase_function)
+    MTS_IMPORT_TYPES(Shape, ShapeGroup, PhaseFunction)
+
+    TurbidMedium(const Properties &props) : Base(props) {
+        if constexpr (is_cuda_array_v<Float>)
+            Throw("The turbid medium is not supported in GPU variants!");
+
+        m_is_homogeneous = false;
+        m_has_spectral_extinction = false;
+
+        auto tokens = string::tokenize(props.string("resolution", "16, 16, 16"));
+        if (tokens.size() != 3)
+            Throw("\"resolution\" must specify three voxel counts!");
+        for (size_t i = 0; i < 3; ++i) {
+            int value = std::stoi(tokens[i]);
+            if (value <= 0)
+                Throw("Invalid resolution %i, must be positive!", value);
+            m_resolution[i] = (uint32_t) value;
+        }
+
+        m_reflectance   = props.float_("reflectance", 0.45f);
+        m_transmittance = props.float_("transmittance", 0.45f);
+        if (m_reflectance < 0.f || m_transmittance < 0.f ||
+            m_reflectance + m_transmittance > 1.f)
+            Throw("The leaf reflectance and transmittance must be "
+                  "nonnegative, and their sum cannot exceed one!");
+
+        bool has_phase = false;
+        std::vector<ref<Shape>> leaves;
+        for (auto &kv : props.objects()) {
+            if (auto *group = dynamic_cast<ShapeGroup *>(kv.second.get()))
+                for (auto &shape : group->shapes())
+                    leaves.push_back(shape);
+            else if (auto *shape = dynamic_cast<Shape *>(kv.second.get()))
+                leaves.push_back(shape);
+            else if (dynamic_cast<PhaseFunction *>(kv.second.get()))
+                has_phase = true;
+        }
+        if (leaves.empty())
+            Throw("The turbid medium requires at least one nested leaf shape!");
+
+        // The default phase function follows the leaf optical properties
+        if (!has_phase) {
+            Properties props_phase("leafphase");
+            props_phase.set_float("reflectance", m_reflectance);
+            props_phase.set_float("transmittance", m_transmittance);
+            m_phase_function = PluginManager::instance()->create_object<PhaseFunction>(props_phase);
+        }
+
+        std::vector<ScalarFloat> sigmat = voxelize(leaves, props.size_("sample_count", 1000000));
+        m_sigmat = DynamicBuffer<Float>::copy(sigmat.data(), sigmat.size());
+
+        if (props.has_property("filename"))
+            write_volume(props.string("filename"), sigmat);
+    }
+
+    /// Index of the voxel containing the point \c p
+    MTS_INLINE UInt32 voxel_index(const Point3f &p) const {
+        Vector3i p_i = floor2int<Vector3i>((p - m_bbox.min) * m_inv_voxel_size);
+        p_i = clamp(p_i, 0, Vector3i(m_resolution) - 1);
+        return UInt32(p_i.x() + (int32_t) m_resolution.x() *
+                                (p_i.y() + (int32_t) m_resolution.y() * p_i.z()));
+    }
+
+    UnpolarizedSpectrum
+    get_combined_extinction(const MediumInteraction3f & /* mi */,
+                            Mask active) const override {
+        MTS_MASKED_FUNCTION(ProfilerPhase::MediumEvaluate, active);
+        return m_max_sigmat;
+    }
+
+    std::tuple<UnpolarizedSpectrum, UnpolarizedSpectrum, UnpolarizedSpectrum>
+    get_scattering_coefficients(const MediumInteraction3f &mi,
+                                Mask active) const override {
+        MTS_MASKED_FUNCTION(ProfilerPhase::MediumEvaluate, active);
+        UnpolarizedSpectrum sigmat = gather<Float>(m_sigmat, voxel_index(mi.p), active),
+                            sigmas = sigmat * (m_reflectance + m_transmittance),
+                            sigman = m_max_sigmat - sigmat;
+        return { sigmas, sigman, sigmat };
+    }
+
+    std::tuple<Mask, Float, Float>
+    intersect_aabb(const Ray3f &ray) const override {
+        return m_bbox.ray_intersect(ray);
+    }
+
+    std::string to_string() const override {
+        std::ostringstream oss;
+        oss << "TurbidMedium[" << std::endl
+            << "  bbox          = " << string::indent(m_bbox) << "," << std::endl
+            << "  resolution    = " << m_resolution << "," << std::endl
+            << "  leaf_area     = " << m_leaf_area << "," << std::endl
+            << "  reflectance   = " << m_reflectance << "," << std::endl
+            << "  transmittance = " << m_transmittance << "," << std::endl
+            << "  max_sigma_t   = " << m_max_sigmat << std::endl
+            << "]";
+        return oss.str();
+    }
+
+    MTS_DECLARE_CLASS()
+private:
+    /**
+     * \brief Estimate the extinction coefficient of every voxel
+     *
+     * Each leaf receives a share of the sample budget that is proportional to
+     * its area, and every sampled point deposits its share of the leaf area
+     * into the voxel that contains it.
+     */
+    std::vector<ScalarFloat> voxelize(const std::vector<ref<Shape>> &leaves,
+                                      size_t sample_count) {
+        std::vector<ScalarFloat> areas;
+        for (auto &leaf : leaves) {
+            areas.push_back(leaf->surface_area());
+            m_leaf_area += areas.back();
+            m_bbox.expand(leaf->bbox());
+        }
+        if (!(m_leaf_area > 0.f))
+            Throw("The leaves of the turbid medium have no surface area!");
+
+        // Leaves lying in a coordinate plane would yield an empty box
+        ScalarVector3f extents = m_bbox.extents();
+        ScalarFloat eps = math::RayEpsilon<ScalarFloat> * (1.f + hmax(abs(m_bbox.max)));
+        for (size_t i = 0; i < 3; ++i) {
+            if (extents[i] < eps) {
+                m_bbox.min[i] -= eps;
+                m_bbox.max[i] += eps;
+            }
+        }
+        m_inv_voxel_size = ScalarVector3f(m_resolution) / m_bbox.extents();
+
+        std::vector<ScalarFloat> lad(hprod(m_resolution), 0.f);
+        PCG32<uint32_t> rng;
+        constexpr size_t Width = is_array_v<Float> ? array_size_v<Float> : 1;
+
+        for (size_t i = 0; i < leaves.size(); ++i) {
+            if (!(areas[i] > 0.f))
+                continue;
+            size_t n = std::max((size_t) 1, (size_t) std::llround(
+                (double) sample_count * areas[i] / m_leaf_area));
+            ScalarFloat weight = areas[i] / n;
+
+            for (size_t j = 0; j < n; j += Width) {
+                ScalarFloat u[Width], v[Width], px[Width], py[Width], pz[Width];
+                for (size_t k = 0; k < Width; ++k) {
+                    u[k] = rng.next_float32();
+                    v[k] = rng.next_float32();
+                }
+
+                if constexpr (is_array_v<Float>) {
+                    PositionSample3f ps = leaves[i]->sample_position(
+                        0.f, Point2f(load_unaligned<Float>(u), load_unaligned<Float>(v)),
+                        arange<UInt32>() < (uint32_t) (n - j));
+                    store_unaligned(px, ps.p.x());
+                    store_unaligned(py, ps.p.y());
+                    store_unaligned(pz, ps.p.z());
+                } else {
+                    PositionSample3f ps =
+                        leaves[i]->sample_position(0.f, Point2f(u[0], v[0]), true);
+                    px[0] = ps.p.x(); py[0] = ps.p.y(); pz[0] = ps.p.z();
+                }
+
+                for (size_t k = 0; k < std::min(Width, n - j); ++k) {
+                    ScalarPoint3f p(px[k], py[k], pz[k]);
+                    ScalarVector3i p_i = floor2int<ScalarVector3i>((p - m_bbox.min) * m_inv_voxel_size);
+                    p_i = clamp(p_i, 0, ScalarVector3i(m_resolution) - 1);
+                    lad[p_i.x() + m_resolution.x() * (p_i.y() + m_resolution.y() * p_i.z())] += weight;
+                }
+            }
+        }
+
+        // Extinction coefficient of a spherical leaf angle distribution (G = 1/2)
+        ScalarFloat inv_voxel_volume = hprod(m_inv_voxel_size);
+        for (ScalarFloat &value : lad) {
+            value *= .5f * inv_voxel_volume;
+            m_max_sigmat = std::max(m_max_sigmat, value);
+        }
+        return lad;
+    }
+
+    /// Write the extinction and albedo fields to a volume file (VOL, version 3)
+    void write_volume(const std::string &filename,
+                      const std::vector<ScalarFloat> &sigmat) const {
+        std::ofstream f(filename, std::ios::binary);
+        if (!f.good())
+            Throw("Unable to open \"%s\" for writing!", filename);
+
+        auto write = [&f](auto value) {
+            f.write(reinterpret_cast<const char *>(&value), sizeof(value));
+        };
+
+        f.write("VOL", 3);
+        write((uint8_t) 3);
+        write((int32_t) 1);
+        for (size_t i = 0; i < 3; ++i)
+            write((int32_t) m_resolution[i]);
+        write((int32_t) 2);
+        for (size_t i = 0; i < 3; ++i)
+            write((float) m_bbox.min[i]);
+        for (size_t i = 0; i < 3; ++i)
+            write((float) m_bbox.max[i]);
+
+        float albedo = (float) (m_reflectance + m_transmittance);
+        for (ScalarFloat value : sigmat) {
+            write((float) value);
+            write(albedo);
+        }
+        if (!f.good())
+            Throw("Error while writing the volume file \"%s\"!", filename);
+    }
+
+private:
+    DynamicBuffer<Float> m_sigmat;
+    ScalarVector3u m_resolution;
+    ScalarBoundingBox3f m_bbox;
+    ScalarVector3f m_inv_voxel_size;
+    ScalarFloat m_reflectance, m_transmittance;
+    ScalarFloat m_leaf_area = 0.f, m_max_sigmat = 0.f;
+};
+
+MTS_IMPLEMENT_CLASS_VARIANT(TurbidMedium, Medium)
+MTS_EXPORT_PLUGIN(TurbidMedium, "Turbid vegetation medium")
+NAMESPACE_END(mitsuba)
@@ -0,0 +1,134 @@
+#include <mitsuba/core/properties.h>
+#include <mitsuba/core/warp.h>
+#include <mitsuba/render/phase.h>
+
+NAMESPACE_BEGIN(mitsuba)
+
+/**!
+
+.. _phase-leafphase:
+
+Leaf phase function (:monosp:`leafphase`)
+-----------------------------------------
+
+.. pluginparameters::
+
+ * - reflectance
+   - |float|
+   - Hemispherical reflectance of the leaves (Default: 0.45)
+ * - transmittance
+   - |float|
+   - Hemispherical transmittance of the leaves (Default: 0.45)
+
+This plugin implements the area scattering phase function of a turbid medium
+made of small bi-Lambertian leaves with a spherical (uniform) leaf angle
+distribution :cite:`Ross1981Radiation`. Denoting by :math:`\beta` the angle
+between the incident and scattered propagation directions, it is given by
+
+.. math::
+
+    p(\beta) = \frac{\rho}{\rho + \tau}\, p_r(\beta)
+             + \frac{\tau}{\rho + \tau}\, p_r(\pi - \beta),
+    \qquad
+    p_r(\beta) = \frac{2}{3\pi^2} \left(\sin\beta - \beta \cos\beta\right),
+
+where :math:`\rho` and :math:`\tau` are the leaf reflectance and
+transmittance. Reflection by the leaves mostly scatters light backwards,
+transmission forwards. Only the ratio of the two parameters affects the phase
+function: the single scattering albedo :math:`\rho + \tau` is a property of the
+medium. This phase function is used by the :ref:`turbid <medium-turbid>`
+medium, which sets it up automatically.
+
+*/
+template <typename Float, typename Spectrum>
+class LeafPhaseFunction final : public PhaseFunction<Float, Spectrum> {
+public:
+    MTS_IMPORT_BASE(PhaseFunction, m_flags)
+    MTS_IMPORT_TYPES(PhaseFunctionContext)
+
+    LeafPhaseFunction(const Properties &props) : Base(props) {
+        ScalarFloat reflectance   = props.float_("reflectance", 0.45f),
+                    transmittance = props.float_("transmittance", 0.45f);
+        if (reflectance < 0.f || transmittance < 0.f ||
+            !(reflectance + transmittance > 0.f))
+            Log(Error, "The leaf reflectance and transmittance must be "
+                       "nonnegative, and cannot both be zero!");
+
+        m_reflect_prob = reflectance / (reflectance + transmittance);
+        m_flags = +PhaseFunctionFlags::Anisotropic;
+    }
+
+    /// Phase function of the reflecting leaves, \c beta is the scattering angle
+    MTS_INLINE Float eval_reflect(Float beta) const {
+        auto [sin_beta, cos_beta] = enoki::sincos(beta);
+        return (2.f / (3.f * math::Pi<ScalarFloat> * math::Pi<ScalarFloat>)) *
+               enoki::max(sin_beta - beta * cos_beta, 0.f);
+    }
+
+    MTS_INLINE Float eval_leaf(Float cos_beta) const {
+        Float beta = enoki::safe_acos(cos_beta);
+        return m_reflect_prob * eval_reflect(beta) +
+               (1.f - m_reflect_prob) * eval_reflect(math::Pi<ScalarFloat> - beta);
+    }
+
+    std::pair<Vector3f, Float> sample(const PhaseFunctionContext & /* ctx */,
+                                      const MediumInteraction3f &mi, const Point2f &sample,
+                                      Mask active) const override {
+        MTS_MASKED_FUNCTION(ProfilerPhase::PhaseFunctionSample, active);
+
+        // Choose between reflection and transmission, and reuse the sample
+        Mask reflect = sample.x() < m_reflect_prob;
+        Float u = select(reflect, sample.x() / m_reflect_prob,
+                         (sample.x() - m_reflect_prob) / (1.f - m_reflect_prob));
+        u = min(u, math::OneMinusEpsilon<Float>);
+
+        /* Invert the CDF of the scattering angle of the reflection lobe,
+           F(beta) = 4 / (3 pi) * (beta / 2 + beta cos(2 beta) / 4 - 3 sin(2 beta) / 8),
+           using Newton steps safeguarded by bisection */
+        Float a = 0.f, b = math::Pi<ScalarFloat>,
+              beta = math::Pi<ScalarFloat> * enoki::cbrt(u);
+        for (int i = 0; i < 10; ++i) {
+            auto [sin_2beta, cos_2beta] = enoki::sincos(2.f * beta);
+            Float cdf = (4.f / (3.f * math::Pi<ScalarFloat>)) *
+                        (.5f * beta + .25f * beta * cos_2beta - .375f * sin_2beta) - u,
+                  pdf = 2.f * math::Pi<ScalarFloat> * eval_reflect(beta) * enoki::sin(beta);
+
+            masked(a, cdf < 0.f) = beta;
+            masked(b, cdf >= 0.f) = beta;
+
+            Float beta_next = beta - cdf / pdf;
+            beta = select(beta_next > a && beta_next < b, beta_next, .5f * (a + b));
+        }
+        masked(beta, !reflect) = math::Pi<ScalarFloat> - beta;
+
+        auto [sin_beta, cos_beta] = enoki::sincos(beta);
+        auto [sin_phi, cos_phi] = enoki::sincos(2 * math::Pi<ScalarFloat> * sample.y());
+        auto wo = Vector3f(sin_beta * cos_phi, sin_beta * sin_phi, cos_beta);
+        wo = mi.to_world(wo);
+        Float pdf = eval_leaf(cos_beta);
+        return std::make_pair(wo, pdf);
+    }
+
+    Float eval(const PhaseFunctionContext & /* ctx */, const MediumInteraction3f &mi,
+               const Vector3f &wo, Mask active) const override {
+        MTS_MASKED_FUNCTION(ProfilerPhase::PhaseFunctionEvaluate, active);
+        return eval_leaf(-dot(wo, mi.wi));
+    }
+
+    std::string to_string() const override {
+        std::ostringstream oss;
+        oss << "LeafPhaseFunction[" << std::endl
+            << "  reflect_prob = " << string::indent(m_reflect_prob) << std::endl
+            << "]";
+        return oss.str();
+    }
+
+    MTS_DECLARE_CLASS()
+private:
+    /// Fraction of the scattered energy that is due to reflection
+    ScalarFloat m_reflect_prob;
+};
+
+MTS_IMPLEMENT_CLASS_VARIANT(LeafPhaseFunction, PhaseFunction)
+MTS_EXPORT_PLUGIN(LeafPhaseFunction, "Leaf phase function")
+NAMESPACE_END(mitsuba)
@@ -0,0 +1,60 @@
+import numpy as np
+
+import mitsuba
+import pytest
+import enoki as ek
+
+
+def test01_create(variant_scalar_rgb):
+    from mitsuba.core.xml import load_string
+    p = load_string("""<phase version='2.0.0' type='leafphase'>
+        <float name="reflectance" value="0.3"/>
+        <float name="transmittance" value="0.6"/>
+    </phase>""")
+    assert p is not None
+
+
+@pytest.mark.parametrize("reflectance, transmittance", [(0.5, 0.0), (0.0, 0.5), (0.3, 0.6)])
+def test02_eval(variant_scalar_rgb, reflectance, transmittance):
+    from mitsuba.core.math import Pi
+    from mitsuba.render import PhaseFunctionContext, MediumInteraction3f
+    from mitsuba.core.xml import load_dict
+
+    p = load_dict({"type": "leafphase", "reflectance": reflectance,
+                   "transmittance": transmittance})
+    ctx = PhaseFunctionContext(None)
+    mi = MediumInteraction3f()
+    mi.wi = [0, 0, -1]
+    r = reflectance / (reflectance + transmittance)
+
+    def ref(beta):
+        p_r = lambda b: 2 / (3 * Pi**2) * max(np.sin(b) - b * np.cos(b), 0)
+        return r * p_r(beta) + (1 - r) * p_r(np.pi - beta)
+
+    for beta in np.linspace(0, np.pi, 7):
+        wo = [np.sin(beta), 0, np.cos(beta)]
+        assert np.allclose(p.eval(ctx, mi, wo), ref(beta), atol=1e-6)
+
+    # Reflection scatters light backwards, transmission forwards
+    assert np.allclose(p.eval(ctx, mi, [0, 0, -1]), r * 2 / (3 * Pi), atol=1e-6)
+    assert np.allclose(p.eval(ctx, mi, [0, 0, 1]), (1 - r) * 2 / (3 * Pi), atol=1e-6)
+
+
+@pytest.mark.parametrize("reflectance, transmittance", [(0.5, 0.0), (0.3, 0.6)])
+def test03_chi2(variant_packet_rgb, reflectance, transmittance):
+    from mitsuba.python.chi2 import PhaseFunctionAdapter, ChiSquareTest, SphericalDomain
+
+    sample_func, pdf_func = PhaseFunctionAdapter(
+        "leafphase", '<float name="reflectance" value="%f"/>'
+                     '<float name="transmittance" value="%f"/>' % (reflectance, transmittance))
+
+    chi2 = ChiSquareTest(
+        domain = SphericalDomain(),
+        sample_func = sample_func,
+        pdf_func = pdf_func,
+        sample_dim = 2
+    )
+
+    result = chi2.run(0.1)
+    chi2._dump_tables()
+    assert result
@@ -0,0 +1,85 @@
+#include <mitsuba/core/profiler.h>
+#include <mitsuba/core/properties.h>
+#include <mitsuba/core/spectrum.h>
+#include <mitsuba/render/sampler.h>
+
+NAMESPACE_BEGIN(mitsuba)
+
+/**!
+
+.. _sampler-halton:
+
+Halton sampler (:monosp:`halton`)
+---------------------------------
+
+.. pluginparameters::
+
+ * - sample_count
+   - |int|
+   - Number of samples per pixel (Default: 4)
+ * - seed
+   - |int|
+   - Seed offset (Default: 0)
+ * - scramble
+   - |int|
+   - Selects the digit permutations applied to the radical inverse: -1 uses
+     the Faure permutations, any other value builds pseudorandom permutations
+     seeded by this value (Default: -1)
+
+This plugin implements a Quasi-Monte Carlo sample generator based on the
+`Halton sequence <https://en.wikipedia.org/wiki/Halton_sequence>`_. The
+:math:`k`-th dimension of the :math:`i`-th sample is given by the radical
+inverse of :math:`i` in the :math:`k`-th prime base. The implementation relies
+on the precomputed prime bases and digit permutation tables of
+:monosp:`RadicalInverse`, which provides up to 1024 dimensions (prime bases up
+to 8161). Dimensions beyond that wrap around to the first bases.
+
+Unlike :ref:`ldsampler <sampler-ldsampler>`, which reuses the same (0, 2)-sequence
+in every pair of dimensions, all dimensions of the Halton sequence are jointly
+well-distributed, which makes this sampler a good choice for deep (e.g. volumetric)
+light paths that consume many dimensions. The sample count is not restricted to
+any particular value and can be increased progressively.
+
+Plain Halton points suffer from strong correlations between dimensions with
+large prime bases. These are reduced by running every digit through a
+scrambling permutation (see the :monosp:`scramble` parameter). Each pixel
+furthermore applies its own random toroidal shift (Cranley-Patterson rotation)
+to every dimension, so that neighboring pixels don't use the same sample
+pattern.
+
+.. note:: GPU variants do not support the digit permutations, which are
+   stored in host memory, and only apply the per-pixel rotation.
+
+ */
+
+template <typename Float, typename Spectrum>
+class HaltonSampler final : public RadicalInverseSampler<Float, Spectrum> {
+public:
+    MTS_IMPORT_BASE(RadicalInverseSampler, m_sample_count, m_inverse, radical_inverse)
+    MTS_IMPORT_TYPES()
+
+    HaltonSampler(const Properties &props = Properties()) : Base(props) { }
+
+    ref<Sampler<Float, Spectrum>> clone() override {
+        return new HaltonSampler(*this);
+    }
+
+    std::string to_string() const override {
+        std::ostringstream oss;
+        oss << "HaltonSampler[" << std::endl
+            << "  sample_count = " << m_sample_count << "," << std::endl
+            << "  scramble = " << m_inverse->scramble() << std::endl
+            << "]";
+        return oss.str();
+    }
+
+    MTS_DECLARE_CLASS()
+protected:
+    Float sample(const UInt32 &index, uint32_t dim) const override {
+        return radical_inverse(index, dim);
+    }
+};
+
+MTS_IMPLEMENT_CLASS_VARIANT(HaltonSampler, Sampler)
+MTS_EXPORT_PLUGIN(HaltonSampler, "Halton Sampler");
+NAMESPACE_END(mitsuba)
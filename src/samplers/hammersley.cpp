@@ -0,0 +1,79 @@
+#include <mitsuba/core/profiler.h>
+#include <mitsuba/core/properties.h>
+#include <mitsuba/core/spectrum.h>
+#include <mitsuba/render/sampler.h>
+
+NAMESPACE_BEGIN(mitsuba)
+
+/**!
+
+.. _sampler-hammersley:
+
+Hammersley sampler (:monosp:`hammersley`)
+-----------------------------------------
+
+.. pluginparameters::
+
+ * - sample_count
+   - |int|
+   - Number of samples per pixel (Default: 4)
+ * - seed
+   - |int|
+   - Seed offset (Default: 0)
+ * - scramble
+   - |int|
+   - Selects the digit permutations applied to the radical inverse: -1 uses
+     the Faure permutations, any other value builds pseudorandom permutations
+     seeded by this value (Default: -1)
+
+This plugin implements a Quasi-Monte Carlo sample generator based on the
+Hammersley point set. It is the finite counterpart of the
+:ref:`Halton sampler <sampler-halton>`: the first dimension of the
+:math:`i`-th sample is set to :math:`i/N`, where :math:`N` denotes the number
+of samples per pixel, and the remaining dimensions use the (scrambled) radical
+inverse in successive prime bases. This improves the uniformity of the point
+set compared to the Halton sequence, at the cost that the number of samples
+per pixel must be known in advance and cannot be increased progressively.
+
+As with the Halton sampler, each pixel applies its own random toroidal shift
+(Cranley-Patterson rotation) to every dimension, so that neighboring pixels
+don't use the same sample pattern.
+
+.. note:: GPU variants do not support the digit permutations, which are
+   stored in host memory, and only apply the per-pixel rotation.
+
+ */
+
+template <typename Float, typename Spectrum>
+class HammersleySampler final : public RadicalInverseSampler<Float, Spectrum> {
+public:
+    MTS_IMPORT_BASE(RadicalInverseSampler, m_sample_count, m_inverse, radical_inverse)
+    MTS_IMPORT_TYPES()
+
+    HammersleySampler(const Properties &props = Properties()) : Base(props) { }
+
+    ref<Sampler<Float, Spectrum>> clone() override {
+        return new HammersleySampler(*this);
+    }
+
+    std::string to_string() const override {
+        std::ostringstream oss;
+        oss << "HammersleySampler[" << std::endl
+            << "  sample_count = " << m_sample_count << "," << std::endl
+            << "  scramble = " << m_inverse->scramble() << std::endl
+            << "]";
+        return oss.str();
+    }
+
+    MTS_DECLARE_CLASS()
+protected:
+    Float sample(const UInt32 &index, uint32_t dim) const override {
+        if (dim == 0)
+            return Float(index) / Float(m_sample_count);
+        return radical_inverse(index, dim - 1);
+    }
+};
+
+MTS_IMPLEMENT_CLASS_VARIANT(HammersleySampler, Sampler)
+MTS_EXPORT_PLUGIN(HammersleySampler, "Hammersley Sampler");
+NAMESPACE_END(mitsuba)
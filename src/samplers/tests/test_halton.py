@@ -0,0 +1,131 @@
+import mitsuba
+import pytest
+import enoki as ek
+import numpy as np
+
+from .utils import check_uniform_scalar_sampler, check_uniform_wavefront_sampler
+
+
+def collect_samples(sampler, seed, dims):
+    """Return an array of shape (sample_count, dims) holding the 1D samples"""
+    sampler.seed(seed)
+    values = np.zeros((sampler.sample_count(), dims))
+    for i in range(sampler.sample_count()):
+        for j in range(dims):
+            values[i, j] = sampler.next_1d()
+        if i + 1 < sampler.sample_count():
+            sampler.advance()
+    return values
+
+
+def check_rotated(values, ref, atol=1e-5):
+    """Check that 'values' is a toroidal shift of 'ref' along the first axis"""
+    d = np.abs(((values - values[0]) - (ref - ref[0])) % 1.0)
+    assert np.all(np.minimum(d, 1.0 - d) < atol)
+
+
+@pytest.mark.parametrize("plugin", ["halton", "hammersley"])
+def test01_halton_scalar(variant_scalar_rgb, plugin):
+    from mitsuba.core import xml
+
+    sampler = xml.load_dict({
+        "type" : plugin,
+        "sample_count" : 1024,
+    })
+
+    check_uniform_scalar_sampler(sampler, res=4, atol=6.0)
+
+
+@pytest.mark.parametrize("plugin", ["halton", "hammersley"])
+def test02_halton_wavefront(variant_gpu_rgb, plugin):
+    from mitsuba.core import xml
+
+    sampler = xml.load_dict({
+        "type" : plugin,
+        "sample_count" : 1024,
+    })
+
+    check_uniform_wavefront_sampler(sampler, res=4, atol=6.0)
+
+
+def test03_halton_radical_inverse(variant_scalar_rgb):
+    from mitsuba.core import xml, RadicalInverse
+
+    sampler = xml.load_dict({
+        "type" : "halton",
+        "sample_count" : 64,
+    })
+
+    inv = RadicalInverse()
+    dims = 48
+    ref = np.array([[inv.eval_scrambled(j, i) for j in range(dims)]
+                    for i in range(64)])
+
+    # Every pixel uses a rotated copy of the scrambled Halton sequence
+    v0 = collect_samples(sampler, 0, dims)
+    v1 = collect_samples(sampler, 1, dims)
+    for v in [v0, v1]:
+        assert np.all((v >= 0) & (v < 1))
+        for j in range(dims):
+            check_rotated(v[:, j], ref[:, j])
+
+    # .. but the rotation differs from pixel to pixel
+    assert not np.allclose(v0, v1)
+
+
+def test04_hammersley_radical_inverse(variant_scalar_rgb):
+    from mitsuba.core import xml, RadicalInverse
+
+    sampler = xml.load_dict({
+        "type" : "hammersley",
+        "sample_count" : 64,
+        "scramble" : 7
+    })
+
+    inv = RadicalInverse(scramble=7)
+    dims = 16
+    ref = np.array([[i / 64.0] + [inv.eval_scrambled(j, i) for j in range(dims - 1)]
+                    for i in range(64)])
+
+    v = collect_samples(sampler, 3, dims)
+    for j in range(dims):
+        check_rotated(v[:, j], ref[:, j])
+
+
+@pytest.mark.parametrize("plugin", ["halton", "hammersley"])
+def test05_packet_matches_scalar(variant_packet_rgb, plugin):
+    from mitsuba.core import xml, RadicalInverse
+
+    def evaluate(vectorized):
+        sampler = xml.load_dict({
+            "type" : plugin,
+            "sample_count" : 64,
+            "scramble" : 7
+        })
+        # Python calls return the first lane of the packet evaluation
+        sampler.seed(3)
+        values = np.zeros((64, 16))
+        for i in range(64):
+            for j in range(16):
+                values[i, j] = np.array(sampler.next_1d()).ravel()[0]
+            if i < 63:
+                sampler.advance()
+
+        inv = RadicalInverse(scramble=7)
+        if vectorized:
+            from mitsuba.core import UInt64
+            index = UInt64(np.arange(64, dtype=np.uint64))
+            ref = np.array([np.array(inv.eval_scrambled(j, index)) for j in range(16)]).T
+        else:
+            ref = np.array([[inv.eval_scrambled(j, i) for j in range(16)]
+                            for i in range(64)])
+        return values, ref
+
+    values_packet, ref_packet = evaluate(True)
+    mitsuba.set_variant("scalar_rgb")
+    values_scalar, ref_scalar = evaluate(False)
+    mitsuba.set_variant("packet_rgb")
+
+    # The vectorized radical inverse matches the scalar sequence in every lane
+    assert np.allclose(ref_packet, ref_scalar, atol=1e-6)
+    assert np.allclose(values_packet, values_scalar, atol=1e-6)
@@ -2,7 +2,10 @@
 #include <mitsuba/core/properties.h>
 #include <mitsuba/core/transform.h>
 #include <mitsuba/core/warp.h>
+#include <mitsuba/render/bsdf.h>
+#include <mitsuba/render/emitter.h>
 #include <mitsuba/render/fwd.h>
+#include <mitsuba/render/scene.h>
 #include <mitsuba/render/sensor.h>
 #include <mitsuba/render/texture.h>
 
@@ -21,6 +24,15 @@ Irradiance meter (:monosp:`irradiancemeter`)
    - |spectrum|
    - If set, sensor response function used to sample wavelengths from. This 
      parameter is ignored if used with nonspectral variants.
+ * - direct
+   - |bool|
+   - If set, the contribution of delta emitters (e.g. :monosp:`directional`)
+     is evaluated deterministically at the sampled position
+     (Default: |true|)
+ * - direct_samples
+   - |int|
+   - Number of positions per sample at which the delta emitter contribution
+     is evaluated (Default: 1)
 
 This sensor plugin implements an irradiance meter, which measures
 the incident power per unit area over a shape which it is attached to.
@@ -42,12 +54,37 @@ simply instantiate the desired sensor shape and specify an
             <!-- film -->
         </sensor>
     </shape>
+
+The measured irradiance is split into two components. Light arriving from
+delta emitters (:monosp:`directional`, :monosp:`point`, :monosp:`spot`, ...)
+is evaluated analytically at the sampled position on the shape, including a
+shadow test towards every such emitter, which removes all variance due to
+directional sampling from this (often dominant) component. The remaining
+(e.g. environment and indirect) illumination is estimated by tracing a
+cosine-weighted ray from the same position. Since delta emitters can never be
+reached by the traced ray, the two components do not overlap. The shadow test
+accounts for surfaces with a null BSDF (e.g. :monosp:`null` or the transparent
+part of :monosp:`mask`). Since the transmittance of participating media cannot
+be evaluated deterministically, the analytic component is disabled (with a
+warning) when the sensor or any shape of the scene has a medium attached.
+
+To further reduce the variance of the direct component, it can be evaluated
+at several positions per sample (see :monosp:`direct_samples`). These positions
+are stratified over the shape's area, i.e. across the triangles of a mesh.
+Combining this sensor with a stratified sampler (e.g. :monosp:`stratified` or
+:monosp:`ldsampler`) also stratifies the Monte Carlo component over the shape's
+area.
+
+Irradiance meters can also be updated by particle tracing (see the
+:monosp:`ptracer` integrator), which connects each scattering event to a
+position sampled on the shape.
 */
 
 MTS_VARIANT class IrradianceMeter final : public Sensor<Float, Spectrum> {
 public:
-    MTS_IMPORT_BASE(Sensor, m_film, m_world_transform, m_shape)
-    MTS_IMPORT_TYPES(Shape, Texture)
+    MTS_IMPORT_BASE(Sensor, m_film, m_world_transform, m_shape, m_medium,
+                    m_has_direct_estimate, m_has_direction_sampling)
+    MTS_IMPORT_TYPES(Scene, Shape, Texture, BSDFPtr)
 
     IrradianceMeter(const Properties &props) : Base(props), m_srf(nullptr) {
         if (props.has_property("srf")) {
@@ -71,6 +108,42 @@ public:
             0.5f + math::RayEpsilon<Float>)
             Log(Warn, "This sensor should only be used with a reconstruction filter"
                "of radius 0.5 or lower(e.g. default box)");
+
+        m_direct = props.bool_("direct", true);
+        m_direct_samples = props.size_("direct_samples", 1);
+        if (m_direct_samples == 0)
+            Throw("The 'direct_samples' parameter must be greater than zero!");
+
+        m_has_direction_sampling = true;
+    }
+
+    void set_scene(const Scene *scene) override {
+        m_has_direct_estimate = false;
+        if (!m_direct)
+            return;
+
+        for (const auto &emitter : scene->emitters()) {
+            if (has_flag(emitter->flags(), EmitterFlags::DeltaPosition) ||
+                has_flag(emitter->flags(), EmitterFlags::DeltaDirection))
+                m_has_direct_estimate = true;
+        }
+
+        if (!m_has_direct_estimate)
+            return;
+
+        /* The shadow rays of the direct estimate are attenuated by null-BSDF
+           interfaces, but the transmittance of participating media would
+           have to be sampled, which eval_direct() cannot do */
+        bool has_media = m_medium != nullptr;
+        for (const auto &shape : scene->shapes())
+            has_media |= shape->is_medium_transition();
+
+        if (has_media) {
+            Log(Warn, "Disabling the direct estimate of the irradiance meter since "
+                      "the scene contains participating media: light arriving "
+                      "directly from delta emitters will not be measured.");
+            m_has_direct_estimate = false;
+        }
     }
 
     std::pair<RayDifferential3f, Spectrum>
@@ -108,9 +181,97 @@ public:
         );
     }
 
+    Spectrum eval_direct(const Scene *scene, Float time,
+                         const Wavelength &wavelengths,
+                         const Point2f &sample2,
+                         const Point2f & /* sample3 */,
+                         Mask active) const override {
+        MTS_MASKED_FUNCTION(ProfilerPhase::EndpointEvaluate, active);
+
+        Spectrum result(0.f);
+        if (!m_direct)
+            return result;
+
+        ScalarFloat inv_count = 1.f / (ScalarFloat) m_direct_samples;
+
+        for (size_t k = 0; k < m_direct_samples; ++k) {
+            /* Shift the position sample by a rank-1 lattice so that the
+               direct samples are stratified along the dimension that
+               meshes use to select a triangle */
+            Point2f sample(sample2);
+            if (k > 0) {
+                sample += ScalarPoint2f(k * ScalarFloat(0.6180339887498949),
+                                        k * inv_count);
+                sample -= floor(sample);
+            }
+
+            PositionSample3f ps = m_shape->sample_position(time, sample, active);
+
+            Interaction3f it;
+            it.t           = 0.f;
+            it.time        = time;
+            it.wavelengths = wavelengths;
+            it.p           = ps.p;
+
+            for (const auto &emitter : scene->emitters()) {
+                if (!has_flag(emitter->flags(), EmitterFlags::DeltaPosition) &&
+                    !has_flag(emitter->flags(), EmitterFlags::DeltaDirection))
+                    continue;
+
+                auto [ds, spec] = emitter->sample_direction(it, Point2f(.5f), active);
+                Float cos_theta = dot(ps.n, ds.d);
+                Mask valid = active && neq(ds.pdf, 0.f) && cos_theta > 0.f;
+                if (none_or<false>(valid))
+                    continue;
+
+                Ray3f ray(it.p, ds.d, math::RayEpsilon<Float> * (1.f + hmax(abs(it.p))),
+                          ds.dist * (1.f - math::ShadowEpsilon<Float>), time, wavelengths);
+
+                // Shadow test, passing through surfaces with a null BSDF
+                Spectrum transmittance(1.f);
+                Mask active_ray = valid;
+                while (any_or<true>(active_ray)) {
+                    SurfaceInteraction3f si = scene->ray_intersect(ray, active_ray);
+                    active_ray &= si.is_valid();
+                    if (none_or<false>(active_ray))
+                        break;
+
+                    BSDFPtr bsdf = si.bsdf(ray);
+                    Spectrum tr = bsdf->eval_null_transmission(si, active_ray);
+                    tr = si.to_world_mueller(tr, si.wi, si.wi);
+                    masked(transmittance, active_ray) *= tr;
+
+                    Mask blocked = active_ray && all(eq(depolarize(tr), 0.f));
+                    valid &= !blocked;
+                    active_ray &= !blocked;
+
+                    Float maxt = ray.maxt - si.t;
+                    masked(ray, active_ray) = si.spawn_ray(ray.d);
+                    masked(ray.maxt, active_ray) = maxt;
+                    active_ray &= maxt > 0.f;
+                }
+
+                masked(result, valid) += transmittance * spec * cos_theta * inv_count;
+            }
+        }
+
+        /* The integrator multiplies the returned value by the ray weight,
+           which includes a factor of pi (cosine-weighted sampling) */
+        return result * math::InvPi<ScalarFloat>;
+    }
+
     std::pair<DirectionSample3f, Spectrum>
     sample_direction(const Interaction3f &it, const Point2f &sample, Mask active) const override {
-        return std::make_pair(m_shape->sample_direction(it, sample, active), math::Pi<ScalarFloat>);
+        MTS_MASKED_FUNCTION(ProfilerPhase::EndpointSampleDirection, active);
+
+        DirectionSample3f ds = m_shape->sample_direction(it, sample, active);
+
+        // Only light arriving from the side of the surface normal is measured
+        active &= neq(ds.pdf, 0.f) && dot(ds.n, ds.d) < 0.f;
+        ds.uv = Point2f(.5f);
+
+        return std::make_pair(
+            ds, select(active, rcp(m_shape->surface_area() * ds.pdf), 0.f));
     }
 
     Float pdf_direction(const Interaction3f &it, const DirectionSample3f &ds,
@@ -118,8 +279,10 @@ public:
         return m_shape->pdf_direction(it, ds, active);
     }
 
-    Spectrum eval(const SurfaceInteraction3f &/*si*/, Mask /*active*/) const override {
-        return math::Pi<ScalarFloat> / m_shape->surface_area();
+    Spectrum eval(const SurfaceInteraction3f &si, Mask active) const override {
+        MTS_MASKED_FUNCTION(ProfilerPhase::EndpointEvaluate, active);
+        return select(Frame3f::cos_theta(si.wi) > 0.f,
+                      rcp(m_shape->surface_area()), 0.f);
     }
 
     ScalarBoundingBox3f bbox() const override { return m_shape->bbox(); }
@@ -129,6 +292,8 @@ public:
         oss << "IrradianceMeter[" << std::endl
             << "  shape = " << m_shape << "," << std::endl
             << "  film = " << m_film << "," << std::endl
+            << "  direct = " << m_direct << "," << std::endl
+            << "  direct_samples = " << m_direct_samples << std::endl
             << "]";
         return oss.str();
     }
@@ -136,6 +301,8 @@ public:
     MTS_DECLARE_CLASS()
 private:
     ref<Texture> m_srf;
+    bool m_direct;
+    size_t m_direct_samples;
 };
 
 MTS_IMPLEMENT_CLASS_VARIANT(IrradianceMeter, Sensor)
@@ -93,7 +93,8 @@ class PerspectiveCamera final : public ProjectiveCamera<Float, Spectrum> {
 public:
     MTS_IMPORT_BASE(ProjectiveCamera, m_world_transform, m_needs_sample_3,
                     m_film, m_sampler, m_resolution, m_shutter_open,
-                    m_shutter_open_time, m_near_clip, m_far_clip)
+                    m_shutter_open_time, m_near_clip, m_far_clip,
+                    m_has_direction_sampling)
     MTS_IMPORT_TYPES(Texture)
 
     // =============================================================
@@ -116,6 +117,7 @@ public:
         }
 
         update_camera_transforms();
+        m_has_direction_sampling = true;
     }
 
     void update_camera_transforms() {
@@ -242,6 +244,43 @@ public:
         return std::make_pair(ray, wav_weight);
     }
 
+    std::pair<DirectionSample3f, Spectrum>
+    sample_direction(const Interaction3f &it, const Point2f & /*sample*/,
+                     Mask active) const override {
+        MTS_MASKED_FUNCTION(ProfilerPhase::EndpointSampleDirection, active);
+
+        // Transform the reference point into the local coordinate system
+        auto trafo = m_world_transform->eval(it.time, active);
+        Point3f ref_p = trafo.inverse().transform_affine(it.p);
+
+        DirectionSample3f ds = zero<DirectionSample3f>();
+
+        // Discard points outside of the clip range or of the crop window
+        active &= ref_p.z() >= m_near_clip && ref_p.z() <= m_far_clip;
+        Point3f screen_p = m_camera_to_sample * ref_p;
+        active &= screen_p.x() >= 0.f && screen_p.x() <= 1.f &&
+                  screen_p.y() >= 0.f && screen_p.y() <= 1.f;
+        if (none_or<false>(active))
+            return { ds, 0.f };
+
+        Vector3f local_d(ref_p);
+        Float dist     = norm(local_d),
+              inv_dist = rcp(dist);
+        local_d *= inv_dist;
+
+        ds.p      = trafo.transform_affine(Point3f(0.f));
+        ds.n      = trafo * Vector3f(0.f, 0.f, 1.f);
+        ds.uv     = Point2f(screen_p.x(), screen_p.y()) * m_resolution;
+        ds.time   = it.time;
+        ds.pdf    = select(active, 1.f, 0.f);
+        ds.delta  = true;
+        ds.object = this;
+        ds.d      = (ds.p - it.p) * inv_dist;
+        ds.dist   = dist;
+
+        return { ds, select(active, importance(local_d) * sqr(inv_dist), 0.f) };
+    }
+
     ScalarBoundingBox3f bbox() const override {
         return m_world_transform->translation_bounds();
     }
@@ -19,14 +19,14 @@ Radiance meter (:monosp:`radiancemeterarray`)
 .. pluginparameters::
 
  * - origins
-   - |string|
-   - Comma separated list of locations from which the sensors will be recording
-     in world coordinates.
+   - |floats|
+   - List of locations from which the sensors will be recording in world
+     coordinates.
 
  * - directions
-   - |string|
-   - Comma separated list of directions in which the sensors are pointing in
-     world coordinates.
+   - |floats|
+   - List of directions in which the sensors are pointing in world
+     coordinates.
 
 This sensor plugin implements multiple radiance meters, as implemented in the
 :monosp:`radiancemeter` plugin.
@@ -45,10 +45,14 @@ the other located at (0, 1, 0) and pointing in the direction (0, -1, 0).
 .. code-block:: xml
 
     <sensor type="radiancemeterarray">
-            <string name="origins" value="1, 0, 0, 0, 1, 0"/>
-            <string name="directions" value="-1, 0, 0, 0, -1, 0/>
+            <floats name="origins" value="1, 0, 0, 0, 1, 0"/>
+            <floats name="directions" value="-1, 0, 0, 0, -1, 0"/>
     </sensor>
 
+For large sensor arrays, the values can also be provided as binary data or, in
+Python, as NumPy arrays (see :ref:`the file format documentation
+<sec-file-format>`).
+
 */
 
 MTS_VARIANT class RadianceMeterArray final : public Sensor<Float, Spectrum> {
@@ -68,37 +72,35 @@ public:
                   "values and cannot use the to_world transform.");
         }
 
-        std::vector<std::string> origins_str =
-            string::tokenize(props.string("origins"), " ,");
-        std::vector<std::string> directions_str =
-            string::tokenize(props.string("directions"), " ,");
+        FloatArray origins    = props.float_array("origins"),
+                   directions = props.float_array("directions");
 
-        if (origins_str.size() % 3 != 0)
+        if (origins.size() % 3 != 0)
             Throw("Invalid specification! Number of parameters %s, is not a "
                   "multiple of three.",
-                  origins_str.size());
+                  origins.size());
 
-        if (origins_str.size() != directions_str.size())
+        if (origins.size() != directions.size())
             Throw("Invalid specification! Number of parameters for origins and "
                   "directions (%s, %s) "
                   "are not equal.",
-                  origins_str.size(), directions_str.size());
+                  origins.size(), directions.size());
 
-        m_sensor_count = origins_str.size() / 3.;
+        m_sensor_count = origins.size() / 3;
         m_transforms   = empty<TransformStorage>(m_sensor_count * 16);
         m_transforms.managed();
 
         for (size_t i = 0; i < m_sensor_count; ++i) {
             size_t index = i * 3;
             ScalarPoint3f origin =
-                ScalarPoint3f(std::stof(origins_str[index]),
-                              std::stof(origins_str[index + 1]),
-                              std::stof(origins_str[index + 2]));
+                ScalarPoint3f((ScalarFloat) origins[index],
+                              (ScalarFloat) origins[index + 1],
+                              (ScalarFloat) origins[index + 2]);
 
             ScalarVector3f direction =
-                ScalarVector3f(std::stof(directions_str[index]),
-                               std::stof(directions_str[index + 1]),
-                               std::stof(directions_str[index + 2]));
+                ScalarVector3f((ScalarFloat) directions[index],
+                               (ScalarFloat) directions[index + 1],
+                               (ScalarFloat) directions[index + 2]);
 
             ScalarPoint3f target = origin + direction;
             auto [up, unused]    = coordinate_system(direction);
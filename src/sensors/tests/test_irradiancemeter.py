@@ -204,3 +204,117 @@ def test_srf(variant_scalar_spectral, srf):
     
     assert ek.allclose(ray.wavelengths, wav)
     assert ek.allclose(spec_weight, wav_weight)
+
+
+def directional_scene_dict(occluder=False, direct_samples=1):
+    from mitsuba.core import ScalarTransform4f
+
+    d = {
+        "type": "scene",
+        "meter": {
+            "type": "rectangle",
+            "sensor": {
+                "type": "irradiancemeter",
+                "direct_samples": direct_samples,
+                "film": {
+                    "type": "hdrfilm",
+                    "width": 1,
+                    "height": 1,
+                    "rfilter": {"type": "box"}
+                },
+            }
+        },
+        "emitter": {
+            "type": "directional",
+            "direction": [0, 0, -1],
+            "irradiance": {"type": "uniform", "value": 2.0}
+        },
+        "integrator": {"type": "path"}
+    }
+
+    if occluder:
+        # Covers the half of the meter with x > 0
+        d["occluder"] = {
+            "type": "rectangle",
+            "to_world": ScalarTransform4f.translate([0.5, 0, 1]) *
+                        ScalarTransform4f.scale([0.5, 1.5, 1])
+        }
+
+    return d
+
+
+def test_direct_directional(variant_scalar_rgb):
+    """The contribution of a directional emitter is evaluated deterministically
+    and has zero variance on an unoccluded plane facing the emitter"""
+    from mitsuba.core import Bitmap, Struct
+    from mitsuba.core.xml import load_dict
+
+    scene = load_dict(directional_scene_dict())
+    sensor = scene.sensors()[0]
+    assert sensor.has_direct_estimate()
+
+    for sample in np.random.rand(10, 2):
+        value = sensor.eval_direct(scene, 0.0, [], sample, [0.5, 0.5])
+        assert ek.allclose(value * ek.pi, 2.0)
+
+    # The traced rays never reach the directional emitter
+    scene.integrator().render(scene, sensor)
+    img = sensor.film().bitmap(raw=True).convert(Bitmap.PixelFormat.Y,
+                                                 Struct.Type.Float32, srgb_gamma=False)
+    assert ek.allclose(np.array(img), 2.0)
+
+    # Disabled direct estimation
+    d = directional_scene_dict()
+    d["meter"]["sensor"]["direct"] = False
+    scene = load_dict(d)
+    assert not scene.sensors()[0].has_direct_estimate()
+
+
+def test_direct_directional_occluded(variant_scalar_rgb):
+    from mitsuba.core.xml import load_dict
+
+    scene = load_dict(directional_scene_dict(occluder=True, direct_samples=64))
+    sensor = scene.sensors()[0]
+
+    values = [sensor.eval_direct(scene, 0.0, [], sample, [0.5, 0.5])[0] * ek.pi
+              for sample in np.random.rand(16, 2)]
+
+    # Stratified positions: every sample sees roughly half of the meter lit
+    assert ek.allclose(values, 1.0, atol=0.1)
+
+
+def test_direct_directional_null_interfaces(variant_scalar_rgb):
+    """The shadow rays of the direct estimate pass through null interfaces,
+    and the estimate is disabled in the presence of participating media"""
+    from mitsuba.core import ScalarTransform4f
+    from mitsuba.core.xml import load_dict
+
+    d = directional_scene_dict()
+    d["cover"] = {
+        "type": "rectangle",
+        "to_world": ScalarTransform4f.translate([0, 0, 1]) *
+                    ScalarTransform4f.scale(2),
+        "bsdf": {
+            "type": "mask",
+            "opacity": 0.25,
+            "bsdf": {"type": "diffuse"}
+        }
+    }
+    d["null_cover"] = {
+        "type": "rectangle",
+        "to_world": ScalarTransform4f.translate([0, 0, 2]) *
+                    ScalarTransform4f.scale(2),
+        "bsdf": {"type": "null"}
+    }
+
+    scene = load_dict(d)
+    sensor = scene.sensors()[0]
+    assert sensor.has_direct_estimate()
+
+    for sample in np.random.rand(10, 2):
+        value = sensor.eval_direct(scene, 0.0, [], sample, [0.5, 0.5])
+        assert ek.allclose(value * ek.pi, 2.0 * 0.75)
+
+    d["null_cover"]["interior"] = {"type": "homogeneous", "sigma_t": 1.0}
+    scene = load_dict(d)
+    assert not scene.sensors()[0].has_direct_estimate()
@@ -0,0 +1,100 @@
+import numpy as np
+import pytest
+
+import enoki as ek
+import mitsuba
+
+
+def tally_dict(resolution="1, 1, 2", width=1, height=2, **kwargs):
+    from mitsuba.core import ScalarTransform4f
+
+    d = {
+        "type": "voxeltally",
+        "to_world": ScalarTransform4f.translate([-1, -1, -1]) *
+                    ScalarTransform4f.scale(2),
+        "resolution": resolution,
+        "film": {
+            "type": "hdrfilm",
+            "width": width,
+            "height": height,
+            "rfilter": {"type": "box"}
+        }
+    }
+    d.update(kwargs)
+    return d
+
+
+def test01_construct(variant_scalar_rgb):
+    from mitsuba.core.xml import load_dict
+
+    sensor = load_dict(tally_dict())
+    assert sensor is not None
+    assert sensor.has_volume_tally()
+    assert not sensor.has_direction_sampling()
+    assert sensor.tally_channels() == [
+        "X", "Y", "Z", "A", "W",
+        "absorbed.R", "absorbed.G", "absorbed.B",
+        "scattered.R", "scattered.G", "scattered.B"
+    ]
+
+    # The film must store all voxels
+    with pytest.raises(RuntimeError):
+        load_dict(tally_dict(resolution="2, 2, 2"))
+
+    # Spectral bins are only available in spectral variants
+    with pytest.raises(RuntimeError):
+        load_dict(tally_dict(bins="a:400:500"))
+
+
+def test02_construct_bins(variant_scalar_spectral):
+    from mitsuba.core.xml import load_dict
+
+    sensor = load_dict(tally_dict())
+    assert sensor.tally_channels()[5:] == ["absorbed.total", "scattered.total"]
+
+    sensor = load_dict(tally_dict(bins="blue:400:500, red:600:700"))
+    assert sensor.tally_channels()[5:] == [
+        "absorbed.blue", "absorbed.red", "scattered.blue", "scattered.red"
+    ]
+
+    with pytest.raises(RuntimeError):
+        load_dict(tally_dict(bins="blue:500:400"))
+
+
+def test03_absorbed_power(variant_scalar_rgb):
+    """A point light with unit intensity above a black square: the absorbed
+    power is the solid angle subtended by the square, and is tallied in the
+    upper voxel."""
+    from mitsuba.core import ScalarTransform4f
+    from mitsuba.core.xml import load_dict
+
+    scene = load_dict({
+        "type": "scene",
+        "integrator": {"type": "ptracer", "sample_count": 10000},
+        "emitter": {
+            "type": "point",
+            "position": [0, 0, 2.25],
+            "intensity": {"type": "rgb", "value": [1, 1, 1]}
+        },
+        "square": {
+            "type": "rectangle",
+            "to_world": ScalarTransform4f.translate([0, 0, 0.25]),
+            "bsdf": {
+                "type": "diffuse",
+                "reflectance": {"type": "rgb", "value": [0, 0, 0]}
+            }
+        },
+        "tally": tally_dict()
+    })
+
+    sensor = scene.sensors()[0]
+    assert scene.integrator().render(scene, sensor)
+
+    channels = sensor.tally_channels()
+    values = np.array(sensor.film().bitmap(raw=True)).reshape(2, len(channels))
+    absorbed = values[:, channels.index("absorbed.R")]
+    scattered = values[:, channels.index("scattered.R")]
+
+    expected = 4.0 * np.arcsin(1.0 / 5.0)
+    assert np.allclose(absorbed, [0, expected], rtol=2e-2)
+    assert np.allclose(scattered, 0)
@@ -0,0 +1,226 @@
+#include <mitsuba/core/properties.h>
+#include <mitsuba/core/spectrum.h>
+#include <mitsuba/core/string.h>
+#include <mitsuba/core/transform.h>
+#include <mitsuba/render/film.h>
+#include <mitsuba/render/fwd.h>
+#include <mitsuba/render/imageblock.h>
+#include <mitsuba/render/sensor.h>
+
+NAMESPACE_BEGIN(mitsuba)
+
+/**!
+
+.. _sensor-voxeltally:
+
+Voxel tally (:monosp:`voxeltally`)
+----------------------------------
+
+.. pluginparameters::
+
+ * - to_world
+   - |transform|
+   - Maps the unit cube :math:`[0, 1]^3` onto the tallied region.
+     (Default: none, i.e. the tallied region is the unit cube)
+ * - resolution
+   - |string|
+   - Number of voxels along the X, Y and Z axes, e.g. :monosp:`"16, 16, 32"`.
+     (Default: :monosp:`"1, 1, 1"`)
+ * - bins
+   - |string|
+   - Comma-separated list of spectral bins, each given as
+     :monosp:`name:lambda_min:lambda_max` (in nanometers), e.g.
+     :monosp:`"blue:400:500, green:500:600, red:600:700"`. Only available in
+     spectral variants. (Default: a single bin named :monosp:`total`
+     covering the whole spectrum)
+
+This sensor tallies the power that is absorbed and scattered in each voxel of
+a regular grid. It does not record radiance along rays: it is filled by
+particle tracing integrators (e.g. :ref:`ptracer <integrator-ptracer>`),
+which report the power deposited at every scattering event of the traced
+light paths (a *collision estimator*). A single particle tracing run thus
+yields a complete 3D absorption field, e.g. the vertical profile of the
+fraction of absorbed photosynthetically active radiation (fAPAR) in a canopy.
+
+The result is stored in the film, which must have a width of :math:`n_x` and a
+height of :math:`n_y \cdot n_z` pixels: the :math:`n_z` slices of the grid are stacked
+along the vertical axis, and voxel :math:`(i, j, k)` maps to pixel
+:math:`(i, j + n_y k)`. For each spectral bin, the film has the channels
+:monosp:`absorbed.<bin>` and :monosp:`scattered.<bin>`, which contain the
+power (in the units of the emitters, e.g. W) per voxel. In nonspectral
+variants, the bins are the color channels of the rendering mode. The
+:monosp:`R`, :monosp:`G`, :monosp:`B` and :monosp:`A` channels of the film are
+not used.
+
+.. code-block:: xml
+
+    <sensor type="voxeltally">
+        <transform name="to_world">
+            <scale x="10" y="10" z="5"/>
+        </transform>
+        <string name="resolution" value="10, 10, 5"/>
+        <film type="hdrfilm">
+            <integer name="width" value="10"/>
+            <integer name="height" value="50"/>
+        </film>
+    </sensor>
+
+In Python, the grid of a channel can be retrieved with
+:code:`np.array(film.bitmap()).reshape(nz, ny, nx, -1)`.
+
+*/
+
+MTS_VARIANT class VoxelTally final : public Sensor<Float, Spectrum> {
+public:
+    MTS_IMPORT_BASE(Sensor, m_film, m_has_volume_tally)
+    MTS_IMPORT_TYPES(ImageBlock)
+
+    VoxelTally(const Properties &props) : Base(props) {
+        if constexpr (is_polarized_v<Spectrum>)
+            Throw("The voxel tally sensor cannot be used in polarized mode!");
+
+        ScalarTransform4f to_world = props.transform("to_world", ScalarTransform4f());
+        m_to_local = to_world.inverse();
+        m_bbox = ScalarBoundingBox3f();
+        for (int i = 0; i < 8; ++i)
+            m_bbox.expand(to_world * ScalarPoint3f(i & 1, (i >> 1) & 1, (i >> 2) & 1));
+
+        auto tokens = string::tokenize(props.string("resolution", "1, 1, 1"));
+        if (tokens.size() != 3)
+            Throw("\"resolution\" must specify three voxel counts!");
+        for (size_t i = 0; i < 3; ++i) {
+            int value = std::stoi(tokens[i]);
+            if (value <= 0)
+                Throw("Invalid resolution %i, must be positive!", value);
+            m_resolution[i] = (uint32_t) value;
+        }
+
+        ScalarVector2i film_size((int) m_resolution.x(),
+                                 (int) (m_resolution.y() * m_resolution.z()));
+        if (m_film->size() != film_size)
+            Throw("The film size must be %i x %i to store a grid of %i x %i x %i "
+                  "voxels. Found: %i x %i", film_size.x(), film_size.y(),
+                  m_resolution.x(), m_resolution.y(), m_resolution.z(),
+                  m_film->size().x(), m_film->size().y());
+
+        // Parse bin specification
+        if constexpr (is_spectral_v<Spectrum>) {
+            std::vector<std::string> bins =
+                string::tokenize(props.string("bins", ""), " ,");
+
+            for (const std::string &token : bins) {
+                std::vector<std::string> item = string::tokenize(token, ":");
+                if (item.size() != 3 || item[0].empty())
+                    Throw("Invalid spectral bin specification '%s'", token);
+
+                ScalarFloat lower, upper;
+                try {
+                    lower = (ScalarFloat) std::stod(item[1]);
+                    upper = (ScalarFloat) std::stod(item[2]);
+                } catch (...) {
+                    Throw("Could not parse spectral bin '%s'", token);
+                }
+                if (!(lower < upper))
+                    Throw("Empty spectral bin '%s'", token);
+
+                m_bin_names.push_back(item[0]);
+                m_bin_lower_bounds.push_back(lower);
+                m_bin_upper_bounds.push_back(upper);
+            }
+
+            if (m_bin_names.empty()) {
+                m_bin_names.push_back("total");
+                m_bin_lower_bounds.push_back(-math::Infinity<ScalarFloat>);
+                m_bin_upper_bounds.push_back(math::Infinity<ScalarFloat>);
+            }
+        } else {
+            if (props.has_property("bins"))
+                Throw("Spectral bins can only be used with a spectral variant!");
+
+            if constexpr (is_rgb_v<Spectrum>)
+                m_bin_names = { "R", "G", "B" };
+            else
+                m_bin_names = { "total" };
+        }
+
+        m_has_volume_tally = true;
+    }
+
+    void tally(ImageBlock *block, const Point3f &p,
+               const UnpolarizedSpectrum &absorbed,
+               const UnpolarizedSpectrum &scattered,
+               const Wavelength &wavelengths, Mask active) const override {
+        // Locate the voxel that contains the vertex
+        Point3f p_local = m_to_local.transform_affine(p);
+        active &= all(p_local >= 0.f && p_local < 1.f);
+        if (none_or<false>(active))
+            return;
+
+        Point3i p_i = min(floor2int<Point3i>(p_local * ScalarVector3f(m_resolution)),
+                          ScalarVector3i(m_resolution) - 1);
+
+        // Pixel of the voxel within the block, which may be cropped
+        ScalarVector2i block_size = block->size() + 2 * block->border_size();
+        Point2i pixel = Point2i(p_i.x(), p_i.y() + (int32_t) m_resolution.y() * p_i.z()) -
+                        block->offset() + block->border_size();
+        active &= all(pixel >= 0 && pixel < block_size);
+
+        uint32_t channel_count = (uint32_t) block->channel_count(),
+                 n_bins = (uint32_t) m_bin_names.size();
+        UInt32 offset = channel_count * UInt32(pixel.y() * block_size.x() + pixel.x());
+
+        for (uint32_t i = 0; i < n_bins; ++i) {
+            Float absorbed_i, scattered_i;
+            if constexpr (is_spectral_v<Spectrum>) {
+                // Average over the wavelength samples that fall into the bin
+                auto in_bin = wavelengths >= m_bin_lower_bounds[i] &&
+                              wavelengths < m_bin_upper_bounds[i];
+                ScalarFloat inv_count = 1.f / array_size_v<UnpolarizedSpectrum>;
+                absorbed_i  = hsum(select(in_bin, absorbed, 0.f)) * inv_count;
+                scattered_i = hsum(select(in_bin, scattered, 0.f)) * inv_count;
+            } else {
+                ENOKI_MARK_USED(wavelengths);
+                absorbed_i  = absorbed[i];
+                scattered_i = scattered[i];
+            }
+
+            scatter_add(block->data(), absorbed_i, offset + 5 + i, active);
+            scatter_add(block->data(), scattered_i, offset + 5 + n_bins + i, active);
+        }
+    }
+
+    std::vector<std::string> tally_channels() const override {
+        std::vector<std::string> channels = { "X", "Y", "Z", "A", "W" };
+        for (const std::string &name : m_bin_names)
+            channels.push_back("absorbed." + name);
+        for (const std::string &name : m_bin_names)
+            channels.push_back("scattered." + name);
+        return channels;
+    }
+
+    ScalarBoundingBox3f bbox() const override { return m_bbox; }
+
+    std::string to_string() const override {
+        std::ostringstream oss;
+        oss << "VoxelTally[" << std::endl
+            << "  bbox = " << m_bbox << "," << std::endl
+            << "  resolution = " << m_resolution << "," << std::endl
+            << "  bin_names = " << string::indent(m_bin_names) << "," << std::endl
+            << "  film = " << string::indent(m_film) << std::endl
+            << "]";
+        return oss.str();
+    }
+
+    MTS_DECLARE_CLASS()
+private:
+    ScalarTransform4f m_to_local;
+    ScalarBoundingBox3f m_bbox;
+    ScalarVector3u m_resolution;
+    std::vector<std::string> m_bin_names;
+    std::vector<ScalarFloat> m_bin_lower_bounds;
+    std::vector<ScalarFloat> m_bin_upper_bounds;
+};
+
+MTS_IMPLEMENT_CLASS_VARIANT(VoxelTally, Sensor)
+MTS_EXPORT_PLUGIN(VoxelTally, "VoxelTally");
+NAMESPACE_END(mitsuba)
@@ -0,0 +1,296 @@
+#include <mitsuba/core/frame.h>
+#include <mitsuba/core/properties.h>
+#include "primitive_cloud.h"
+
+NAMESPACE_BEGIN(mitsuba)
+
+/**!
+
+.. _shape-cylindercloud:
+
+Cylinder cloud (:monosp:`cylindercloud`)
+----------------------------------------------------
+
+.. pluginparameters::
+
+ * - filename
+   - |string|
+   - Filename of a text file describing the cylinders. Each line holds the
+     two endpoints of the centerline and the radius of one cylinder:
+     ``x0 y0 z0 x1 y1 z1 radius``. Lines starting with ``#`` are ignored.
+ * - to_world
+   - |transform|
+   - Specifies an optional linear object-to-world transformation that is
+     applied to all cylinders when the file is loaded. Note that non-uniform
+     scales are not permitted! (Default: none, i.e. object space = world space)
+
+This shape plugin describes a large collection of open cylinders (without
+endcaps) sharing the same material, such as the stems and branches of
+vegetation. Like the :ref:`spherecloud <shape-spherecloud>` plugin, the
+cylinders are sorted along a Morton curve and grouped into clusters of 8
+cylinders stored in structure-of-arrays form, which are intersected at once
+using SIMD instructions.
+
+The surface parameterization of each cylinder matches the one of the
+:ref:`cylinder <shape-cylinder>` plugin. This plugin is currently not
+supported in GPU variants.
+
+.. code-block:: xml
+
+    <shape type="cylindercloud">
+        <string name="filename" value="branches.txt"/>
+        <bsdf type="diffuse"/>
+    </shape>
+ */
+
+template <typename Float, typename Spectrum>
+class CylinderCloud final
+    : public PrimitiveCloud<Float, Spectrum, CylinderCloud<Float, Spectrum>> {
+public:
+    using Base = PrimitiveCloud<Float, Spectrum, CylinderCloud>;
+    ENOKI_USING_MEMBERS(Base, m_to_world, set_children, get_children_string, m_bbox,
+                        m_primitive_count, m_cluster_count, build_clusters,
+                        cluster_storage, surface_area)
+    ENOKI_USING_TYPES(Base, FloatStorage, FloatC, MaskC)
+    MTS_IMPORT_TYPES()
+
+    CylinderCloud(const Properties &props) : Base(props) {
+        if constexpr (is_cuda_array_v<Float>)
+            Throw("The cylindercloud shape is not supported in GPU variants!");
+
+        std::vector<ScalarFloat> values =
+            read_cloud_file<ScalarFloat>(props.string("filename"), 7, "cylindercloud");
+        size_t count = values.size() / 7;
+
+        // Radii are scaled by the (uniform) scale factor of the transformation
+        ScalarFloat scale = norm(m_to_world * ScalarVector3f(1.f, 0.f, 0.f));
+
+        std::vector<ScalarPoint3f> p0(count), centers(count);
+        std::vector<ScalarVector3f> axes(count);
+        std::vector<ScalarFloat> lengths(count), radii(count), areas(count);
+        std::vector<ScalarBoundingBox3f> bboxes(count);
+
+        for (size_t i = 0; i < count; ++i) {
+            const ScalarFloat *v = values.data() + 7 * i;
+            p0[i] = m_to_world * ScalarPoint3f(v[0], v[1], v[2]);
+            ScalarPoint3f p1 = m_to_world * ScalarPoint3f(v[3], v[4], v[5]);
+            radii[i] = v[6] * scale;
+            centers[i] = .5f * (p0[i] + p1);
+            lengths[i] = norm(p1 - p0[i]);
+
+            if (!(radii[i] > 0.f))
+                Throw("cylindercloud: cylinder %i has an invalid radius (%f)", i, radii[i]);
+            if (!(lengths[i] > 0.f))
+                Throw("cylindercloud: cylinder %i has a degenerate centerline", i);
+
+            axes[i] = (p1 - p0[i]) / lengths[i];
+            areas[i] = 2.f * math::Pi<ScalarFloat> * radii[i] * lengths[i];
+
+            // Bounding box of the two end disks
+            ScalarVector3f extent = radii[i] * safe_sqrt(1.f - sqr(axes[i]));
+            bboxes[i].expand(ScalarBoundingBox3f(p0[i] - extent, p0[i] + extent));
+            bboxes[i].expand(ScalarBoundingBox3f(p1 - extent, p1 + extent));
+        }
+
+        std::vector<uint32_t> order = build_clusters(centers, bboxes, areas);
+        m_p0_x   = cluster_storage(order, [&](uint32_t j) { return p0[j].x(); });
+        m_p0_y   = cluster_storage(order, [&](uint32_t j) { return p0[j].y(); });
+        m_p0_z   = cluster_storage(order, [&](uint32_t j) { return p0[j].z(); });
+        m_axis_x = cluster_storage(order, [&](uint32_t j) { return axes[j].x(); });
+        m_axis_y = cluster_storage(order, [&](uint32_t j) { return axes[j].y(); });
+        m_axis_z = cluster_storage(order, [&](uint32_t j) { return axes[j].z(); });
+        m_length = cluster_storage(order, [&](uint32_t j) { return lengths[j]; });
+        m_radius = cluster_storage(order, [&](uint32_t j) { return radii[j]; });
+
+        set_children();
+    }
+
+    // =============================================================
+    //! @{ \name Ray tracing routines
+    // =============================================================
+
+    SurfaceInteraction3f compute_surface_interaction(const Ray3f &ray,
+                                                     PreliminaryIntersection3f pi,
+                                                     HitComputeFlags flags,
+                                                     Mask active) const override {
+        MTS_MASK_ARGUMENT(active);
+
+        active &= pi.is_valid();
+
+        UInt32 index = pi.prim_index;
+        Point3f p0 = gather_p0(index, active);
+        Vector3f axis = gather_axis(index, active);
+        Float length = gather<Float>(m_length, index, active),
+              r      = gather<Float>(m_radius, index, active);
+
+        SurfaceInteraction3f si = zero<SurfaceInteraction3f>();
+        si.t = select(active, pi.t, math::Infinity<Float>);
+
+        Vector3f q = ray(pi.t) - p0;
+        Float z = dot(q, axis);
+        Vector3f n = normalize(fnmadd(axis, z, q));
+
+        // Re-project onto the cylinder to improve accuracy
+        si.p = p0 + axis * z + n * r;
+        si.sh_frame.n = n;
+        si.n = n;
+
+        if (likely(has_flag(flags, HitComputeFlags::UV))) {
+            Frame3f frame(axis);
+            Float phi = atan2(dot(n, frame.t), dot(n, frame.s));
+            masked(phi, phi < 0.f) += 2.f * math::Pi<Float>;
+
+            si.uv = Point2f(phi * math::InvTwoPi<Float>, z / length);
+
+            if (likely(has_flag(flags, HitComputeFlags::dPdUV))) {
+                si.dp_du = cross(axis, n) * (r * 2.f * math::Pi<Float>);
+                si.dp_dv = axis * length;
+            }
+        }
+
+        if (has_flag(flags, HitComputeFlags::dNSdUV)) {
+            si.dn_du = si.dp_du / r;
+            si.dn_dv = zero<Vector3f>();
+        }
+
+        return si;
+    }
+
+    //! @}
+    // =============================================================
+
+    std::string to_string() const override {
+        std::ostringstream oss;
+        oss << "CylinderCloud[" << std::endl
+            << "  cylinder_count = " << m_primitive_count << "," << std::endl
+            << "  cluster_count = " << m_cluster_count << "," << std::endl
+            << "  bbox = " << string::indent(m_bbox) << "," << std::endl
+            << "  surface_area = " << surface_area() << "," << std::endl
+            << "  " << string::indent(get_children_string()) << std::endl
+            << "]";
+        return oss.str();
+    }
+
+    MTS_DECLARE_CLASS()
+private:
+    friend Base;
+
+    MTS_INLINE Point3f gather_p0(const UInt32 &index, const Mask &active) const {
+        return Point3f(gather<Float>(m_p0_x, index, active),
+                       gather<Float>(m_p0_y, index, active),
+                       gather<Float>(m_p0_z, index, active));
+    }
+
+    MTS_INLINE Vector3f gather_axis(const UInt32 &index, const Mask &active) const {
+        return Vector3f(gather<Float>(m_axis_x, index, active),
+                        gather<Float>(m_axis_y, index, active),
+                        gather<Float>(m_axis_z, index, active));
+    }
+
+    PositionSample3f sample_slot(const UInt32 &slot, const Point2f &sample,
+                                 Mask active) const {
+        Vector3f axis = gather_axis(slot, active);
+        Frame3f frame(axis);
+        auto [sin_phi, cos_phi] = sincos(2.f * math::Pi<Float> * sample.x());
+
+        PositionSample3f ps;
+        ps.n = fmadd(frame.s, cos_phi, frame.t * sin_phi);
+        ps.p = gather_p0(slot, active) +
+               axis * (sample.y() * gather<Float>(m_length, slot, active)) +
+               ps.n * gather<Float>(m_radius, slot, active);
+        return ps;
+    }
+
+    /* The intersection routines solve the quadratic in the plane perpendicular
+       to the cylinder axis, going through the point of the projected ray that
+       is closest to the centerline for numerical robustness. The nearest root
+       is kept if it lies within the extent of the cylinder, otherwise the
+       farthest one is tried. */
+
+    MTS_INLINE std::pair<FloatC, MaskC> intersect_lanes(size_t offset,
+                                                        const Ray3f &ray) const {
+        auto load = [offset](const FloatStorage &buf) {
+            return load_unaligned<FloatC>(buf.data() + offset);
+        };
+
+        FloatC ax = load(m_axis_x), ay = load(m_axis_y), az = load(m_axis_z),
+               ox = ray.o.x() - load(m_p0_x),
+               oy = ray.o.y() - load(m_p0_y),
+               oz = ray.o.z() - load(m_p0_z),
+               r  = load(m_radius),
+               length = load(m_length);
+
+        FloatC o_a = ox * ax + oy * ay + oz * az,
+               d_a = ray.d.x() * ax + ray.d.y() * ay + ray.d.z() * az;
+
+        // Components perpendicular to the axis
+        FloatC opx = fnmadd(ax, o_a, ox), opy = fnmadd(ay, o_a, oy), opz = fnmadd(az, o_a, oz),
+               dpx = fnmadd(ax, d_a, ray.d.x()),
+               dpy = fnmadd(ay, d_a, ray.d.y()),
+               dpz = fnmadd(az, d_a, ray.d.z());
+
+        FloatC inv_a  = rcp(sqr(dpx) + sqr(dpy) + sqr(dpz)),
+               t_mid  = -(opx * dpx + opy * dpy + opz * dpz) * inv_a,
+               disc   = (sqr(r) - (sqr(fmadd(dpx, t_mid, opx)) +
+                                   sqr(fmadd(dpy, t_mid, opy)) +
+                                   sqr(fmadd(dpz, t_mid, opz)))) * inv_a,
+               half   = safe_sqrt(disc),
+               t_near = t_mid - half,
+               t_far  = t_mid + half,
+               z_near = fmadd(d_a, t_near, o_a),
+               z_far  = fmadd(d_a, t_far, o_a);
+
+        MaskC valid_near = t_near >= ray.mint && t_near <= ray.maxt &&
+                           z_near >= 0.f && z_near <= length,
+              valid_far  = t_far >= ray.mint && t_far <= ray.maxt &&
+                           z_far >= 0.f && z_far <= length;
+
+        return { select(valid_near, t_near, t_far),
+                 disc >= 0.f && (valid_near || valid_far) };
+    }
+
+    MTS_INLINE std::pair<Float, Mask> intersect_slot(size_t slot, const Ray3f &ray,
+                                                     const Float &maxt) const {
+        ScalarFloat r = m_radius.data()[slot],
+                    length = m_length.data()[slot];
+
+        ScalarVector3f axis(m_axis_x.data()[slot], m_axis_y.data()[slot],
+                            m_axis_z.data()[slot]);
+        Vector3f o = ray.o - ScalarPoint3f(m_p0_x.data()[slot],
+                                           m_p0_y.data()[slot],
+                                           m_p0_z.data()[slot]);
+
+        Float o_a = dot(o, axis),
+              d_a = dot(ray.d, axis);
+
+        Vector3f o_p = fnmadd(axis, o_a, o),
+                 d_p = fnmadd(axis, d_a, ray.d);
+
+        Float inv_a  = rcp(squared_norm(d_p)),
+              t_mid  = -dot(o_p, d_p) * inv_a,
+              disc   = (sqr(r) - squared_norm(fmadd(d_p, t_mid, o_p))) * inv_a,
+              half   = safe_sqrt(disc),
+              t_near = t_mid - half,
+              t_far  = t_mid + half,
+              z_near = fmadd(d_a, t_near, o_a),
+              z_far  = fmadd(d_a, t_far, o_a);
+
+        Mask valid_near = t_near >= ray.mint && t_near <= maxt &&
+                          z_near >= 0.f && z_near <= length,
+             valid_far  = t_far >= ray.mint && t_far <= maxt &&
+                          z_far >= 0.f && z_far <= length;
+
+        return { select(valid_near, t_near, t_far),
+                 disc >= 0.f && (valid_near || valid_far) };
+    }
+
+private:
+    /// Cylinder start points, unit axes, lengths and radii (structure of arrays)
+    FloatStorage m_p0_x, m_p0_y, m_p0_z;
+    FloatStorage m_axis_x, m_axis_y, m_axis_z;
+    FloatStorage m_length, m_radius;
+};
+
+MTS_IMPLEMENT_CLASS_VARIANT(CylinderCloud, Shape)
+MTS_EXPORT_PLUGIN(CylinderCloud, "Cylinder cloud intersection primitive");
+NAMESPACE_END(mitsuba)
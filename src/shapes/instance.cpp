@@ -93,6 +93,10 @@ public:
 
     ScalarSize primitive_count() const override { return 1; }
 
+    HitComputeFlags hit_compute_flags() const override {
+        return m_shapegroup->hit_compute_flags();
+    }
+
     ScalarSize effective_primitive_count() const override {
         return m_shapegroup->primitive_count();
     }
@@ -168,6 +172,14 @@ public:
     //! @}
     // =============================================================
 
+    void traverse(TraversalCallback *callback) override {
+        callback->put_parameter("to_world", m_to_world);
+    }
+
+    void parameters_changed(const std::vector<std::string> &/*keys*/) override {
+        m_to_object = m_to_world.inverse();
+    }
+
     std::string to_string() const override {
         std::ostringstream oss;
             oss << "Instance[" << std::endl
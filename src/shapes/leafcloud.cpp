@@ -0,0 +1,353 @@
+#include <mitsuba/core/frame.h>
+#include <mitsuba/core/properties.h>
+#include <mitsuba/core/warp.h>
+#include "primitive_cloud.h"
+
+NAMESPACE_BEGIN(mitsuba)
+
+/**!
+
+.. _shape-leafcloud:
+
+Leaf cloud (:monosp:`leafcloud`)
+----------------------------------------------------
+
+.. pluginparameters::
+
+ * - filename
+   - |string|
+   - Filename of the binary leaf cloud file (see below).
+ * - to_world
+   - |transform|
+   - Specifies an optional linear object-to-world transformation that is
+     applied to all leaves when the file is loaded. Note that non-uniform
+     scales are not permitted! (Default: none, i.e. object space = world space)
+
+This shape plugin describes a vegetation canopy as a collection of flat,
+disk-shaped leaves. Each leaf is only described by its center, its normal
+and its radius, and may optionally carry an integer attribute (e.g. a leaf
+type or age class). Compared to an equivalent set of
+:ref:`disk <shape-disk>` shapes or two-triangle meshes, this removes the
+per-leaf shape objects, transformations and mesh bookkeeping: a leaf uses
+32 bytes of memory, so that canopies with tens of millions of leaves fit in
+a few hundred megabytes.
+
+Like the :ref:`spherecloud <shape-spherecloud>` plugin, the leaves are
+sorted along a Morton curve and grouped into clusters of 8 leaves stored in
+structure-of-arrays form. The acceleration data structure is built over the
+clusters, and all leaves of a cluster are intersected at once using SIMD
+instructions.
+
+The attribute of the leaf hit by a ray is available as the shape attribute
+``face_attribute`` (leaves being the faces of this shape), e.g. through the
+``mesh_attribute`` texture. The surface parameterization of each leaf
+matches the one of the ``disk`` plugin.
+
+The file is a little-endian binary file with the following layout:
+
+- the 4-byte magic string ``LEAF``,
+- a ``uint32`` file format version, currently 1,
+- a ``uint32`` flags field, where bit 0 indicates that attributes are present,
+- a ``uint64`` number of leaves :math:`N`,
+- seven ``float32`` arrays of :math:`N` values each: center :math:`x`,
+  :math:`y`, :math:`z`, normal :math:`x`, :math:`y`, :math:`z` and radius,
+- if bit 0 of the flags is set, a ``uint32`` array of :math:`N` attributes.
+
+This plugin is currently not supported in GPU variants.
+
+.. code-block:: xml
+
+    <shape type="leafcloud">
+        <string name="filename" value="canopy.leaves"/>
+        <bsdf type="twosided">
+            <bsdf type="diffuse"/>
+        </bsdf>
+    </shape>
+ */
+
+template <typename Float, typename Spectrum>
+class LeafCloud final : public PrimitiveCloud<Float, Spectrum, LeafCloud<Float, Spectrum>> {
+public:
+    using Base = PrimitiveCloud<Float, Spectrum, LeafCloud>;
+    ENOKI_USING_MEMBERS(Base, m_to_world, set_children, get_children_string, m_bbox,
+                        m_primitive_count, m_cluster_count, build_clusters,
+                        cluster_storage, surface_area)
+    ENOKI_USING_TYPES(Base, FloatStorage, FloatC, MaskC)
+    MTS_IMPORT_TYPES()
+
+    using IndexStorage = DynamicBuffer<UInt32>;
+
+    LeafCloud(const Properties &props) : Base(props) {
+        if constexpr (is_cuda_array_v<Float>)
+            Throw("The leafcloud shape is not supported in GPU variants!");
+
+        auto fs = Thread::thread()->file_resolver();
+        fs::path file_path = fs->resolve(props.string("filename"));
+        m_filename = file_path.filename().string();
+
+        auto fail = [&](const char *descr) {
+            Throw("Error while loading leafcloud file \"%s\": %s!", m_filename, descr);
+        };
+
+        if (!fs::exists(file_path))
+            fail("file not found");
+
+        ref<MemoryMappedFile> mmap = new MemoryMappedFile(file_path);
+        const uint8_t *ptr = (const uint8_t *) mmap->data();
+        size_t size = mmap->size();
+
+        // Header: magic, version, flags, leaf count
+        const size_t header_size = 20;
+        if (size < header_size)
+            fail("file is truncated");
+
+        uint32_t version, flags;
+        uint64_t count;
+        memcpy(&version, ptr + 4, sizeof(uint32_t));
+        memcpy(&flags, ptr + 8, sizeof(uint32_t));
+        memcpy(&count, ptr + 12, sizeof(uint64_t));
+
+        if (memcmp(ptr, "LEAF", 4) != 0)
+            fail("invalid file format (missing 'LEAF' header)");
+        if (version != 1)
+            fail("unsupported file format version");
+        if (count == 0)
+            fail("the file contains no leaves");
+
+        m_has_attributes = (flags & 1) != 0;
+        size_t expected_size = header_size + count * (7 * sizeof(float) +
+                               (m_has_attributes ? sizeof(uint32_t) : 0));
+        if (size != expected_size)
+            fail("file size does not match the number of leaves");
+
+        auto column = [&](size_t k, size_t i) {
+            float value;
+            memcpy(&value, ptr + header_size + (k * count + i) * sizeof(float),
+                   sizeof(float));
+            return (ScalarFloat) value;
+        };
+
+        // Radii are scaled by the (uniform) scale factor of the transformation
+        ScalarFloat scale = norm(m_to_world * ScalarVector3f(1.f, 0.f, 0.f));
+
+        std::vector<ScalarPoint3f> centers(count);
+        std::vector<ScalarNormal3f> normals(count);
+        std::vector<ScalarFloat> radii(count), areas(count);
+        std::vector<ScalarBoundingBox3f> bboxes(count);
+
+        for (size_t i = 0; i < count; ++i) {
+            centers[i] = m_to_world * ScalarPoint3f(column(0, i), column(1, i), column(2, i));
+            normals[i] = normalize(m_to_world * ScalarNormal3f(column(3, i), column(4, i),
+                                                               column(5, i)));
+            radii[i] = column(6, i) * scale;
+
+            if (!(radii[i] > 0.f))
+                Throw("leafcloud: leaf %i has an invalid radius (%f)", i, radii[i]);
+            if (!all(enoki::isfinite(normals[i])))
+                Throw("leafcloud: leaf %i has an invalid normal", i);
+
+            ScalarVector3f extent = radii[i] * safe_sqrt(1.f - sqr(normals[i]));
+            bboxes[i] = ScalarBoundingBox3f(centers[i] - extent, centers[i] + extent);
+            areas[i] = math::Pi<ScalarFloat> * sqr(radii[i]);
+        }
+
+        std::vector<uint32_t> order = build_clusters(centers, bboxes, areas);
+        m_center_x = cluster_storage(order, [&](uint32_t j) { return centers[j].x(); });
+        m_center_y = cluster_storage(order, [&](uint32_t j) { return centers[j].y(); });
+        m_center_z = cluster_storage(order, [&](uint32_t j) { return centers[j].z(); });
+        m_normal_x = cluster_storage(order, [&](uint32_t j) { return normals[j].x(); });
+        m_normal_y = cluster_storage(order, [&](uint32_t j) { return normals[j].y(); });
+        m_normal_z = cluster_storage(order, [&](uint32_t j) { return normals[j].z(); });
+        m_radius   = cluster_storage(order, [&](uint32_t j) { return radii[j]; });
+
+        if (m_has_attributes) {
+            size_t slot_count = m_cluster_count * Base::ClusterSize;
+            std::vector<uint32_t> attributes(slot_count, 0u);
+            for (size_t i = 0; i < count; ++i)
+                memcpy(&attributes[i],
+                       ptr + header_size + (7 * count + order[i]) * sizeof(uint32_t),
+                       sizeof(uint32_t));
+            m_attribute = IndexStorage::copy(attributes.data(), slot_count);
+        }
+
+        set_children();
+    }
+
+    // =============================================================
+    //! @{ \name Ray tracing routines
+    // =============================================================
+
+    SurfaceInteraction3f compute_surface_interaction(const Ray3f &ray,
+                                                     PreliminaryIntersection3f pi,
+                                                     HitComputeFlags flags,
+                                                     Mask active) const override {
+        MTS_MASK_ARGUMENT(active);
+
+        active &= pi.is_valid();
+
+        UInt32 index = pi.prim_index;
+        Normal3f n = normal(index, active);
+
+        SurfaceInteraction3f si = zero<SurfaceInteraction3f>();
+        si.t = select(active, pi.t, math::Infinity<Float>);
+        si.p = ray(pi.t);
+
+        if (likely(has_flag(flags, HitComputeFlags::UV))) {
+            Frame3f frame(n);
+            Float radius = gather<Float>(m_radius, index, active);
+            Vector3f local = frame.to_local(si.p - center(index, active)) / radius;
+
+            Float r = norm(Point2f(local.x(), local.y())),
+                  inv_r = rcp(r);
+
+            Float v = atan2(local.y(), local.x()) * math::InvTwoPi<Float>;
+            masked(v, v < 0.f) += 1.f;
+            si.uv = Point2f(r, v);
+
+            if (likely(has_flag(flags, HitComputeFlags::dPdUV))) {
+                Float cos_phi = select(neq(r, 0.f), local.x() * inv_r, 1.f),
+                      sin_phi = select(neq(r, 0.f), local.y() * inv_r, 0.f);
+
+                si.dp_du = frame.to_world(Vector3f( cos_phi, sin_phi, 0.f)) * radius;
+                si.dp_dv = frame.to_world(Vector3f(-sin_phi, cos_phi, 0.f)) * radius;
+            }
+        }
+
+        si.n          = n;
+        si.sh_frame.n = n;
+
+        si.dn_du = si.dn_dv = zero<Vector3f>();
+
+        return si;
+    }
+
+    //! @}
+    // =============================================================
+
+    // =============================================================
+    //! @{ \name Shape attributes
+    // =============================================================
+
+    Float eval_attribute_1(const std::string &name,
+                           const SurfaceInteraction3f &si,
+                           Mask active) const override {
+        if (name != "face_attribute" || !m_has_attributes)
+            Throw("Invalid attribute requested %s.", name.c_str());
+        return Float(gather<UInt32>(m_attribute, si.prim_index, active));
+    }
+
+    UnpolarizedSpectrum eval_attribute(const std::string &name,
+                                       const SurfaceInteraction3f &si,
+                                       Mask active) const override {
+        return eval_attribute_1(name, si, active);
+    }
+
+    Color3f eval_attribute_3(const std::string &name,
+                             const SurfaceInteraction3f &si,
+                             Mask active) const override {
+        return eval_attribute_1(name, si, active);
+    }
+
+    //! @}
+    // =============================================================
+
+    std::string to_string() const override {
+        std::ostringstream oss;
+        oss << "LeafCloud[" << std::endl
+            << "  filename = \"" << m_filename << "\"," << std::endl
+            << "  leaf_count = " << m_primitive_count << "," << std::endl
+            << "  cluster_count = " << m_cluster_count << "," << std::endl
+            << "  has_attributes = " << m_has_attributes << "," << std::endl
+            << "  bbox = " << string::indent(m_bbox) << "," << std::endl
+            << "  surface_area = " << surface_area() << "," << std::endl
+            << "  " << string::indent(get_children_string()) << std::endl
+            << "]";
+        return oss.str();
+    }
+
+    MTS_DECLARE_CLASS()
+private:
+    friend Base;
+
+    MTS_INLINE Point3f center(const UInt32 &index, const Mask &active) const {
+        return Point3f(gather<Float>(m_center_x, index, active),
+                       gather<Float>(m_center_y, index, active),
+                       gather<Float>(m_center_z, index, active));
+    }
+
+    MTS_INLINE Normal3f normal(const UInt32 &index, const Mask &active) const {
+        return Normal3f(gather<Float>(m_normal_x, index, active),
+                        gather<Float>(m_normal_y, index, active),
+                        gather<Float>(m_normal_z, index, active));
+    }
+
+    PositionSample3f sample_slot(const UInt32 &slot, const Point2f &sample,
+                                 Mask active) const {
+        Normal3f n = normal(slot, active);
+        Point2f p = warp::square_to_uniform_disk_concentric(sample);
+        Frame3f frame(n);
+
+        PositionSample3f ps;
+        ps.p = center(slot, active) +
+               frame.to_world(Vector3f(p.x(), p.y(), 0.f)) *
+               gather<Float>(m_radius, slot, active);
+        ps.n = n;
+        return ps;
+    }
+
+    /* Each leaf is a disk: the ray is intersected with its supporting plane,
+       and the hit point is accepted if it lies within the leaf radius. */
+
+    MTS_INLINE std::pair<FloatC, MaskC> intersect_lanes(size_t offset,
+                                                        const Ray3f &ray) const {
+        auto load = [offset](const FloatStorage &buf) {
+            return load_unaligned<FloatC>(buf.data() + offset);
+        };
+
+        FloatC nx = load(m_normal_x), ny = load(m_normal_y), nz = load(m_normal_z),
+               ox = load(m_center_x) - ray.o.x(),
+               oy = load(m_center_y) - ray.o.y(),
+               oz = load(m_center_z) - ray.o.z(),
+               r  = load(m_radius);
+
+        FloatC t  = (ox * nx + oy * ny + oz * nz) /
+                    (ray.d.x() * nx + ray.d.y() * ny + ray.d.z() * nz),
+               px = fmsub(ray.d.x(), t, ox),
+               py = fmsub(ray.d.y(), t, oy),
+               pz = fmsub(ray.d.z(), t, oz);
+
+        // NaN-aware conditionals, also discarding the padding
+        return { t, t >= ray.mint && t <= ray.maxt &&
+                    sqr(px) + sqr(py) + sqr(pz) <= sqr(r) };
+    }
+
+    MTS_INLINE std::pair<Float, Mask> intersect_slot(size_t slot, const Ray3f &ray,
+                                                     const Float &maxt) const {
+        ScalarFloat r = m_radius.data()[slot];
+        ScalarNormal3f n(m_normal_x.data()[slot], m_normal_y.data()[slot],
+                         m_normal_z.data()[slot]);
+        Vector3f o = ScalarPoint3f(m_center_x.data()[slot],
+                                   m_center_y.data()[slot],
+                                   m_center_z.data()[slot]) - ray.o;
+
+        Float t = dot(o, n) / dot(ray.d, n);
+        return { t, t >= ray.mint && t <= maxt &&
+                    squared_norm(fmsub(ray.d, t, o)) <= sqr(r) };
+    }
+
+private:
+    std::string m_filename;
+
+    /// Leaf centers, normals and radii (structure of arrays)
+    FloatStorage m_center_x, m_center_y, m_center_z;
+    FloatStorage m_normal_x, m_normal_y, m_normal_z;
+    FloatStorage m_radius;
+
+    /// Optional per-leaf attribute
+    IndexStorage m_attribute;
+    bool m_has_attributes;
+};
+
+MTS_IMPLEMENT_CLASS_VARIANT(LeafCloud, Shape)
+MTS_EXPORT_PLUGIN(LeafCloud, "Leaf cloud intersection primitive");
+NAMESPACE_END(mitsuba)
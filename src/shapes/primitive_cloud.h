@@ -0,0 +1,355 @@
+#pragma once
+
+#include <enoki/morton.h>
+#include <mitsuba/core/bbox.h>
+#include <mitsuba/core/distr_1d.h>
+#include <mitsuba/core/filesystem.h>
+#include <mitsuba/core/fresolver.h>
+#include <mitsuba/core/logger.h>
+#include <mitsuba/core/mmap.h>
+#include <mitsuba/core/thread.h>
+#include <mitsuba/render/interaction.h>
+#include <mitsuba/render/shape.h>
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <numeric>
+
+NAMESPACE_BEGIN(mitsuba)
+
+/**
+ * Number of primitives that the cloud shapes (e.g. \c spherecloud) group into
+ * a cluster. A cluster is the unit of work of the acceleration data structure:
+ * all its primitives are intersected at once using SoA storage.
+ */
+#define MTS_CLOUD_CLUSTER_SIZE 8
+
+/**
+ * \brief Parse a text file containing one primitive per line
+ *
+ * Each non-empty line must hold \c columns whitespace-separated floating point
+ * values. Lines starting with \c # are ignored. The values of all primitives
+ * are returned in a single flat array.
+ */
+template <typename ScalarFloat>
+std::vector<ScalarFloat> read_cloud_file(const std::string &filename,
+                                         size_t columns,
+                                         const char *plugin_name) {
+    auto fs = Thread::thread()->file_resolver();
+    fs::path file_path = fs->resolve(filename);
+    std::string name = file_path.filename().string();
+
+    if (!fs::exists(file_path))
+        Throw("Error while loading %s file \"%s\": file not found",
+              plugin_name, name);
+
+    ref<MemoryMappedFile> mmap = new MemoryMappedFile(file_path);
+    const char *ptr = (const char *) mmap->data(),
+               *eof = ptr + mmap->size();
+
+    std::vector<ScalarFloat> values;
+    values.reserve(mmap->size() / 8);
+
+    size_t line = 1, count = 0;
+    while (ptr < eof) {
+        // Skip whitespace, comments and count lines
+        if (*ptr == '#') {
+            while (ptr < eof && *ptr != '\n')
+                ++ptr;
+            continue;
+        } else if (std::isspace(*ptr)) {
+            if (*ptr == '\n') {
+                if (count % columns != 0)
+                    Throw("Error while loading %s file \"%s\": expected %i "
+                          "values on line %i", plugin_name, name, columns, line);
+                ++line;
+            }
+            ++ptr;
+            continue;
+        }
+
+        char buf[64];
+        size_t len = 0;
+        while (ptr < eof && !std::isspace(*ptr) && len < sizeof(buf) - 1)
+            buf[len++] = *ptr++;
+        buf[len] = '\0';
+
+        char *end_ptr = nullptr;
+        double value = std::strtod(buf, &end_ptr);
+        if (end_ptr != buf + len)
+            Throw("Error while loading %s file \"%s\": could not parse \"%s\" "
+                  "on line %i", plugin_name, name, buf, line);
+        values.push_back((ScalarFloat) value);
+        ++count;
+    }
+
+    if (values.empty() || values.size() % columns != 0)
+        Throw("Error while loading %s file \"%s\": the file must contain a "
+              "multiple of %i values", plugin_name, name, columns);
+
+    return values;
+}
+
+/**
+ * \brief Sort primitives along a Morton curve so that consecutive
+ * primitives (and thus clusters) are spatially coherent
+ *
+ * \param centers
+ *     Representative point of each primitive
+ *
+ * \param bbox
+ *     Bounding box enclosing all primitives
+ *
+ * \return A permutation of the primitive indices
+ */
+template <typename ScalarPoint3f, typename ScalarBoundingBox3f>
+std::vector<uint32_t> morton_order(const std::vector<ScalarPoint3f> &centers,
+                                   const ScalarBoundingBox3f &bbox) {
+    using ScalarFloat    = scalar_t<ScalarPoint3f>;
+    using ScalarVector3u = Array<uint32_t, 3>;
+
+    ScalarPoint3f extents = bbox.extents();
+    for (size_t j = 0; j < 3; ++j)
+        if (!(extents[j] > 0.f))
+            extents[j] = 1.f;
+    ScalarPoint3f scale = ScalarFloat(1023) / extents;
+
+    std::vector<uint32_t> codes(centers.size());
+    for (size_t i = 0; i < centers.size(); ++i) {
+        ScalarVector3u q(clamp((centers[i] - bbox.min) * scale, 0.f, 1023.f));
+        codes[i] = enoki::morton_encode(q);
+    }
+
+    std::vector<uint32_t> order(centers.size());
+    std::iota(order.begin(), order.end(), 0u);
+    std::stable_sort(order.begin(), order.end(),
+                     [&](uint32_t a, uint32_t b) { return codes[a] < codes[b]; });
+    return order;
+}
+
+/**
+ * \brief Base class of the cloud shapes, which group many primitives of the
+ * same type into clusters of \ref MTS_CLOUD_CLUSTER_SIZE primitives
+ *
+ * This class implements the acceleration data structure interface over the
+ * clusters, brute force traversal, and uniform position sampling. The
+ * primitive type plugs in through \c Derived, which must provide:
+ *
+ * <tt>std::pair<FloatC, MaskC> intersect_lanes(size_t offset, const Ray3f &ray) const</tt>
+ *     Intersect a ray of a scalar variant against all primitives of the
+ *     cluster starting at slot \c offset at once. The padding slots (filled
+ *     with NaNs) must not produce an intersection.
+ *
+ * <tt>std::pair<Float, Mask> intersect_slot(size_t slot, const Ray3f &ray, const Float &maxt) const</tt>
+ *     Intersect the rays of a packet variant against a single primitive.
+ *
+ * <tt>PositionSample3f sample_slot(const UInt32 &slot, const Point2f &sample, Mask active) const</tt>
+ *     Uniformly sample a position (\c p and \c n) on a primitive.
+ */
+template <typename Float, typename Spectrum, typename Derived>
+class PrimitiveCloud : public Shape<Float, Spectrum> {
+public:
+    MTS_IMPORT_BASE(Shape)
+    MTS_IMPORT_TYPES()
+
+    using typename Base::ScalarIndex;
+    using typename Base::ScalarSize;
+    using FloatStorage = DynamicBuffer<Float>;
+
+    static constexpr size_t ClusterSize = MTS_CLOUD_CLUSTER_SIZE;
+    using FloatC = Packet<ScalarFloat, ClusterSize>;
+    using MaskC  = mask_t<FloatC>;
+
+    ScalarBoundingBox3f bbox() const override { return m_bbox; }
+
+    ScalarBoundingBox3f bbox(ScalarIndex index) const override {
+        return m_cluster_bbox[index];
+    }
+
+    ScalarSize primitive_count() const override { return m_cluster_count; }
+
+    ScalarFloat surface_area() const override { return m_area_distr.sum(); }
+
+    PositionSample3f sample_position(Float time, const Point2f &sample,
+                                     Mask active) const override {
+        MTS_MASK_ARGUMENT(active);
+
+        // Choose a primitive proportionally to its area and reuse the sample
+        auto [slot, sample_x] = m_area_distr.sample_reuse(sample.x(), active);
+
+        PositionSample3f ps =
+            derived().sample_slot(slot, Point2f(sample_x, sample.y()), active);
+        ps.time  = time;
+        ps.delta = false;
+        ps.pdf   = m_inv_surface_area;
+
+        return ps;
+    }
+
+    Float pdf_position(const PositionSample3f & /*ps*/, Mask active) const override {
+        MTS_MASK_ARGUMENT(active);
+        return m_inv_surface_area;
+    }
+
+    PreliminaryIntersection3f ray_intersect_primitive(ScalarIndex cluster,
+                                                      const Ray3f &ray,
+                                                      Mask active) const override {
+        MTS_MASK_ARGUMENT(active);
+        return intersect_cluster<false>(cluster, ray, active);
+    }
+
+    Mask ray_test_primitive(ScalarIndex cluster, const Ray3f &ray,
+                            Mask active) const override {
+        MTS_MASK_ARGUMENT(active);
+        return intersect_cluster<true>(cluster, ray, active).is_valid();
+    }
+
+    PreliminaryIntersection3f ray_intersect_preliminary(const Ray3f &ray_,
+                                                        Mask active) const override {
+        MTS_MASK_ARGUMENT(active);
+
+        // Brute force traversal, only used when the shape is not part of a scene
+        Ray3f ray(ray_);
+        PreliminaryIntersection3f pi = zero<PreliminaryIntersection3f>();
+        pi.t = math::Infinity<Float>;
+
+        for (ScalarIndex i = 0; i < m_cluster_count; ++i) {
+            PreliminaryIntersection3f pi_c = intersect_cluster<false>(i, ray, active);
+            Mask hit = pi_c.is_valid();
+            masked(pi, hit) = pi_c;
+            masked(ray.maxt, hit) = pi_c.t;
+        }
+
+        return pi;
+    }
+
+    Mask ray_test(const Ray3f &ray, Mask active) const override {
+        MTS_MASK_ARGUMENT(active);
+
+        Mask hit = false;
+        for (ScalarIndex i = 0; i < m_cluster_count && any(active && !hit); ++i)
+            hit |= intersect_cluster<true>(i, ray, active && !hit).is_valid();
+
+        return hit;
+    }
+
+protected:
+    PrimitiveCloud(const Properties &props) : Base(props) { }
+
+    /**
+     * \brief Sort the primitives along a Morton curve and group them into
+     * clusters, then build the bounding boxes and the area distribution
+     *
+     * \return The permutation that maps each slot of the cluster storage to
+     *     the index of its primitive
+     */
+    std::vector<uint32_t> build_clusters(const std::vector<ScalarPoint3f> &centers,
+                                         const std::vector<ScalarBoundingBox3f> &bboxes,
+                                         const std::vector<ScalarFloat> &areas) {
+        m_primitive_count = (ScalarSize) centers.size();
+        for (const ScalarBoundingBox3f &bbox : bboxes)
+            m_bbox.expand(bbox);
+
+        std::vector<uint32_t> order = morton_order(centers, m_bbox);
+
+        m_cluster_count = (ScalarSize) ((m_primitive_count + ClusterSize - 1) / ClusterSize);
+        m_cluster_bbox.resize(m_cluster_count);
+
+        std::vector<ScalarFloat> slot_areas(m_primitive_count);
+        for (size_t i = 0; i < m_primitive_count; ++i) {
+            m_cluster_bbox[i / ClusterSize].expand(bboxes[order[i]]);
+            slot_areas[i] = areas[order[i]];
+        }
+
+        m_area_distr = DiscreteDistribution<Float>(slot_areas.data(), m_primitive_count);
+        m_inv_surface_area = m_area_distr.normalization();
+
+        return order;
+    }
+
+    /**
+     * \brief Store a per-primitive value for every slot of the clusters
+     * (structure of arrays). Unused slots of the last cluster are padded with
+     * NaNs, which never produce an intersection.
+     */
+    template <typename Func>
+    FloatStorage cluster_storage(const std::vector<uint32_t> &order, Func value) const {
+        std::vector<ScalarFloat> data(m_cluster_count * ClusterSize,
+                                      math::NaN<ScalarFloat>);
+        for (size_t i = 0; i < m_primitive_count; ++i)
+            data[i] = value(order[i]);
+        return FloatStorage::copy(data.data(), data.size());
+    }
+
+    /**
+     * \brief Intersect a ray against all primitives of a cluster
+     *
+     * In scalar variants, the ray is tested against the whole cluster at once
+     * using a SIMD packet holding its primitives. In packet variants, the
+     * primitives are visited one at a time, each test being vectorized over
+     * the rays of the packet.
+     */
+    template <bool ShadowRay>
+    MTS_INLINE PreliminaryIntersection3f intersect_cluster(ScalarIndex cluster,
+                                                           const Ray3f &ray,
+                                                           Mask active) const {
+        size_t offset = (size_t) cluster * ClusterSize;
+
+        PreliminaryIntersection3f pi = zero<PreliminaryIntersection3f>();
+        pi.t = math::Infinity<Float>;
+        pi.shape = this;
+
+        if constexpr (!is_array_v<Float>) {
+            if (!active)
+                return pi;
+
+            auto [t, hit] = derived().intersect_lanes(offset, ray);
+            if (none(hit))
+                return pi;
+
+            t = select(hit, t, math::Infinity<ScalarFloat>);
+            ScalarFloat t_min = hmin(t);
+
+            size_t lane = 0;
+            while (t[lane] != t_min)
+                ++lane;
+
+            pi.t = t_min;
+            pi.prim_index = (uint32_t) (offset + lane);
+        } else {
+            Float maxt = ray.maxt;
+
+            // Padding only occurs at the end of the last cluster
+            size_t end = std::min(offset + ClusterSize, (size_t) m_primitive_count);
+            for (size_t slot = offset; slot < end; ++slot) {
+                auto [t, hit] = derived().intersect_slot(slot, ray, maxt);
+                hit &= active;
+
+                masked(pi.t, hit) = t;
+                masked(pi.prim_index, hit) = (uint32_t) slot;
+                masked(maxt, hit) = t;
+
+                if constexpr (ShadowRay) {
+                    active &= !hit;
+                    if (none(active))
+                        break;
+                }
+            }
+        }
+
+        return pi;
+    }
+
+    const Derived &derived() const { return static_cast<const Derived &>(*this); }
+
+protected:
+    ScalarBoundingBox3f m_bbox;
+    std::vector<ScalarBoundingBox3f> m_cluster_bbox;
+    ScalarSize m_primitive_count;
+    ScalarSize m_cluster_count;
+
+    DiscreteDistribution<Float> m_area_distr;
+    ScalarFloat m_inv_surface_area;
+};
+
+NAMESPACE_END(mitsuba)
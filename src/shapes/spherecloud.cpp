@@ -0,0 +1,251 @@
+#include <mitsuba/core/properties.h>
+#include <mitsuba/core/warp.h>
+#include "primitive_cloud.h"
+
+NAMESPACE_BEGIN(mitsuba)
+
+/**!
+
+.. _shape-spherecloud:
+
+Sphere cloud (:monosp:`spherecloud`)
+----------------------------------------------------
+
+.. pluginparameters::
+
+ * - filename
+   - |string|
+   - Filename of a text file describing the spheres. Each line holds the
+     center and radius of one sphere: ``x y z radius``. Lines starting with
+     ``#`` are ignored.
+ * - to_world
+   - |transform|
+   - Specifies an optional linear object-to-world transformation that is
+     applied to all spheres when the file is loaded. Note that non-uniform
+     scales are not permitted! (Default: none, i.e. object space = world space)
+
+This shape plugin describes a large collection of spheres sharing the same
+material, e.g. the leaves or particles of a scene that would otherwise be
+specified as thousands of individual :ref:`sphere <shape-sphere>` shapes.
+
+The spheres are sorted along a Morton curve and grouped into clusters of 8
+spatially coherent spheres whose centers and radii are stored in
+structure-of-arrays form. The acceleration data structure only sees the
+clusters, and all spheres of a cluster are intersected at once using SIMD
+instructions. This considerably reduces the memory footprint and the
+traversal cost compared to an equivalent set of ``sphere`` shapes.
+
+The surface parameterization of each sphere matches the one of the
+:ref:`sphere <shape-sphere>` plugin. This plugin is currently not supported
+in GPU variants.
+
+.. code-block:: xml
+
+    <shape type="spherecloud">
+        <string name="filename" value="leaves.txt"/>
+        <bsdf type="diffuse"/>
+    </shape>
+ */
+
+template <typename Float, typename Spectrum>
+class SphereCloud final : public PrimitiveCloud<Float, Spectrum, SphereCloud<Float, Spectrum>> {
+public:
+    using Base = PrimitiveCloud<Float, Spectrum, SphereCloud>;
+    ENOKI_USING_MEMBERS(Base, m_to_world, set_children, get_children_string, m_bbox,
+                        m_primitive_count, m_cluster_count, build_clusters,
+                        cluster_storage, surface_area)
+    ENOKI_USING_TYPES(Base, FloatStorage, FloatC)
+    MTS_IMPORT_TYPES()
+
+    SphereCloud(const Properties &props) : Base(props) {
+        if constexpr (is_cuda_array_v<Float>)
+            Throw("The spherecloud shape is not supported in GPU variants!");
+
+        std::vector<ScalarFloat> values =
+            read_cloud_file<ScalarFloat>(props.string("filename"), 4, "spherecloud");
+        size_t count = values.size() / 4;
+
+        // Radii are scaled by the (uniform) scale factor of the transformation
+        ScalarFloat scale = norm(m_to_world * ScalarVector3f(1.f, 0.f, 0.f));
+
+        std::vector<ScalarPoint3f> centers(count);
+        std::vector<ScalarFloat> radii(count), areas(count);
+        std::vector<ScalarBoundingBox3f> bboxes(count);
+        for (size_t i = 0; i < count; ++i) {
+            centers[i] = m_to_world * ScalarPoint3f(values[4 * i + 0],
+                                                    values[4 * i + 1],
+                                                    values[4 * i + 2]);
+            radii[i] = values[4 * i + 3] * scale;
+            if (!(radii[i] > 0.f))
+                Throw("spherecloud: sphere %i has an invalid radius (%f)", i, radii[i]);
+            bboxes[i] = ScalarBoundingBox3f(centers[i] - radii[i], centers[i] + radii[i]);
+            areas[i] = 4.f * math::Pi<ScalarFloat> * sqr(radii[i]);
+        }
+
+        std::vector<uint32_t> order = build_clusters(centers, bboxes, areas);
+        m_center_x = cluster_storage(order, [&](uint32_t j) { return centers[j].x(); });
+        m_center_y = cluster_storage(order, [&](uint32_t j) { return centers[j].y(); });
+        m_center_z = cluster_storage(order, [&](uint32_t j) { return centers[j].z(); });
+        m_radius   = cluster_storage(order, [&](uint32_t j) { return radii[j]; });
+
+        set_children();
+    }
+
+    // =============================================================
+    //! @{ \name Ray tracing routines
+    // =============================================================
+
+    SurfaceInteraction3f compute_surface_interaction(const Ray3f &ray,
+                                                     PreliminaryIntersection3f pi,
+                                                     HitComputeFlags flags,
+                                                     Mask active) const override {
+        MTS_MASK_ARGUMENT(active);
+
+        active &= pi.is_valid();
+
+        UInt32 index = pi.prim_index;
+        Point3f c = center(index, active);
+        Float r = radius(index, active);
+
+        SurfaceInteraction3f si = zero<SurfaceInteraction3f>();
+        si.t = select(active, pi.t, math::Infinity<Float>);
+
+        Vector3f local = normalize(ray(pi.t) - c);
+        si.sh_frame.n = local;
+
+        // Re-project onto the sphere to improve accuracy
+        si.p = fmadd(local, r, c);
+
+        if (likely(has_flag(flags, HitComputeFlags::UV))) {
+            Float rd_2  = sqr(local.x()) + sqr(local.y()),
+                  theta = unit_angle_z(local),
+                  phi   = atan2(local.y(), local.x());
+
+            masked(phi, phi < 0.f) += 2.f * math::Pi<Float>;
+
+            si.uv = Point2f(phi * math::InvTwoPi<Float>, theta * math::InvPi<Float>);
+            if (likely(has_flag(flags, HitComputeFlags::dPdUV))) {
+                si.dp_du = Vector3f(-local.y(), local.x(), 0.f);
+
+                Float rd      = sqrt(rd_2),
+                      inv_rd  = rcp(rd),
+                      cos_phi = local.x() * inv_rd,
+                      sin_phi = local.y() * inv_rd;
+
+                si.dp_dv = Vector3f(local.z() * cos_phi,
+                                    local.z() * sin_phi,
+                                    -rd);
+
+                Mask singularity_mask = active && eq(rd, 0.f);
+                if (unlikely(any(singularity_mask)))
+                    si.dp_dv[singularity_mask] = Vector3f(1.f, 0.f, 0.f);
+
+                si.dp_du *= r * (2.f * math::Pi<Float>);
+                si.dp_dv *= r * math::Pi<Float>;
+            }
+        }
+
+        si.n = si.sh_frame.n;
+
+        if (has_flag(flags, HitComputeFlags::dNSdUV)) {
+            Float inv_radius = rcp(r);
+            si.dn_du = si.dp_du * inv_radius;
+            si.dn_dv = si.dp_dv * inv_radius;
+        }
+
+        return si;
+    }
+
+    //! @}
+    // =============================================================
+
+    std::string to_string() const override {
+        std::ostringstream oss;
+        oss << "SphereCloud[" << std::endl
+            << "  sphere_count = " << m_primitive_count << "," << std::endl
+            << "  cluster_count = " << m_cluster_count << "," << std::endl
+            << "  bbox = " << string::indent(m_bbox) << "," << std::endl
+            << "  surface_area = " << surface_area() << "," << std::endl
+            << "  " << string::indent(get_children_string()) << std::endl
+            << "]";
+        return oss.str();
+    }
+
+    MTS_DECLARE_CLASS()
+private:
+    friend Base;
+
+    MTS_INLINE Point3f center(const UInt32 &index, const Mask &active) const {
+        return Point3f(gather<Float>(m_center_x, index, active),
+                       gather<Float>(m_center_y, index, active),
+                       gather<Float>(m_center_z, index, active));
+    }
+
+    MTS_INLINE Float radius(const UInt32 &index, const Mask &active) const {
+        return gather<Float>(m_radius, index, active);
+    }
+
+    PositionSample3f sample_slot(const UInt32 &slot, const Point2f &sample,
+                                 Mask active) const {
+        Point3f local = warp::square_to_uniform_sphere(sample);
+
+        PositionSample3f ps;
+        ps.p = fmadd(local, radius(slot, active), center(slot, active));
+        ps.n = local;
+        return ps;
+    }
+
+    /* The intersection routines use the numerically robust formulation of
+       the quadratic that goes through the point of the ray that is closest
+       to the sphere's center, which avoids cancellation for small spheres far
+       away from the ray origin. */
+
+    MTS_INLINE std::pair<FloatC, mask_t<FloatC>> intersect_lanes(size_t offset,
+                                                                 const Ray3f &ray) const {
+        FloatC ox = ray.o.x() - load_unaligned<FloatC>(m_center_x.data() + offset),
+               oy = ray.o.y() - load_unaligned<FloatC>(m_center_y.data() + offset),
+               oz = ray.o.z() - load_unaligned<FloatC>(m_center_z.data() + offset),
+               r  = load_unaligned<FloatC>(m_radius.data() + offset);
+
+        ScalarFloat inv_a = rcp(squared_norm(ray.d));
+
+        FloatC t_mid = -(ox * ray.d.x() + oy * ray.d.y() + oz * ray.d.z()) * inv_a,
+               fx    = fmadd(ray.d.x(), t_mid, ox),
+               fy    = fmadd(ray.d.y(), t_mid, oy),
+               fz    = fmadd(ray.d.z(), t_mid, oz),
+               disc  = (sqr(r) - (sqr(fx) + sqr(fy) + sqr(fz))) * inv_a,
+               half  = safe_sqrt(disc),
+               t_near = t_mid - half,
+               t_far  = t_mid + half,
+               t      = select(t_near >= ray.mint, t_near, t_far);
+
+        // NaN-aware conditionals, also discarding the padding
+        return { t, disc >= 0.f && t >= ray.mint && t <= ray.maxt };
+    }
+
+    MTS_INLINE std::pair<Float, Mask> intersect_slot(size_t slot, const Ray3f &ray,
+                                                     const Float &maxt) const {
+        ScalarFloat r = m_radius.data()[slot];
+        Vector3f o = ray.o - ScalarVector3f(m_center_x.data()[slot],
+                                            m_center_y.data()[slot],
+                                            m_center_z.data()[slot]);
+
+        Float inv_a  = rcp(squared_norm(ray.d)),
+              t_mid  = -dot(o, ray.d) * inv_a,
+              disc   = (sqr(r) - squared_norm(fmadd(ray.d, t_mid, o))) * inv_a,
+              half   = safe_sqrt(disc),
+              t_near = t_mid - half,
+              t_far  = t_mid + half,
+              t      = select(t_near >= ray.mint, t_near, t_far);
+
+        return { t, disc >= 0.f && t >= ray.mint && t <= maxt };
+    }
+
+private:
+    /// Sphere centers and radii (structure of arrays, padded to full clusters)
+    FloatStorage m_center_x, m_center_y, m_center_z, m_radius;
+};
+
+MTS_IMPLEMENT_CLASS_VARIANT(SphereCloud, Shape)
+MTS_EXPORT_PLUGIN(SphereCloud, "Sphere cloud intersection primitive");
+NAMESPACE_END(mitsuba)
@@ -0,0 +1,65 @@
+import mitsuba
+import pytest
+import enoki as ek
+
+
+def write_cylinders(tmpdir, cylinders):
+    filename = str(tmpdir.join('cylinders.txt'))
+    with open(filename, 'w') as f:
+        for c in cylinders:
+            f.write(' '.join(str(v) for v in c) + '\n')
+    return filename
+
+
+def test01_create(variant_scalar_rgb, tmpdir):
+    from mitsuba.core import xml
+
+    cylinders = [(2.0 * i, 0, 0, 2.0 * i, 0, 3, 0.5) for i in range(9)]
+    s = xml.load_dict({
+        "type" : "cylindercloud",
+        "filename" : write_cylinders(tmpdir, cylinders)
+    })
+    assert s is not None
+    assert s.primitive_count() == 2
+    assert ek.allclose(s.surface_area(), 9 * 2 * ek.pi * 0.5 * 3)
+
+    b = s.bbox()
+    assert ek.allclose(b.min, [-0.5, -0.5, 0])
+    assert ek.allclose(b.max, [16.5, 0.5, 3])
+
+
+def test02_ray_intersect(variant_scalar_rgb, tmpdir):
+    from mitsuba.core import xml, Ray3f
+    from mitsuba.render import HitComputeFlags
+
+    cylinders = [(2.0 * i, 0, 0, 2.0 * i, 0, 1 + i, 0.5) for i in range(10)]
+    scene = xml.load_dict({
+        "type" : "scene",
+        "foo" : {
+            "type" : "cylindercloud",
+            "filename" : write_cylinders(tmpdir, cylinders)
+        }
+    })
+
+    for (x, _, _, _, _, l, r) in cylinders:
+        ray = Ray3f(o=[x, -10, 0.5 * l], d=[0, 1, 0], time=0.0, wavelengths=[])
+        assert scene.ray_test(ray)
+
+        si = scene.ray_intersect(ray, HitComputeFlags.All | HitComputeFlags.dNSdUV)
+        assert si.is_valid()
+        assert ek.allclose(si.t, 10 - r)
+        assert ek.allclose(si.p, [x, -r, 0.5 * l])
+        assert ek.allclose(si.n, [0, -1, 0])
+        assert ek.allclose(si.uv[1], 0.5)
+        assert ek.allclose(si.dp_dv, [0, 0, l])
+
+        # Ray passing above the open end of the cylinder
+        ray = Ray3f(o=[x, -10, l + 0.1], d=[0, 1, 0], time=0.0, wavelengths=[])
+        assert not scene.ray_test(ray)
+
+        # Ray entering through the open end hits the inside
+        ray = Ray3f(o=[x, 0, l + 0.5], d=[0, r, -1], time=0.0, wavelengths=[])
+        si = scene.ray_intersect(ray)
+        assert si.is_valid()
+        assert ek.allclose(ek.sqrt((si.p[0] - x)**2 + si.p[1]**2), r)
+        assert ek.allclose(si.p[2], l - 0.5)
@@ -0,0 +1,74 @@
+import mitsuba
+import pytest
+import enoki as ek
+import struct
+
+
+def write_leaves(tmpdir, leaves, attributes=None):
+    """Write a leaf cloud file. Each leaf is (cx, cy, cz, nx, ny, nz, radius)"""
+    filename = str(tmpdir.join('canopy.leaves'))
+    with open(filename, 'wb') as f:
+        flags = 1 if attributes is not None else 0
+        f.write(b'LEAF' + struct.pack('<IIQ', 1, flags, len(leaves)))
+        for k in range(7):
+            f.write(struct.pack('<%if' % len(leaves), *[l[k] for l in leaves]))
+        if attributes is not None:
+            f.write(struct.pack('<%iI' % len(leaves), *attributes))
+    return filename
+
+
+def test01_create(variant_scalar_rgb, tmpdir):
+    from mitsuba.core import xml
+
+    leaves = [(2.0 * i, 0, 0, 0, 0, 1, 0.5) for i in range(9)]
+    s = xml.load_dict({
+        "type" : "leafcloud",
+        "filename" : write_leaves(tmpdir, leaves)
+    })
+    assert s is not None
+    assert s.primitive_count() == 2
+    assert ek.allclose(s.surface_area(), 9 * ek.pi * 0.25)
+
+    b = s.bbox()
+    assert ek.allclose(b.min, [-0.5, -0.5, 0])
+    assert ek.allclose(b.max, [16.5, 0.5, 0])
+
+    # Truncated file
+    filename = write_leaves(tmpdir, leaves)
+    with open(filename, 'r+b') as f:
+        f.truncate(40)
+    with pytest.raises(RuntimeError):
+        xml.load_dict({"type" : "leafcloud", "filename" : filename})
+
+
+def test02_ray_intersect(variant_scalar_rgb, tmpdir):
+    from mitsuba.core import xml, Ray3f
+
+    # Leaves tilted by 45 degrees around the y axis
+    n = [ek.sqrt(0.5), 0, ek.sqrt(0.5)]
+    leaves = [(2.0 * i, i % 3, 0, *n, 0.25 + 0.05 * i) for i in range(20)]
+    scene = xml.load_dict({
+        "type" : "scene",
+        "foo" : {
+            "type" : "leafcloud",
+            "filename" : write_leaves(tmpdir, leaves, list(range(20)))
+        }
+    })
+
+    attribute = xml.load_dict({"type" : "mesh_attribute", "name" : "face_attribute"})
+
+    for i, (x, y, z, _, _, _, r) in enumerate(leaves):
+        ray = Ray3f(o=[x, y, 10], d=[0, 0, -1], time=0.0, wavelengths=[])
+        assert scene.ray_test(ray)
+
+        si = scene.ray_intersect(ray)
+        assert si.is_valid()
+        assert ek.allclose(si.t, 10)
+        assert ek.allclose(si.n, n)
+        assert ek.allclose(si.uv[0], 0)
+        assert ek.allclose(attribute.eval_1(si), i)
+
+        # The leaf covers [x - r / sqrt(2), x + r / sqrt(2)] along the x axis
+        for dx, hit in [(0.69, True), (0.72, False)]:
+            ray = Ray3f(o=[x + dx * r, y, 10], d=[0, 0, -1], time=0.0, wavelengths=[])
+            assert scene.ray_test(ray) == hit
@@ -0,0 +1,89 @@
+import mitsuba
+import pytest
+import enoki as ek
+
+
+def write_spheres(tmpdir, spheres):
+    filename = str(tmpdir.join('spheres.txt'))
+    with open(filename, 'w') as f:
+        f.write('# x y z radius\n')
+        for s in spheres:
+            f.write(' '.join(str(v) for v in s) + '\n')
+    return filename
+
+
+def test01_create(variant_scalar_rgb, tmpdir):
+    from mitsuba.core import xml
+
+    # 10 spheres are grouped into 2 clusters
+    spheres = [(2.0 * i, 0, 0, 0.5) for i in range(10)]
+    s = xml.load_dict({
+        "type" : "spherecloud",
+        "filename" : write_spheres(tmpdir, spheres)
+    })
+    assert s is not None
+    assert s.primitive_count() == 2
+    assert ek.allclose(s.surface_area(), 10 * 4 * ek.pi * 0.25)
+
+    b = s.bbox()
+    assert ek.allclose(b.min, [-0.5, -0.5, -0.5])
+    assert ek.allclose(b.max, [18.5, 0.5, 0.5])
+
+    with pytest.raises(RuntimeError):
+        xml.load_dict({
+            "type" : "spherecloud",
+            "filename" : write_spheres(tmpdir, [(0, 0, 0)])
+        })
+
+
+def test02_ray_intersect(variant_scalar_rgb, tmpdir):
+    from mitsuba.core import xml, Ray3f
+    from mitsuba.render import HitComputeFlags
+
+    spheres = [(2.0 * i, 3.0 * (i % 3), 0, 0.25 + 0.05 * i) for i in range(20)]
+    scene = xml.load_dict({
+        "type" : "scene",
+        "foo" : {
+            "type" : "spherecloud",
+            "filename" : write_spheres(tmpdir, spheres)
+        }
+    })
+
+    for (x, y, z, r) in spheres:
+        # Ray aimed at the top of each sphere
+        ray = Ray3f(o=[x, y, 10], d=[0, 0, -1], time=0.0, wavelengths=[])
+        assert scene.ray_test(ray)
+
+        si = scene.ray_intersect(ray, HitComputeFlags.All | HitComputeFlags.dNSdUV)
+        assert si.is_valid()
+        assert ek.allclose(si.t, 10 - r)
+        assert ek.allclose(si.p, [x, y, r])
+        assert ek.allclose(si.n, [0, 0, 1])
+        assert ek.allclose(si.uv[1], 0.0)
+
+        # Ray passing next to the sphere
+        ray = Ray3f(o=[x + 1.01 * r, y, 10], d=[0, 0, -1], time=0.0, wavelengths=[])
+        assert not scene.ray_test(ray)
+        assert not scene.ray_intersect(ray).is_valid()
+
+    # Closest of several spheres along the ray
+    ray = Ray3f(o=[-10, 0, 0], d=[1, 0, 0], time=0.0, wavelengths=[])
+    si = scene.ray_intersect(ray)
+    assert ek.allclose(si.t, 10 - 0.25)
+
+
+def test03_sample_position(variant_scalar_rgb, tmpdir):
+    from mitsuba.core import xml
+
+    spheres = [(0, 0, 0, 1), (5, 0, 0, 2)]
+    s = xml.load_dict({
+        "type" : "spherecloud",
+        "filename" : write_spheres(tmpdir, spheres)
+    })
+
+    for u in [0.1, 0.5, 0.9]:
+        ps = s.sample_position(0, [u, 0.3])
+        c, r = ([0, 0, 0], 1) if ek.norm(ps.p) < 1.5 else ([5, 0, 0], 2)
+        assert ek.allclose(ek.norm(ps.p - c), r)
+        assert ek.allclose(ps.n, (ps.p - c) / r)
+        assert ek.allclose(ps.pdf, 1 / s.surface_area())
@@ -15,18 +15,18 @@ Discrete spectrum (:monosp:`discrete`)
 .. pluginparameters::
 
  * - wavelengths
-   - |string|
-   - A comma-separated list of wavelengths to sample.
+   - |floats|
+   - A list of wavelengths to sample.
 
  * - values
-   - |string|
-   - A comma-separated list of spectrum values associated with each wavelength. 
+   - |floats|
+   - A list of spectrum values associated with each wavelength. 
      Alternatively, a single value can be passed and used for all wavelengths.
      (Default: "1")
 
  * - pmf
-   - |string|
-   - A comma-separated list of probability mass density associated with each
+   - |floats|
+   - A list of probability mass density associated with each
      wavelength. If unspecified, all wavelengths are equiprobable.
 
 *This spectrum can only be used through its full XML specification.*
@@ -46,53 +46,37 @@ private:
 public:
     DiscreteSpectrum(const Properties &props) : Texture(props) {
         // Wavelengths are required
-        std::vector<std::string> wavelengths_str =
-            string::tokenize(props.string("wavelengths"), " ,");
+        FloatArray wavelengths = props.float_array("wavelengths");
 
         // Values are optional
-        std::vector<std::string> values_str =
-            string::tokenize(props.string("values", "1"), " ,");
+        FloatArray values =
+            props.float_array("values", FloatArray(std::vector<double>{ 1.0 }));
 
-        // If a single value is provided, use it for every wavelength
-        if (values_str.size() == 1)
-            for (size_t i = 1; i < wavelengths_str.size(); ++i)
-                values_str.push_back(values_str[0]);
-
-        // Check value vector size
-        if (wavelengths_str.size() != values_str.size())
+        // Check value vector size (a single value is used for every wavelength)
+        if (values.size() != 1 && wavelengths.size() != values.size())
             Throw("DiscreteSpectrum: 'wavelengths' and 'values' parameters "
                   "must have the same size!");
 
         // PMF values are optional
-        std::vector<std::string> pmf_str =
-            string::tokenize(props.string("pmf", "1"), " ,");
-
-        // If a single PMF value is provided, use it for every wavelength
-        if (pmf_str.size() == 1)
-            for (size_t i = 1; i < wavelengths_str.size(); ++i)
-                pmf_str.push_back(pmf_str[0]);
+        FloatArray pmf_values =
+            props.float_array("pmf", FloatArray(std::vector<double>{ 1.0 }));
 
-        // Check PMF vector size
-        if (wavelengths_str.size() != pmf_str.size())
+        // Check PMF vector size (a single value is used for every wavelength)
+        if (pmf_values.size() != 1 && wavelengths.size() != pmf_values.size())
             Throw("DiscreteSpectrum: 'wavelengths' and 'pmf' parameters "
                   "must have the same size!");
 
-        m_wavelengths    = empty<FloatStorage>(wavelengths_str.size());
-        m_values         = empty<FloatStorage>(wavelengths_str.size());
-        FloatStorage pmf = empty<FloatStorage>(wavelengths_str.size());
+        m_wavelengths    = empty<FloatStorage>(wavelengths.size());
+        m_values         = empty<FloatStorage>(wavelengths.size());
+        FloatStorage pmf = empty<FloatStorage>(wavelengths.size());
         m_wavelengths.managed();
         m_values.managed();
         pmf.managed();
 
-        for (size_t i = 0; i < wavelengths_str.size(); ++i) {
-            try {
-                m_wavelengths[i] = (ScalarFloat) std::stod(wavelengths_str[i]);
-                m_values[i]      = (ScalarFloat) std::stod(values_str[i]);
-                pmf[i]           = (ScalarFloat) std::stod(pmf_str[i]);
-            } catch (...) {
-                Throw("Could not parse floating point value '%s'",
-                      wavelengths_str[i]);
-            }
+        for (size_t i = 0; i < wavelengths.size(); ++i) {
+            m_wavelengths[i] = (ScalarFloat) wavelengths[i];
+            m_values[i]      = (ScalarFloat) values[values.size() == 1 ? 0 : i];
+            pmf[i]           = (ScalarFloat) pmf_values[pmf_values.size() == 1 ? 0 : i];
         }
 
         m_distr = DiscreteDistribution<Wavelength>(pmf);
@@ -24,34 +24,18 @@ public:
 
 public:
     IrregularSpectrum(const Properties &props) : Texture(props) {
-        if (props.type("values") == Properties::Type::String) {
-            std::vector<std::string> wavelengths_str =
-                string::tokenize(props.string("wavelengths"), " ,");
-            std::vector<std::string> entry_str, values_str =
-                string::tokenize(props.string("values"), " ,");
+        if (props.type("values") != Properties::Type::Pointer) {
+            FloatArray wavelengths = props.float_array("wavelengths"),
+                       values      = props.float_array("values");
 
-            if (values_str.size() != wavelengths_str.size())
+            if (values.size() != wavelengths.size())
                 Throw("IrregularSpectrum: 'wavelengths' and 'values' parameters must have the same size!");
 
-            std::vector<ScalarFloat> values, wavelengths;
-            values.reserve(values_str.size());
-            wavelengths.reserve(values_str.size());
-
-            for (size_t i = 0; i < values_str.size(); ++i) {
-                try {
-                    wavelengths.push_back((ScalarFloat) std::stod(wavelengths_str[i]));
-                } catch (...) {
-                    Throw("Could not parse floating point value '%s'", wavelengths_str[i]);
-                }
-                try {
-                    values.push_back((ScalarFloat) std::stod(values_str[i]));
-                } catch (...) {
-                    Throw("Could not parse floating point value '%s'", values_str[i]);
-                }
-            }
+            std::vector<ScalarFloat> wavelengths_v(wavelengths.begin(), wavelengths.end()),
+                                     values_v(values.begin(), values.end());
 
             m_distr = IrregularContinuousDistribution<Wavelength>(
-                wavelengths.data(), values.data(), values.size()
+                wavelengths_v.data(), values_v.data(), values_v.size()
             );
         } else {
             size_t size = props.size_("size");
@@ -29,19 +29,9 @@ public:
             props.float_("lambda_max")
         );
 
-        if (props.type("values") == Properties::Type::String) {
-            std::vector<std::string> values_str =
-                string::tokenize(props.string("values"), " ,");
-            std::vector<ScalarFloat> data;
-            data.reserve(values_str.size());
-
-            for (const auto &s : values_str) {
-                try {
-                    data.push_back((ScalarFloat) std::stod(s));
-                } catch (...) {
-                    Throw("Could not parse floating point value '%s'", s);
-                }
-            }
+        if (props.type("values") != Properties::Type::Pointer) {
+            FloatArray values = props.float_array("values");
+            std::vector<ScalarFloat> data(values.begin(), values.end());
 
             m_distr = ContinuousDistribution<Wavelength>(
                 wavelength_range, data.data(), data.size()
@@ -45,3 +45,42 @@ def test02_sample_spectrum(variant_scalar_spectral, obj):
         obj.sample_spectrum(si, .5),
         [576.777, 212.5]
     )
+
+
+def test03_array_inputs(variant_scalar_spectral, tmpdir):
+    import os
+    import numpy as np
+    from mitsuba.core.xml import load_dict, load_file
+    from mitsuba.render import SurfaceInteraction3f
+
+    # Values and wavelengths stored as binary data (inline and in a sidecar file)
+    np.array([1, 2, .5], dtype=np.float32).tofile(os.path.join(str(tmpdir), 'values.bin'))
+    xml_file = os.path.join(str(tmpdir), 'spectrum.xml')
+    with open(xml_file, 'w') as f:
+        f.write('''
+            <spectrum version="2.0.0" type="irregular">
+                <floats name="wavelengths" base64="AAAAAABAf0AAAAAAAMCCQAAAAAAAUIRA" dtype="float64"/>
+                <floats name="values" filename="values.bin"/>
+            </spectrum>''')
+
+    objs = [
+        load_file(xml_file),
+        load_dict({
+            'type': 'irregular',
+            'wavelengths': np.array([500, 600, 650], dtype=np.float64),
+            'values': np.array([1, 2, .5], dtype=np.float32)
+        }),
+        load_dict({
+            'type': 'irregular',
+            'wavelengths': np.linspace(500, 650, 4),
+            'values': np.array([1, 2, 2, .5])
+        })
+    ]
+
+    expected = [[1, 1.5, 2, .5], [1, 1.5, 2, .5], [1, 2, 2, .5]]
+
+    si = SurfaceInteraction3f()
+    for obj, values in zip(objs, expected):
+        for i in range(4):
+            si.wavelengths = 500 + 50 * i
+            assert ek.allclose(obj.eval(si), values[i])
@@ -0,0 +1,95 @@
+import mitsuba
+import pytest
+import numpy as np
+import enoki as ek
+
+
+def write_volume(filename, data):
+    with open(filename, "wb") as f:
+        f.write(b"VOL")
+        f.write(np.uint8(3).tobytes())  # format version
+        f.write(np.int32(1).tobytes())  # type
+        f.write(np.int32(data.shape[2]).tobytes())  # size (x, y, z)
+        f.write(np.int32(data.shape[1]).tobytes())
+        f.write(np.int32(data.shape[0]).tobytes())
+        f.write(np.int32(data.shape[3]).tobytes())  # channels
+        f.write(np.array([0, 0, 0, 1, 1, 1], dtype=np.float32).tobytes())  # bbox
+        f.write(data.ravel().astype(np.float32).tobytes())
+
+
+@pytest.fixture(scope="module")
+def fields_file(tmpdir_factory):
+    # Voxels indexed as [z, y, x, channel]: extinction followed by albedo
+    data = np.zeros((2, 2, 2, 2))
+    for z in range(2):
+        for y in range(2):
+            for x in range(2):
+                data[z, y, x, 0] = 1 + x + 2 * y + 4 * z
+                data[z, y, x, 1] = 0.1 * (1 + x)
+    filename = str(tmpdir_factory.mktemp("textures").join("fields.vol"))
+    write_volume(filename, data)
+    return filename
+
+
+def test01_construct(variant_scalar_rgb, fields_file):
+    from mitsuba.core.xml import load_dict
+
+    volume = load_dict({"type": "multigridvolume", "filename": fields_file})
+    assert volume.field_count() == 2
+    assert volume.max() == 8
+
+    with pytest.raises(RuntimeError):
+        load_dict({"type": "multigridvolume", "filename": fields_file,
+                   "fields": "1, 3"})
+
+    with pytest.raises(RuntimeError):
+        load_dict({"type": "multigridvolume", "filename": fields_file,
+                   "fields": "2"})
+
+
+@pytest.mark.parametrize("filter_type", ["nearest", "trilinear"])
+def test02_eval_fields(variant_scalar_rgb, fields_file, filter_type):
+    from mitsuba.core.xml import load_dict
+    from mitsuba.render import Interaction3f
+
+    volume = load_dict({"type": "multigridvolume", "filename": fields_file,
+                        "filter_type": filter_type})
+
+    it = Interaction3f()
+    for p in [[0.25, 0.25, 0.25], [0.75, 0.25, 0.75], [0.5, 0.4, 0.6]]:
+        it.p = p
+        sigma_t, albedo = volume.eval_fields(it)
+        if filter_type == "nearest":
+            x, y, z = [int(v >= 0.5) for v in p]
+        else:
+            x, y, z = [np.clip(v * 2 - 0.5, 0, 1) for v in p]
+        assert ek.allclose(sigma_t, 1 + x + 2 * y + 4 * z)
+        assert ek.allclose(albedo, 0.1 * (1 + x))
+        assert ek.allclose(volume.eval(it), sigma_t)
+
+
+def test03_heterogeneous_medium(variant_scalar_rgb, fields_file):
+    from mitsuba.core.xml import load_dict
+    from mitsuba.render import MediumInteraction3f
+
+    fused = load_dict({
+        "type": "heterogeneous",
+        "fields": {"type": "multigridvolume", "filename": fields_file},
+        "scale": 2.0
+    })
+
+    mi = MediumInteraction3f()
+    mi.p = [0.5, 0.4, 0.6]
+    sigma_s, sigma_n, sigma_t = fused.get_scattering_coefficients(mi)
+
+    x, y, z = 0.5, 0.3, 0.7
+    assert ek.allclose(sigma_t, 2 * (1 + x + 2 * y + 4 * z))
+    assert ek.allclose(sigma_s, sigma_t * 0.1 * (1 + x))
+    assert ek.allclose(sigma_n, 16 - sigma_t)
+
+    with pytest.raises(RuntimeError):
+        load_dict({
+            "type": "heterogeneous",
+            "fields": {"type": "multigridvolume", "filename": fields_file},
+            "sigma_t": 1.0
+        })